@@ -0,0 +1,43 @@
+#!/bin/bash
+# Compares accuracy and throughput of double and single precision (LPMP_SINGLE_PRECISION) message passing.
+# Builds both configurations in Release mode, runs srmp_uai on MRF instances (*.uai) and multicut_cycle_text_input on multicut instances (all other files)
+# for a fixed number of iterations and reports the final lower bound and the fastest of several runs.
+#
+# usage: compare_precision.sh instance... 
+# environment: MAX_ITER (default 1000), REPETITIONS (default 3), BUILD_DIR (default ./_precision_build)
+
+set -e
+
+SOURCE_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+BUILD_DIR="${BUILD_DIR:-$PWD/_precision_build}"
+MAX_ITER="${MAX_ITER:-1000}"
+REPETITIONS="${REPETITIONS:-3}"
+
+if [ "$#" -eq 0 ]; then
+    echo "usage: $0 instance..." >&2
+    exit 1
+fi
+
+for precision in double single; do
+    if [ "$precision" = single ]; then single=ON; else single=OFF; fi
+    cmake -S "$SOURCE_DIR" -B "$BUILD_DIR/$precision" -DCMAKE_BUILD_TYPE=Release -DLPMP_SINGLE_PRECISION=$single > /dev/null
+    cmake --build "$BUILD_DIR/$precision" -j"$(nproc)" --target srmp_uai multicut_cycle_text_input > /dev/null
+done
+
+printf "%-40s %-8s %-24s %s\n" "instance" "REAL" "final lower bound" "fastest run [ms]"
+for instance in "$@"; do
+    case "$instance" in
+        *.uai) solver=src/mrf/srmp_uai ;;
+        *) solver=src/multicut/multicut_cycle_text_input ;;
+    esac
+    for precision in double single; do
+        best_time=""
+        for ((r=0; r<REPETITIONS; ++r)); do
+            output="$("$BUILD_DIR/$precision/$solver" -i "$instance" --maxIter "$MAX_ITER")"
+            lower_bound="$(echo "$output" | sed -n 's/^final lower bound = \([^,]*\),.*/\1/p')"
+            time="$(echo "$output" | sed -n 's/^Optimization took \([0-9]*\) milliseconds.*/\1/p')"
+            if [ -z "$best_time" ] || [ "$time" -lt "$best_time" ]; then best_time="$time"; fi
+        done
+        printf "%-40s %-8s %-24s %s\n" "$(basename "$instance")" "$precision" "$lower_bound" "$best_time"
+    done
+done
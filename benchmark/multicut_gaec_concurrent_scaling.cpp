@@ -0,0 +1,48 @@
+#include "multicut/multicut_instance.h"
+#include "multicut/multicut_greedy_additive_edge_contraction_parallel.h"
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace LPMP;
+
+// Scaling of concurrent greedy additive edge contraction with 1 to 64 threads on a random grid.
+// usage: benchmark_multicut_gaec_concurrent_scaling [grid dimension = 2000] [repetitions = 5]
+// For each thread count the minimum and median runtime over all repetitions are reported.
+int main(int argc, char** argv)
+{
+    const std::size_t dim = argc > 1 ? std::stoul(argv[1]) : 2000;
+    const std::size_t nr_repetitions = argc > 2 ? std::stoul(argv[2]) : 5;
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<> dist(-1.0, 1.0);
+    multicut_instance instance;
+    for(std::size_t x=0; x<dim; ++x) {
+        for(std::size_t y=0; y<dim; ++y) {
+            if(x+1 < dim) { instance.add_edge(x*dim+y, (x+1)*dim+y, dist(gen)); }
+            if(y+1 < dim) { instance.add_edge(x*dim+y, x*dim+y+1, dist(gen)); }
+        }
+    }
+
+    std::cout << "threads\tmin [ms]\tmedian [ms]\tspeedup (min)\tenergy\n";
+    double single_thread_time = 0.0;
+    for(int nr_threads=1; nr_threads<=64; nr_threads*=2) {
+        std::vector<double> times;
+        double energy = 0.0;
+        for(std::size_t r=0; r<nr_repetitions; ++r) {
+            const auto begin_time = std::chrono::steady_clock::now();
+            const multicut_edge_labeling sol = greedy_additive_edge_contraction_parallel(instance, nr_threads, "concurrent");
+            const auto end_time = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::milli>(end_time - begin_time).count());
+            energy = instance.evaluate(sol);
+        }
+        std::sort(times.begin(), times.end());
+        if(nr_threads == 1)
+            single_thread_time = times.front();
+
+        std::cout << nr_threads << "\t" << times.front() << "\t" << times[times.size()/2] << "\t" << single_thread_time / times.front() << "\t" << energy << "\n";
+    }
+}
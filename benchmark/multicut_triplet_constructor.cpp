@@ -0,0 +1,58 @@
+#include "multicut/multicut.h"
+#include "visitors/standard_visitor.hxx"
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace LPMP;
+
+// Insertion and lookup of edge and triplet factors in the multicut constructor for many random triplets.
+// usage: benchmark_multicut_triplet_constructor [number of triplets = 5000000]
+int main(int argc, char** argv)
+{
+#ifndef NDEBUG
+    std::cout << "warning: debug build, timings include consistency checks\n";
+#endif
+    const std::size_t no_triplets = argc > 1 ? std::stoul(argv[1]) : 5000000;
+    const std::size_t no_nodes = std::max(std::size_t(100), no_triplets/10);
+
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> node_dist(0, no_nodes-1);
+    std::vector<std::array<std::size_t,3>> triplets;
+    triplets.reserve(no_triplets);
+    while(triplets.size() < no_triplets) {
+        std::array<std::size_t,3> t{node_dist(gen), node_dist(gen), node_dist(gen)};
+        std::sort(t.begin(), t.end());
+        if(t[0] != t[1] && t[1] != t[2]) {
+            triplets.push_back(t);
+        }
+    }
+    std::sort(triplets.begin(), triplets.end());
+    triplets.erase(std::unique(triplets.begin(), triplets.end()), triplets.end());
+    std::shuffle(triplets.begin(), triplets.end(), gen);
+
+    Solver<LP<FMC_MULTICUT>,StandardVisitor> s;
+    auto& mc = s.GetProblemConstructor();
+    mc.reserve_triplet_factors(triplets.size());
+
+    const auto begin_time = std::chrono::steady_clock::now();
+    for(const auto& t : triplets) {
+        if(mc.find_triplet_factor(t[0], t[1], t[2]) == nullptr) {
+            mc.add_triplet_factor(t[0], t[1], t[2]);
+        }
+    }
+    const auto insertion_end_time = std::chrono::steady_clock::now();
+
+    std::size_t no_found = 0;
+    for(const auto& t : triplets) {
+        no_found += mc.find_triplet_factor(t[0], t[1], t[2]) != nullptr;
+    }
+    const auto lookup_end_time = std::chrono::steady_clock::now();
+
+    std::cout << "added " << mc.number_of_triplets() << " triplets and " << mc.number_of_edges() << " edges in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(insertion_end_time - begin_time).count() << " ms, looked up " << no_found << " triplets in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(lookup_end_time - insertion_end_time).count() << " ms\n";
+}
@@ -0,0 +1,78 @@
+#include "mrf/pairwise_simplex_factor.h"
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <iostream>
+
+using namespace LPMP;
+
+// times SIMD min-marginals and lower bound of the pairwise simplex factor against a straightforward scalar computation for varying label counts.
+// Each configuration is run repeatedly, the minimum and median time per call are reported.
+
+template<typename FUNC>
+std::vector<double> time_repeated(FUNC&& f, const std::size_t nr_repetitions)
+{
+   std::vector<double> times;
+   times.reserve(nr_repetitions);
+   for(std::size_t r=0; r<nr_repetitions; ++r) {
+      const auto begin = std::chrono::steady_clock::now();
+      f();
+      const auto end = std::chrono::steady_clock::now();
+      times.push_back(std::chrono::duration<double, std::nano>(end - begin).count());
+   }
+   std::sort(times.begin(), times.end());
+   return times;
+}
+
+int main()
+{
+#ifndef NDEBUG
+   std::cout << "warning: debug build, timings include consistency checks\n";
+#endif
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<> dist(-1.0, 1.0);
+   const std::size_t nr_repetitions = 1000;
+
+   std::cout << "labels\tscalar min [ns]\tscalar median [ns]\tsimd min [ns]\tsimd median [ns]\n";
+   for(const std::size_t dim : {16, 17, 32, 63, 64, 128, 256}) {
+      PairwiseSimplexFactor f(dim, dim);
+      for(std::size_t x1=0; x1<f.dim1(); ++x1) {
+         f.msg1(x1) = dist(gen);
+         f.msg2(x1) = dist(gen);
+         for(std::size_t x2=0; x2<f.dim2(); ++x2) {
+            f.cost(x1,x2) = dist(gen);
+         }
+      }
+
+      double checksum = 0.0;
+      std::vector<double> min_marg_1(f.dim1());
+      std::vector<double> min_marg_2(f.dim2());
+      const auto scalar_times = time_repeated([&]() {
+            std::fill(min_marg_1.begin(), min_marg_1.end(), std::numeric_limits<double>::infinity());
+            std::fill(min_marg_2.begin(), min_marg_2.end(), std::numeric_limits<double>::infinity());
+            double lb = std::numeric_limits<double>::infinity();
+            for(std::size_t x1=0; x1<f.dim1(); ++x1) {
+               for(std::size_t x2=0; x2<f.dim2(); ++x2) {
+                  const double val = f(x1,x2);
+                  min_marg_1[x1] = std::min(min_marg_1[x1], val);
+                  min_marg_2[x2] = std::min(min_marg_2[x2], val);
+                  lb = std::min(lb, val);
+               }
+            }
+            checksum += lb + min_marg_1[0] + min_marg_2[0];
+      }, nr_repetitions);
+
+      const auto simd_times = time_repeated([&]() {
+            const auto simd_min_marg_1 = f.min_marginal_1();
+            const auto simd_min_marg_2 = f.min_marginal_2();
+            checksum += f.LowerBound() + simd_min_marg_1[0] + simd_min_marg_2[0];
+      }, nr_repetitions);
+
+      std::cout << dim << "x" << dim << "\t"
+         << scalar_times.front() << "\t" << scalar_times[nr_repetitions/2] << "\t"
+         << simd_times.front() << "\t" << simd_times[nr_repetitions/2]
+         << "\t(checksum " << checksum << ")\n";
+   }
+}
@@ -5,6 +5,8 @@
 #include "messages_storage.hxx"
 #include "message_passing_schedule.hxx"
 #include "message_passing_weight_computation.hxx"
+#include "parallel_message_passing_schedule.hxx"
+#include "compensated_sum.hxx"
 #include "lp_reparametrization.hxx"
 #include "factor_container_interface.h"
 #include <vector>
@@ -65,6 +67,10 @@ public:
    double LowerBound() const;
    void init_primal();
    double EvaluatePrimal() const;
+   // sum of func(i) over all factor indices i plus constant, computed in parallel.
+   // Factors are split into fixed blocks whose compensated partial sums are combined by a pairwise tree reduction, hence the result does not depend on the number of threads.
+   template<typename FUNC>
+   double reduce_over_factors(FUNC&& func) const;
 
    bool CheckPrimalConsistency() const;
 
@@ -86,6 +92,24 @@ public:
    template<typename FACTOR_ITERATOR, typename OMEGA_ITERATOR, typename RECEIVE_MASK_ITERATOR>
    void ComputePass(FACTOR_ITERATOR factorIt, const FACTOR_ITERATOR factorItEnd, OMEGA_ITERATOR omegaIt, RECEIVE_MASK_ITERATOR receive_it);
 
+   // same as above, but factors within one level of the update ordering are updated concurrently
+   template<typename FACTOR_ITERATOR, typename OMEGA_ITERATOR, typename RECEIVE_MASK_ITERATOR>
+   void ComputePass(const two_dim_variable_array<std::size_t>& levels, FACTOR_ITERATOR factorIt, OMEGA_ITERATOR omegaIt, RECEIVE_MASK_ITERATOR receive_it);
+
+   std::size_t get_number_of_threads() const { return num_lp_threads_arg_.getValue(); }
+
+   // with incrementalLowerBound, LowerBound() only reevaluates factors changed since the last evaluation.
+   // Message passing routines mark updated factors automatically; whoever modifies factors otherwise must call mark_dirty or mark_all_dirty.
+   bool incremental_lower_bound() const { return incremental_lower_bound_arg_.getValue(); }
+   void mark_dirty(const FactorTypeAdapter* f);
+   void mark_all_dirty() { std::fill(factor_dirty_.begin(), factor_dirty_.end(), 1); }
+   // mark factor and all factors whose potentials its update changes
+   void mark_updated(const FactorTypeAdapter* f);
+
+   // same as above, but runs of same-typed factors are updated without virtual dispatch. Used for FMCs with batched_factor_update
+   template<typename FACTOR_ITERATOR, typename OMEGA_ITERATOR, typename RECEIVE_MASK_ITERATOR>
+   void ComputePass(const std::vector<typename factors_storage<FMC_TYPE>::factor_type_run>& runs, FACTOR_ITERATOR factorIt, OMEGA_ITERATOR omegaIt, RECEIVE_MASK_ITERATOR receive_it);
+
    struct message_passing_weight_storage 
    {
       //message_passing_weight_storage(std::initializer_list<> l) {assert(false);} // TODO: fill out
@@ -95,25 +119,56 @@ public:
 
    message_passing_weight_storage& get_message_passing_weight(const lp_reparametrization repam);
 
-   double get_constant() const { return constant_; }
-
-   void add_to_constant(const REAL x) { 
-#pragma omp critical
-      {
-         constant_ += x; 
-      }
+   // Snapshot of all duals, i.e. reparametrized potentials of all factors, in one flat buffer laid out in factor order.
+   // Useful for checkpointing, rolling back after unsuccessful tightening and warm starting other processes.
+   std::size_t dual_state_size_in_bytes();
+   // write into internal buffer, which is allocated once and reused by subsequent calls
+   const std::vector<char>& save_dual_state();
+   void load_dual_state();
+   // write into/read from external buffer of dual_state_size_in_bytes() bytes
+   void save_dual_state(char* buffer);
+   void load_dual_state(const char* buffer);
+   // write into/read from memory mapped file
+   void save_dual_state_to_file(const std::string& filename);
+   void load_dual_state_from_file(const std::string& filename);
+
+   // levels of forward and backward update ordering for multithreaded passes
+   const two_dim_variable_array<std::size_t>& get_parallel_update_levels(const Direction d);
+   // runs of same-typed factors in forward and backward update ordering for batched passes
+   const std::vector<typename factors_storage<FMC_TYPE>::factor_type_run>& get_update_runs(const Direction d);
+
+   double get_constant() const { return constant_.load(); }
+
+   void add_to_constant(const double x) { 
+      double c = constant_.load();
+      while(!constant_.compare_exchange_weak(c, c + x)) {}
    }
 
 protected:
 
    //tsl::robin_map<lp_reparametrization, message_passing_weight_storage> message_passing_weights_;
    std::unordered_map<lp_reparametrization, message_passing_weight_storage> message_passing_weights_;
+   two_dim_variable_array<std::size_t> forward_update_levels_, backward_update_levels_;
+   std::vector<typename factors_storage<FMC_TYPE>::factor_type_run> forward_update_runs_, backward_update_runs_;
    lp_reparametrization repam_mode_ = lp_reparametrization(lp_reparametrization_mode::Undefined, 0.0);
    std::size_t rounding_iteration_ = 1;
-   double constant_ = 0.0;
+   std::atomic<double> constant_{0.0};
+
+   std::vector<std::size_t> dual_state_offsets_; // offset of each factor's duals in dual state buffer, last entry is total size
+   std::vector<char> dual_state_;
+   const std::vector<std::size_t>& get_dual_state_offsets();
 
    TCLAP::ValueArg<std::string> reparametrization_type_arg_; // shared|residual|partition|overlapping_partition
    TCLAP::ValueArg<INDEX> inner_iteration_number_arg_;
+   mutable TCLAP::ValueArg<INDEX> num_lp_threads_arg_; // mutable should not be necessary, but TCLAP's getValue is not const.
+   TCLAP::SwitchArg arena_allocation_arg_;
+   mutable TCLAP::SwitchArg incremental_lower_bound_arg_;
+
+   // incremental lower bound: cached lower bound of each factor and whether the factor was possibly changed since it was computed
+   mutable std::vector<double> factor_lower_bounds_;
+   mutable std::vector<char> factor_dirty_;
+   two_dim_variable_array<std::size_t> factor_footprints_; // factor indices changed by an update of the given factor
+   const two_dim_variable_array<std::size_t>& get_factor_footprints();
    enum class reparametrization_type {shared,residual,partition,overlapping_partition};
    reparametrization_type reparametrization_type_ = reparametrization_type::shared;
 
@@ -127,6 +182,9 @@ template<typename FMC>
 LP<FMC>::LP(TCLAP::CmdLine& cmd)
 : reparametrization_type_arg_("","reparametrizationType","message sending type: ", false, "shared", "{shared|residual|partition|overlapping_partition}", cmd)
 , inner_iteration_number_arg_("","innerIteration","number of iterations in inner loop in partition reparamtrization, default = 5",false,5,&positiveIntegerConstraint,cmd)
+, num_lp_threads_arg_("","numLpThreads","number of threads for message passing, default = 1",false,1,&positiveIntegerConstraint,cmd)
+, arena_allocation_arg_("","arenaAllocation","allocate factor and message payloads from one contiguous arena instead of the heap",cmd,false)
+, incremental_lower_bound_arg_("","incrementalLowerBound","reevaluate lower bound only for factors changed since the last evaluation",cmd,false)
 {}
 
 // make a deep copy of factors and messages. Adjust pointers to messages and factors
@@ -134,6 +192,9 @@ template<typename FMC>
 LP<FMC>::LP(LP& o) // no const because of o.num_lp_threads_arg_.getValue() not being const!
   : reparametrization_type_arg_("","reparametrizationType","message sending type: ", false, o.reparametrization_type_arg_.getValue(), "{shared|residual|partition|overlapping_partition}" )
 , inner_iteration_number_arg_("","innerIteration","number of iterations in inner loop in partition reparamtrization, default = 5",false,o.inner_iteration_number_arg_.getValue(),&positiveIntegerConstraint) 
+, num_lp_threads_arg_("","numLpThreads","number of threads for message passing, default = 1",false,o.num_lp_threads_arg_.getValue(),&positiveIntegerConstraint)
+, arena_allocation_arg_("","arenaAllocation","allocate factor and message payloads from one contiguous arena instead of the heap",o.arena_allocation_arg_.getValue())
+, incremental_lower_bound_arg_("","incrementalLowerBound","reevaluate lower bound only for factors changed since the last evaluation",o.incremental_lower_bound_arg_.getValue())
 {
   /*
   f_.reserve(o.f_.size());
@@ -208,6 +269,8 @@ inline void LP<FMC>::Begin()
    } else {
      throw std::runtime_error("reparamerization type not recognized");
    }
+
+   mark_all_dirty();
 }
 
 template<typename FMC>
@@ -215,6 +278,17 @@ template<typename FACTOR_CONTAINER_TYPE, typename... ARGS>
 FACTOR_CONTAINER_TYPE* LP<FMC>::add_factor(ARGS&&... args)
 {
    message_passing_weights_.clear();
+   forward_update_levels_ = two_dim_variable_array<std::size_t>();
+   backward_update_levels_ = two_dim_variable_array<std::size_t>();
+   forward_update_runs_.clear();
+   backward_update_runs_.clear();
+   factor_footprints_ = two_dim_variable_array<std::size_t>();
+   if(arena_allocation_arg_.getValue() && this->get_arena() == nullptr) {
+      this->enable_arena();
+   }
+   factor_lower_bounds_.push_back(0.0);
+   factor_dirty_.push_back(1);
+   dual_state_offsets_.clear();
    return factors_storage<FMC>::template add_factor<FACTOR_CONTAINER_TYPE>(std::forward<ARGS>(args)...);
 }
 
@@ -223,6 +297,16 @@ template<typename MESSAGE_CONTAINER_TYPE, typename LEFT_FACTOR, typename RIGHT_F
 MESSAGE_CONTAINER_TYPE* LP<FMC>::add_message(LEFT_FACTOR* l, RIGHT_FACTOR* r, ARGS&&... args)
 {
    message_passing_weights_.clear();
+   forward_update_levels_ = two_dim_variable_array<std::size_t>();
+   backward_update_levels_ = two_dim_variable_array<std::size_t>();
+   forward_update_runs_.clear();
+   backward_update_runs_.clear();
+   factor_footprints_ = two_dim_variable_array<std::size_t>();
+   // message initialization may reparametrize the connected factors
+   mark_dirty(l);
+   mark_dirty(r);
+   // message payloads held in factors go into the same arena as the factors
+   monotonic_arena::scope arena_scope(this->get_arena());
    return messages_storage<FMC>::template add_message<MESSAGE_CONTAINER_TYPE>(l,r, std::forward<ARGS>(args)...);
 }
 
@@ -236,17 +320,29 @@ inline void LP<FMC>::ComputePass()
 template<typename FMC>
 void LP<FMC>::ComputeForwardPass()
 {
-  auto mpw = get_message_passing_weight(repam_mode_);
+  auto& mpw = get_message_passing_weight(repam_mode_);
   auto [forward_sorting, forward_update_sorting] = this->get_sorted_factors(Direction::forward);
-  ComputePass(forward_update_sorting.begin(), forward_update_sorting.end(), mpw.omega_forward.begin(), mpw.receive_mask_forward.begin()); 
+  if(get_number_of_threads() > 1) {
+    ComputePass(get_parallel_update_levels(Direction::forward), forward_update_sorting.begin(), mpw.omega_forward.begin(), mpw.receive_mask_forward.begin()); 
+  } else if constexpr(factors_storage<FMC>::batched_factor_update()) {
+    ComputePass(get_update_runs(Direction::forward), forward_update_sorting.begin(), mpw.omega_forward.begin(), mpw.receive_mask_forward.begin()); 
+  } else {
+    ComputePass(forward_update_sorting.begin(), forward_update_sorting.end(), mpw.omega_forward.begin(), mpw.receive_mask_forward.begin()); 
+  }
 }
 
 template<typename FMC>
 void LP<FMC>::ComputeBackwardPass()
 {
-  auto mpw = get_message_passing_weight(repam_mode_);
+  auto& mpw = get_message_passing_weight(repam_mode_);
   auto [backward_sorting, backward_update_sorting] = this->get_sorted_factors(Direction::backward);
-  ComputePass(backward_update_sorting.begin(), backward_update_sorting.end(), mpw.omega_backward.begin(), mpw.receive_mask_backward.begin()); 
+  if(get_number_of_threads() > 1) {
+    ComputePass(get_parallel_update_levels(Direction::backward), backward_update_sorting.begin(), mpw.omega_backward.begin(), mpw.receive_mask_backward.begin()); 
+  } else if constexpr(factors_storage<FMC>::batched_factor_update()) {
+    ComputePass(get_update_runs(Direction::backward), backward_update_sorting.begin(), mpw.omega_backward.begin(), mpw.receive_mask_backward.begin()); 
+  } else {
+    ComputePass(backward_update_sorting.begin(), backward_update_sorting.end(), mpw.omega_backward.begin(), mpw.receive_mask_backward.begin()); 
+  }
 }
 
 template<typename FMC>
@@ -277,23 +373,225 @@ template<typename FACTOR_ITERATOR, typename OMEGA_ITERATOR, typename RECEIVE_MAS
 void LP<FMC>::ComputePass(FACTOR_ITERATOR factorIt, const FACTOR_ITERATOR factorItEnd, OMEGA_ITERATOR omegaIt, RECEIVE_MASK_ITERATOR receive_it)
 {
     const std::size_t n = std::distance(factorIt, factorItEnd);
-    //#pragma omp parallel for schedule(static)
     if(reparametrization_type_ == reparametrization_type::shared || reparametrization_type_ == reparametrization_type::partition || reparametrization_type_ == reparametrization_type::overlapping_partition) {
         for(std::size_t i=0; i<n; ++i) {
             auto* f = *(factorIt + i);
             assert(f->FactorUpdated());
             f->UpdateFactor(*(omegaIt + i), *(receive_it + i));
+            mark_updated(f);
         }
     } else if(reparametrization_type_ == reparametrization_type::residual) {
         for(std::size_t i=0; i<n; ++i) {
             auto* f = *(factorIt + i);
             f->update_factor_residual(*(omegaIt + i), *(receive_it + i));
+            mark_updated(f);
         }
     } else {
        throw std::runtime_error("reparametrization type not recognized");
     }
 }
 
+template<typename FMC>
+const std::vector<std::size_t>& LP<FMC>::get_dual_state_offsets()
+{
+   if(dual_state_offsets_.size() != this->number_of_factors() + 1) {
+      dual_state_offsets_.resize(this->number_of_factors() + 1);
+      dual_state_offsets_[0] = 0;
+      for(std::size_t i=0; i<this->number_of_factors(); ++i) {
+         dual_state_offsets_[i+1] = dual_state_offsets_[i] + this->get_factor(i)->dual_size_in_bytes();
+      }
+   }
+   return dual_state_offsets_;
+}
+
+template<typename FMC>
+std::size_t LP<FMC>::dual_state_size_in_bytes()
+{
+   return get_dual_state_offsets().back();
+}
+
+template<typename FMC>
+const std::vector<char>& LP<FMC>::save_dual_state()
+{
+   dual_state_.resize(dual_state_size_in_bytes());
+   save_dual_state(dual_state_.data());
+   return dual_state_;
+}
+
+template<typename FMC>
+void LP<FMC>::load_dual_state()
+{
+   if(dual_state_.size() != dual_state_size_in_bytes()) {
+      throw std::runtime_error("no dual state saved for current LP");
+   }
+   load_dual_state(dual_state_.data());
+}
+
+template<typename FMC>
+void LP<FMC>::save_dual_state(char* buffer)
+{
+   const auto& offsets = get_dual_state_offsets();
+   const std::size_t n = this->number_of_factors();
+   const int no_threads = get_number_of_threads();
+#pragma omp parallel for schedule(static) num_threads(no_threads) if(n > 1024)
+   for(std::size_t i=0; i<n; ++i) {
+      serialization_archive ar(buffer + offsets[i], offsets[i+1] - offsets[i]);
+      save_archive s_ar(ar);
+      this->get_factor(i)->serialize_dual(s_ar);
+      ar.release_memory();
+   }
+}
+
+template<typename FMC>
+void LP<FMC>::load_dual_state(const char* buffer)
+{
+   const auto& offsets = get_dual_state_offsets();
+   const std::size_t n = this->number_of_factors();
+   const int no_threads = get_number_of_threads();
+#pragma omp parallel for schedule(static) num_threads(no_threads) if(n > 1024)
+   for(std::size_t i=0; i<n; ++i) {
+      serialization_archive ar(buffer + offsets[i], offsets[i+1] - offsets[i]);
+      load_archive l_ar(ar);
+      this->get_factor(i)->serialize_dual(l_ar);
+      ar.release_memory();
+   }
+   mark_all_dirty();
+}
+
+template<typename FMC>
+void LP<FMC>::save_dual_state_to_file(const std::string& filename)
+{
+   memory_mapped_file file(filename, dual_state_size_in_bytes());
+   save_dual_state(file.data());
+}
+
+template<typename FMC>
+void LP<FMC>::load_dual_state_from_file(const std::string& filename)
+{
+   const memory_mapped_file file(filename);
+   if(file.size() != dual_state_size_in_bytes()) {
+      throw std::runtime_error("dual state in " + filename + " does not fit LP");
+   }
+   load_dual_state(file.data());
+}
+
+template<typename FMC>
+void LP<FMC>::mark_dirty(const FactorTypeAdapter* f)
+{
+   factor_dirty_[this->get_factor_index(f)] = 1;
+}
+
+template<typename FMC>
+inline void LP<FMC>::mark_updated(const FactorTypeAdapter* f)
+{
+   if(!incremental_lower_bound()) { return; }
+   const auto footprint = get_factor_footprints()[this->get_factor_index(f)];
+   for(const std::size_t i : footprint) {
+      factor_dirty_[i] = 1;
+   }
+}
+
+template<typename FMC>
+const two_dim_variable_array<std::size_t>& LP<FMC>::get_factor_footprints()
+{
+   if(factor_footprints_.size() != this->number_of_factors()) {
+      std::vector<std::vector<std::size_t>> footprints(this->number_of_factors());
+      for(std::size_t i=0; i<this->number_of_factors(); ++i) {
+         auto* f = this->get_factor(i);
+         footprints[i].push_back(i);
+         for(auto* a : f->get_adjacent_factors()) {
+            footprints[i].push_back(this->get_factor_index(a));
+         }
+      }
+      factor_footprints_ = two_dim_variable_array<std::size_t>(footprints);
+   }
+   return factor_footprints_;
+}
+
+template<typename FMC>
+template<typename FACTOR_ITERATOR, typename OMEGA_ITERATOR, typename RECEIVE_MASK_ITERATOR>
+void LP<FMC>::ComputePass(const two_dim_variable_array<std::size_t>& levels, FACTOR_ITERATOR factorIt, OMEGA_ITERATOR omegaIt, RECEIVE_MASK_ITERATOR receive_it)
+{
+    const int no_threads = get_number_of_threads();
+    const bool residual = reparametrization_type_ == reparametrization_type::residual;
+    if(!residual && reparametrization_type_ != reparametrization_type::shared && reparametrization_type_ != reparametrization_type::partition && reparametrization_type_ != reparametrization_type::overlapping_partition) {
+       throw std::runtime_error("reparametrization type not recognized");
+    }
+
+    if(incremental_lower_bound()) { get_factor_footprints(); } // compute before entering parallel region
+
+    // levels must be processed one after the other, factors within a level are independent of each other
+    for(std::size_t l=0; l<levels.size(); ++l) {
+        const auto level = levels[l];
+        const std::size_t level_size = level.size();
+#pragma omp parallel for schedule(static) num_threads(no_threads) if(level_size > 1)
+        for(std::size_t j=0; j<level_size; ++j) {
+            const std::size_t i = level[j];
+            auto* f = *(factorIt + i);
+            if(residual) {
+                f->update_factor_residual(*(omegaIt + i), *(receive_it + i));
+            } else {
+                assert(f->FactorUpdated());
+                f->UpdateFactor(*(omegaIt + i), *(receive_it + i));
+            }
+            // footprints of factors in one level are disjoint
+            mark_updated(f);
+        }
+    }
+}
+
+template<typename FMC>
+template<typename FACTOR_ITERATOR, typename OMEGA_ITERATOR, typename RECEIVE_MASK_ITERATOR>
+void LP<FMC>::ComputePass(const std::vector<typename factors_storage<FMC>::factor_type_run>& runs, FACTOR_ITERATOR factorIt, OMEGA_ITERATOR omegaIt, RECEIVE_MASK_ITERATOR receive_it)
+{
+    const bool residual = reparametrization_type_ == reparametrization_type::residual;
+    if(!residual && reparametrization_type_ != reparametrization_type::shared && reparametrization_type_ != reparametrization_type::partition && reparametrization_type_ != reparametrization_type::overlapping_partition) {
+       throw std::runtime_error("reparametrization type not recognized");
+    }
+
+    for(const auto& run : runs) {
+        this->dispatch_factor_type(run.type_index, [&](auto* type_tag) {
+            using factor_container_type = std::remove_pointer_t<decltype(type_tag)>;
+            for(std::size_t i=run.begin; i<run.end; ++i) {
+                assert(dynamic_cast<factor_container_type*>(*(factorIt + i)) != nullptr);
+                auto* f = static_cast<factor_container_type*>(*(factorIt + i));
+                // qualified calls are resolved statically
+                if(residual) {
+                    f->factor_container_type::update_factor_residual(*(omegaIt + i), *(receive_it + i));
+                } else {
+                    assert(f->FactorUpdated());
+                    f->factor_container_type::UpdateFactor(*(omegaIt + i), *(receive_it + i));
+                }
+                mark_updated(f);
+            }
+        });
+    }
+}
+
+template<typename FMC>
+const std::vector<typename factors_storage<FMC>::factor_type_run>& LP<FMC>::get_update_runs(const Direction d)
+{
+   auto [sorting, update_sorting] = this->get_sorted_factors(d);
+   auto& runs = d == Direction::forward ? forward_update_runs_ : backward_update_runs_;
+   if(runs.size() == 0 && update_sorting.size() > 0) {
+      runs = this->compute_factor_type_runs(update_sorting.begin(), update_sorting.end());
+      if(debug()) { std::cout << "batched pass: " << update_sorting.size() << " factor updates in " << runs.size() << " runs of same factor type\n"; }
+   }
+   return runs;
+}
+
+template<typename FMC>
+const two_dim_variable_array<std::size_t>& LP<FMC>::get_parallel_update_levels(const Direction d)
+{
+   auto [sorting, update_sorting] = this->get_sorted_factors(d);
+   auto& levels = d == Direction::forward ? forward_update_levels_ : backward_update_levels_;
+   if(levels.size() == 0 && update_sorting.size() > 0) {
+      levels = compute_parallel_update_levels(update_sorting.begin(), update_sorting.end(), this->number_of_factors(), [this](const FactorTypeAdapter* f) { return this->get_factor_index(f); });
+      if(debug()) { std::cout << "parallel pass: " << update_sorting.size() << " factor updates in " << levels.size() << " levels\n"; }
+   }
+   return levels;
+}
+
 template<typename FMC>
 typename LP<FMC>::message_passing_weight_storage& 
 LP<FMC>::get_message_passing_weight(const lp_reparametrization repam)
@@ -352,27 +650,64 @@ bool LP<FMC>::CheckPrimalConsistency() const
 template<typename FMC>
 double LP<FMC>::LowerBound() const
 {
-    double lb = constant_;
-    this->for_each_factor([&lb](const auto& f) { 
-       const double delta = f.LowerBound();
-       assert(delta < std::numeric_limits<double>::max());
-#pragma omp critical
-       {
-         lb += delta;
+    const bool incremental = incremental_lower_bound();
+    assert(!incremental || factor_dirty_.size() == this->number_of_factors());
+    const double lb = reduce_over_factors([&](const std::size_t i) {
+       if(incremental && !factor_dirty_[i]) {
+          assert(factor_lower_bounds_[i] == this->get_factor(i)->LowerBound());
+          return factor_lower_bounds_[i];
        }
-       assert(std::isfinite(lb));
+       const double delta = this->get_factor(i)->LowerBound();
+       assert(delta < std::numeric_limits<double>::max());
+       factor_lower_bounds_[i] = delta;
+       factor_dirty_[i] = 0;
+       return delta;
     });
-
-    //assert(std::abs(lb - std::accumulate(factors_storage<FMC>::cbegin(), factors_storage<FMC>::cend(), [](const double lb, const auto* f) { return lb + f->LowerBound; }, 0.0)) <= eps);
+    assert(std::isfinite(lb));
     return lb;
 }
 
+template<typename FMC>
+template<typename FUNC>
+double LP<FMC>::reduce_over_factors(FUNC&& func) const
+{
+    constexpr std::size_t block_size = 1024;
+    const std::size_t n = this->number_of_factors();
+    const std::size_t no_blocks = (n + block_size - 1) / block_size;
+    if(no_blocks == 0) { return constant_.load(); }
+
+    std::vector<compensated_sum<double>> partial_sums(no_blocks);
+    const int no_threads = get_number_of_threads();
+#pragma omp parallel for schedule(static) num_threads(no_threads) if(no_blocks > 1)
+    for(std::size_t b=0; b<no_blocks; ++b) {
+       compensated_sum<double> s;
+       const std::size_t end = std::min(n, (b+1)*block_size);
+       for(std::size_t i=b*block_size; i<end; ++i) {
+          s += func(i);
+       }
+       partial_sums[b] = s;
+    }
+
+    for(std::size_t stride=1; stride<no_blocks; stride*=2) {
+       for(std::size_t b=0; b+stride<no_blocks; b+=2*stride) {
+          partial_sums[b] += partial_sums[b+stride];
+       }
+    }
+
+    compensated_sum<double> sum(constant_.load());
+    sum += partial_sums[0];
+    return sum.value();
+}
+
 template<typename FMC>
 void LP<FMC>::init_primal()
 {
-    this->for_each_factor([](auto& f) { 
-       f.init_primal();
-    }); 
+    const std::size_t n = this->number_of_factors();
+    const int no_threads = get_number_of_threads();
+#pragma omp parallel for schedule(static) num_threads(no_threads) if(n > 1024)
+    for(std::size_t i=0; i<n; ++i) {
+       this->get_factor(i)->init_primal();
+    }
 }
 
 template<typename FMC>
@@ -382,15 +717,8 @@ double LP<FMC>::EvaluatePrimal() const
     if(consistent == false)
        return std::numeric_limits<REAL>::infinity();
 
-    double cost = constant_;
-    this->for_each_factor([&cost](const auto& f) {
-          const double delta = f.EvaluatePrimal();
-          //assert(delta < std::numeric_limits<double>::max()); // need not hold true, since we can have infeasible solutions
-#pragma omp critical
-          {
-            cost += delta;
-          }
-    });
+    // infeasible factors may return infinity, which the reduction propagates
+    const double cost = reduce_over_factors([this](const std::size_t i) { return this->get_factor(i)->EvaluatePrimal(); });
     if(debug())
        std::cout << "primal cost = " << cost << "\n";
     return cost;
@@ -458,6 +786,7 @@ void LP<FMC>::ComputePassAndPrimal(FACTOR_ITERATOR factorIt, const FACTOR_ITERAT
       auto* f = *(factorIt+i);
       assert(f->FactorUpdated());
       f->UpdateFactorPrimal(*(omegaIt + i), *(receive_mask_it + i), rounding_iteration_);
+      mark_updated(f);
    }
 }
 
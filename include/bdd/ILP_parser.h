@@ -4,9 +4,20 @@ namespace LPMP {
 
     namespace ILP_parser {
 
+        // text files are read by parse_file_mmap, files written by write_binary by read_binary
         ILP_input parse_file(const std::string& filename);
+        // grammar based parser
         ILP_input parse_string(const std::string& input);
 
+        // hand-written reader for large LP files: memory-maps the file and parses constraints in parallel chunks.
+        // Variables are numbered in order of first occurrence, as in parse_file. nr_threads = 0 uses all hardware threads.
+        // Constraints are split into at most 4*nr_threads chunks of at least min_chunk_size bytes.
+        ILP_input parse_file_mmap(const std::string& filename, const std::size_t nr_threads = 0, const std::size_t min_chunk_size = 1 << 16);
+
+        // binary cache of parsed input for re-runs, in native byte order
+        void write_binary(const ILP_input& input, const std::string& filename);
+        ILP_input read_binary(const std::string& filename);
+
     }
 
 }
@@ -0,0 +1,454 @@
+#pragma once
+
+#include "bdd_min_marginal_averaging.h"
+#include "bdd_storage.h"
+#include "two_dimensional_variable_array.hxx"
+#include "tclap/CmdLine.h"
+#include <vector>
+#include <numeric>
+#include <cmath>
+#include <stdexcept>
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <cassert>
+
+namespace LPMP {
+
+    ////////////////////////////////////////////////////
+    // Compact Branch Node Layout
+    ////////////////////////////////////////////////////
+
+    // Topology of a bdd branch node. Outgoing arcs are 32 bit offsets relative to the node's own index, incoming arcs are not stored.
+    // Shortest path values are kept in separate arrays, so that passes only stream through the data they need.
+    struct bdd_branch_node_vec {
+        constexpr static std::uint32_t terminal_0 = std::numeric_limits<std::uint32_t>::max()-1;
+        constexpr static std::uint32_t terminal_1 = std::numeric_limits<std::uint32_t>::max();
+        constexpr static std::uint32_t max_offset = std::numeric_limits<std::uint32_t>::max()-2;
+
+        std::uint32_t offset_low = terminal_0;
+        std::uint32_t offset_high = terminal_0;
+
+        static bool is_terminal(const std::uint32_t offset) { return offset == terminal_0 || offset == terminal_1; }
+    };
+
+    struct bdd_variable_vec {
+        std::size_t first_node_index = std::numeric_limits<std::size_t>::max();
+        std::size_t last_node_index = std::numeric_limits<std::size_t>::max();
+        double cost = 0.0;
+
+        std::size_t nr_bdd_nodes() const { return last_node_index - first_node_index; }
+    };
+
+    ////////////////////////////////////////////////////
+    // Min-Marginal Averaging on compact layout
+    ////////////////////////////////////////////////////
+
+    // Same algorithm as bdd_min_marginal_averaging with classic averaging. Nodes are ordered by variable and then by bdd.
+    // Forward values are pushed along outgoing arcs, backward values are pulled.
+    // Per node 8 bytes of topology and 16 bytes of forward and backward values are stored instead of 6 pointers, a cost pointer and a value.
+    // This is a separate solver, not a node type for bdd_mma_base: the smoothed, fixing and SRMP variants cannot use the compact layout.
+    class bdd_mma_vec {
+        public:
+            bdd_mma_vec(TCLAP::CmdLine& cmd);
+            bdd_mma_vec(const bdd_mma_vec&) = delete;
+
+            void init();
+
+            std::size_t nr_variables() const { return bdd_variables_.size(); }
+            std::size_t nr_bdds() const { return root_nodes_.size(); }
+            std::size_t nr_bdds(const std::size_t var) const { assert(var<nr_variables()); return bdd_variables_[var].size(); }
+            std::size_t nr_bdd_nodes() const { return bdd_branch_nodes_.size(); }
+
+            template<typename ITERATOR>
+                void set_costs(ITERATOR begin, ITERATOR end);
+
+            template<typename ITERATOR>
+                bool check_feasibility(ITERATOR var_begin, ITERATOR var_end) const;
+            template<typename ITERATOR>
+                double evaluate(ITERATOR var_begin, ITERATOR var_end) const;
+
+            double lower_bound() const { return lower_bound_; }
+            double compute_lower_bound();
+
+            void forward_run();
+            void backward_run();
+
+            std::array<double,2> min_marginal(const std::size_t var, const std::size_t bdd_index) const;
+            // min-marginals of all bdds containing var in one sweep over the var's contiguous node range, returns their average
+            std::array<double,2> compute_min_marginals(const std::size_t var, std::vector<std::array<double,2>>& min_marginals);
+
+            void min_marginal_averaging_forward();
+            void min_marginal_averaging_backward();
+            void iteration();
+
+        private:
+            void init_branch_nodes();
+            void reset_forward_values();
+            void forward_step(const std::size_t var, const std::size_t bdd_index);
+            void backward_step(const std::size_t var, const std::size_t bdd_index);
+            void set_marginal(const std::size_t var, const std::size_t bdd_index, const std::array<double,2> marginals, const std::array<double,2> min_marginals);
+            double backward_value(const std::size_t i, const std::uint32_t offset) const;
+
+            std::vector<bdd_branch_node_vec> bdd_branch_nodes_;
+            std::vector<double> forward_m_;
+            std::vector<double> backward_m_;
+            two_dim_variable_array<bdd_variable_vec> bdd_variables_;
+            std::vector<std::size_t> root_nodes_; // first node of every bdd
+
+            // per node candidate values of the variable currently processed in min_marginals
+            std::vector<double> low_m_;
+            std::vector<double> high_m_;
+
+            std::vector<double> costs_;
+            double unconstrained_lower_bound_ = 0.0; // contribution of variables in no bdd
+            double lower_bound_ = -std::numeric_limits<double>::infinity();
+
+            TCLAP::ValueArg<std::string> input_file_arg_;
+            bdd_min_marginal_averaging_options options;
+            bdd_storage bdd_storage_;
+            ILP_input ilp_input_;
+    };
+
+    inline bdd_mma_vec::bdd_mma_vec(TCLAP::CmdLine& cmd)
+        : input_file_arg_("i","input","input file",true,"", "", cmd),
+        options(cmd),
+        bdd_storage_(cmd)
+    {}
+
+    inline void bdd_mma_vec::init()
+    {
+        options.init();
+        if(options.averaging_type != bdd_min_marginal_averaging_options::averaging_type::classic)
+            throw std::runtime_error("compact bdd layout only supports classic averaging");
+        ilp_input_ = ILP_parser::parse_file(input_file_arg_.getValue());
+        options.reorder(ilp_input_);
+        bdd_storage_.init(ilp_input_);
+        init_branch_nodes();
+        set_costs(ilp_input_.objective().begin(), ilp_input_.objective().end());
+    }
+
+    inline void bdd_mma_vec::init_branch_nodes()
+    {
+        assert(bdd_storage_.nr_variables() > 0 && bdd_storage_.nr_bdds() > 0);
+        const auto& stored_nodes = bdd_storage_.bdd_nodes();
+        const auto& bdd_delimiters = bdd_storage_.bdd_delimiters();
+        if(stored_nodes.size() > bdd_branch_node_vec::max_offset)
+            throw std::runtime_error("too many bdd nodes for 32 bit offsets");
+
+        // count nodes and bdds per variable
+        std::vector<std::size_t> nr_bdd_nodes_per_variable(bdd_storage_.nr_variables(), 0);
+        std::vector<std::size_t> nr_bdds_per_variable(bdd_storage_.nr_variables(), 0);
+        std::vector<std::size_t> last_bdd_of_variable(bdd_storage_.nr_variables(), std::numeric_limits<std::size_t>::max());
+        for(std::size_t bdd_nr=0; bdd_nr<bdd_storage_.nr_bdds(); ++bdd_nr) {
+            for(std::size_t i=bdd_delimiters[bdd_nr]; i<bdd_delimiters[bdd_nr+1]; ++i) {
+                const std::size_t v = stored_nodes[i].variable;
+                ++nr_bdd_nodes_per_variable[v];
+                if(last_bdd_of_variable[v] != bdd_nr) {
+                    last_bdd_of_variable[v] = bdd_nr;
+                    ++nr_bdds_per_variable[v];
+                }
+            }
+        }
+
+        bdd_variables_.resize(nr_bdds_per_variable.begin(), nr_bdds_per_variable.end());
+
+        // nodes of a variable are laid out bdd after bdd, in the order of bdds
+        std::vector<std::size_t> node_offset_per_variable(bdd_storage_.nr_variables(), 0);
+        std::partial_sum(nr_bdd_nodes_per_variable.begin(), nr_bdd_nodes_per_variable.end()-1, node_offset_per_variable.begin()+1);
+        std::fill(nr_bdds_per_variable.begin(), nr_bdds_per_variable.end(), 0);
+        std::fill(last_bdd_of_variable.begin(), last_bdd_of_variable.end(), std::numeric_limits<std::size_t>::max());
+
+        bdd_branch_nodes_.clear();
+        bdd_branch_nodes_.resize(stored_nodes.size());
+        root_nodes_.clear();
+        root_nodes_.reserve(bdd_storage_.nr_bdds());
+        std::vector<std::size_t> node_index; // index of stored node in bdd_branch_nodes_, for current bdd
+
+        for(std::size_t bdd_nr=0; bdd_nr<bdd_storage_.nr_bdds(); ++bdd_nr) {
+            const std::size_t first_stored = bdd_delimiters[bdd_nr];
+            node_index.resize(bdd_delimiters[bdd_nr+1] - first_stored);
+            std::size_t root = std::numeric_limits<std::size_t>::max();
+            std::size_t root_var = std::numeric_limits<std::size_t>::max();
+
+            for(std::size_t i=first_stored; i<bdd_delimiters[bdd_nr+1]; ++i) {
+                const std::size_t v = stored_nodes[i].variable;
+                if(last_bdd_of_variable[v] != bdd_nr) {
+                    last_bdd_of_variable[v] = bdd_nr;
+                    auto& bdd_var = bdd_variables_(v, nr_bdds_per_variable[v]++);
+                    bdd_var.first_node_index = node_offset_per_variable[v];
+                    bdd_var.last_node_index = node_offset_per_variable[v];
+                }
+                auto& bdd_var = bdd_variables_(v, nr_bdds_per_variable[v]-1);
+                node_index[i - first_stored] = bdd_var.last_node_index++;
+                ++node_offset_per_variable[v];
+                if(v < root_var) {
+                    root_var = v;
+                    root = node_index[i - first_stored];
+                }
+            }
+
+            // stored nodes point to nodes stored before them
+            auto offset = [&](const std::size_t i, const std::size_t stored_target) -> std::uint32_t {
+                if(stored_target == bdd_storage::bdd_node::terminal_0)
+                    return bdd_branch_node_vec::terminal_0;
+                if(stored_target == bdd_storage::bdd_node::terminal_1)
+                    return bdd_branch_node_vec::terminal_1;
+                assert(stored_target >= first_stored && stored_target < i);
+                const std::size_t target = node_index[stored_target - first_stored];
+                assert(target > node_index[i - first_stored]);
+                return target - node_index[i - first_stored];
+            };
+            for(std::size_t i=first_stored; i<bdd_delimiters[bdd_nr+1]; ++i) {
+                auto& bdd = bdd_branch_nodes_[node_index[i - first_stored]];
+                bdd.offset_low = offset(i, stored_nodes[i].low);
+                bdd.offset_high = offset(i, stored_nodes[i].high);
+            }
+
+            assert(bdd_variables_(root_var, nr_bdds_per_variable[root_var]-1).nr_bdd_nodes() == 1);
+            root_nodes_.push_back(root);
+        }
+
+        forward_m_.clear();
+        forward_m_.resize(bdd_branch_nodes_.size(), std::numeric_limits<double>::infinity());
+        backward_m_.clear();
+        backward_m_.resize(bdd_branch_nodes_.size(), std::numeric_limits<double>::infinity());
+        costs_.resize(nr_variables(), 0.0);
+
+        std::size_t max_nr_nodes_per_variable = 0;
+        for(std::size_t v=0; v<nr_variables(); ++v)
+            if(nr_bdds(v) > 0)
+                max_nr_nodes_per_variable = std::max(max_nr_nodes_per_variable, bdd_variables_(v, nr_bdds(v)-1).last_node_index - bdd_variables_(v, 0).first_node_index);
+        low_m_.resize(max_nr_nodes_per_variable);
+        high_m_.resize(max_nr_nodes_per_variable);
+    }
+
+    template<typename ITERATOR>
+        void bdd_mma_vec::set_costs(ITERATOR begin, ITERATOR end)
+        {
+            assert(std::distance(begin,end) <= nr_variables());
+            std::fill(costs_.begin(), costs_.end(), 0.0);
+            std::copy(begin, end, costs_.begin());
+
+            // distribute costs to bdds uniformly. Variables in no bdd are set optimally.
+            unconstrained_lower_bound_ = 0.0;
+            for(std::size_t v=0; v<nr_variables(); ++v) {
+                if(nr_bdds(v) == 0)
+                    unconstrained_lower_bound_ += std::min(costs_[v], 0.0);
+                for(std::size_t bdd_index=0; bdd_index<nr_bdds(v); ++bdd_index)
+                    bdd_variables_(v,bdd_index).cost = costs_[v] / nr_bdds(v);
+            }
+            backward_run();
+        }
+
+    inline double bdd_mma_vec::backward_value(const std::size_t i, const std::uint32_t offset) const
+    {
+        if(offset == bdd_branch_node_vec::terminal_0)
+            return std::numeric_limits<double>::infinity();
+        if(offset == bdd_branch_node_vec::terminal_1)
+            return 0.0;
+        assert(i + offset < backward_m_.size());
+        return backward_m_[i + offset];
+    }
+
+    inline void bdd_mma_vec::reset_forward_values()
+    {
+        std::fill(forward_m_.begin(), forward_m_.end(), std::numeric_limits<double>::infinity());
+        for(const std::size_t r : root_nodes_)
+            forward_m_[r] = 0.0;
+    }
+
+    // push forward values of all nodes of given bdd variable to their successors
+    inline void bdd_mma_vec::forward_step(const std::size_t var, const std::size_t bdd_index)
+    {
+        const auto& bdd_var = bdd_variables_(var, bdd_index);
+        for(std::size_t i=bdd_var.first_node_index; i<bdd_var.last_node_index; ++i) {
+            const auto& bdd = bdd_branch_nodes_[i];
+            assert(std::isfinite(forward_m_[i]));
+            if(!bdd_branch_node_vec::is_terminal(bdd.offset_low))
+                forward_m_[i + bdd.offset_low] = std::min(forward_m_[i + bdd.offset_low], forward_m_[i]);
+            if(!bdd_branch_node_vec::is_terminal(bdd.offset_high))
+                forward_m_[i + bdd.offset_high] = std::min(forward_m_[i + bdd.offset_high], forward_m_[i] + bdd_var.cost);
+        }
+    }
+
+    inline void bdd_mma_vec::backward_step(const std::size_t var, const std::size_t bdd_index)
+    {
+        const auto& bdd_var = bdd_variables_(var, bdd_index);
+        for(std::size_t i=bdd_var.first_node_index; i<bdd_var.last_node_index; ++i) {
+            const auto& bdd = bdd_branch_nodes_[i];
+            backward_m_[i] = std::min(backward_value(i, bdd.offset_low), backward_value(i, bdd.offset_high) + bdd_var.cost);
+            assert(std::isfinite(backward_m_[i]));
+        }
+    }
+
+    inline void bdd_mma_vec::forward_run()
+    {
+        reset_forward_values();
+        for(std::size_t var=0; var<nr_variables(); ++var)
+            for(std::size_t bdd_index=0; bdd_index<nr_bdds(var); ++bdd_index)
+                forward_step(var, bdd_index);
+    }
+
+    inline void bdd_mma_vec::backward_run()
+    {
+        for(std::ptrdiff_t var=nr_variables()-1; var>=0; --var)
+            for(std::size_t bdd_index=0; bdd_index<nr_bdds(var); ++bdd_index)
+                backward_step(var, bdd_index);
+    }
+
+    inline double bdd_mma_vec::compute_lower_bound()
+    {
+        backward_run();
+        double lb = unconstrained_lower_bound_;
+        for(const std::size_t r : root_nodes_)
+            lb += backward_m_[r];
+        lower_bound_ = lb;
+        return lb;
+    }
+
+    // forward values of nodes of var and backward values of their successors must be current
+    inline std::array<double,2> bdd_mma_vec::min_marginal(const std::size_t var, const std::size_t bdd_index) const
+    {
+        std::array<double,2> m = {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+        const auto& bdd_var = bdd_variables_(var, bdd_index);
+        for(std::size_t i=bdd_var.first_node_index; i<bdd_var.last_node_index; ++i) {
+            const auto& bdd = bdd_branch_nodes_[i];
+            m[0] = std::min(m[0], forward_m_[i] + backward_value(i, bdd.offset_low));
+            m[1] = std::min(m[1], forward_m_[i] + bdd_var.cost + backward_value(i, bdd.offset_high));
+        }
+        assert(std::isfinite(m[0]));
+        assert(std::isfinite(m[1]));
+        return m;
+    }
+
+    inline std::array<double,2> bdd_mma_vec::compute_min_marginals(const std::size_t var, std::vector<std::array<double,2>>& min_marginals)
+    {
+        min_marginals.resize(nr_bdds(var));
+        if(nr_bdds(var) == 0)
+            return {0.0, 0.0};
+
+        const std::size_t first = bdd_variables_(var, 0).first_node_index;
+        const std::size_t last = bdd_variables_(var, nr_bdds(var)-1).last_node_index;
+        assert(last - first <= low_m_.size());
+
+        // gather successor values, the only non-contiguous accesses
+        for(std::size_t i=first; i<last; ++i) {
+            const auto& bdd = bdd_branch_nodes_[i];
+            low_m_[i-first] = forward_m_[i] + backward_value(i, bdd.offset_low);
+            high_m_[i-first] = forward_m_[i] + backward_value(i, bdd.offset_high);
+        }
+
+        std::array<double,2> average_marginal = {0.0, 0.0};
+        const double* low_m = low_m_.data();
+        const double* high_m = high_m_.data();
+        for(std::size_t bdd_index=0; bdd_index<nr_bdds(var); ++bdd_index) {
+            const auto& bdd_var = bdd_variables_(var, bdd_index);
+            double m0 = std::numeric_limits<double>::infinity();
+            double m1 = std::numeric_limits<double>::infinity();
+#pragma omp simd reduction(min:m0,m1)
+            for(std::size_t i=bdd_var.first_node_index-first; i<bdd_var.last_node_index-first; ++i) {
+                m0 = std::min(m0, low_m[i]);
+                m1 = std::min(m1, high_m[i]);
+            }
+            m1 += bdd_var.cost;
+            assert(std::isfinite(m0));
+            assert(std::isfinite(m1));
+            min_marginals[bdd_index] = {m0, m1};
+            average_marginal[0] += m0;
+            average_marginal[1] += m1;
+        }
+
+        average_marginal[0] /= nr_bdds(var);
+        average_marginal[1] /= nr_bdds(var);
+        return average_marginal;
+    }
+
+    inline void bdd_mma_vec::set_marginal(const std::size_t var, const std::size_t bdd_index, const std::array<double,2> marginals, const std::array<double,2> min_marginals)
+    {
+        auto& bdd_var = bdd_variables_(var, bdd_index);
+        bdd_var.cost += -(min_marginals[1] - min_marginals[0]) + (marginals[1] - marginals[0]);
+    }
+
+    inline void bdd_mma_vec::min_marginal_averaging_forward()
+    {
+        reset_forward_values();
+        std::vector<std::array<double,2>> min_marginals;
+        for(std::size_t var=0; var<nr_variables(); ++var) {
+            const std::array<double,2> average_marginal = compute_min_marginals(var, min_marginals);
+            for(std::size_t bdd_index=0; bdd_index<nr_bdds(var); ++bdd_index) {
+                set_marginal(var, bdd_index, average_marginal, min_marginals[bdd_index]);
+                forward_step(var, bdd_index);
+            }
+        }
+    }
+
+    inline void bdd_mma_vec::min_marginal_averaging_backward()
+    {
+        std::vector<std::array<double,2>> min_marginals;
+        for(std::ptrdiff_t var=nr_variables()-1; var>=0; --var) {
+            const std::array<double,2> average_marginal = compute_min_marginals(var, min_marginals);
+            for(std::size_t bdd_index=0; bdd_index<nr_bdds(var); ++bdd_index) {
+                set_marginal(var, bdd_index, average_marginal, min_marginals[bdd_index]);
+                backward_step(var, bdd_index);
+            }
+        }
+
+        double lb = unconstrained_lower_bound_;
+        for(const std::size_t r : root_nodes_)
+            lb += backward_m_[r];
+        lower_bound_ = lb;
+    }
+
+    inline void bdd_mma_vec::iteration()
+    {
+        assert(options.averaging_type == bdd_min_marginal_averaging_options::averaging_type::classic);
+        min_marginal_averaging_forward();
+        min_marginal_averaging_backward();
+    }
+
+    template<typename ITERATOR>
+        bool bdd_mma_vec::check_feasibility(ITERATOR var_begin, ITERATOR var_end) const
+        {
+            assert(std::distance(var_begin, var_end) == nr_variables());
+
+            std::vector<char> reached(bdd_branch_nodes_.size(), 0);
+            for(const std::size_t r : root_nodes_)
+                reached[r] = 1;
+
+            std::size_t var = 0;
+            for(auto var_iter=var_begin; var_iter!=var_end; ++var_iter, ++var) {
+                const bool val = *var_iter;
+                for(std::size_t bdd_index=0; bdd_index<nr_bdds(var); ++bdd_index) {
+                    const auto& bdd_var = bdd_variables_(var, bdd_index);
+                    for(std::size_t i=bdd_var.first_node_index; i<bdd_var.last_node_index; ++i) {
+                        if(!reached[i])
+                            continue;
+                        const std::uint32_t offset = val ? bdd_branch_nodes_[i].offset_high : bdd_branch_nodes_[i].offset_low;
+                        if(offset == bdd_branch_node_vec::terminal_0)
+                            return false;
+                        if(offset != bdd_branch_node_vec::terminal_1)
+                            reached[i + offset] = 1;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+    template<typename ITERATOR>
+        double bdd_mma_vec::evaluate(ITERATOR var_begin, ITERATOR var_end) const
+        {
+            assert(std::distance(var_begin, var_end) == nr_variables());
+
+            if(!check_feasibility(var_begin, var_end))
+                return std::numeric_limits<double>::infinity();
+
+            double cost = 0.0;
+            std::size_t var = 0;
+            for(auto var_iter=var_begin; var_iter!=var_end; ++var_iter, ++var)
+                cost += *var_iter * costs_[var];
+            return cost;
+        }
+
+}
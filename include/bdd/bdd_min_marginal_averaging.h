@@ -28,6 +28,8 @@ namespace LPMP {
         bdd_min_marginal_averaging_options(TCLAP::CmdLine& cmd);
 
         void init();
+        // reorder variables of input as given by variable_order
+        void reorder(ILP_input& input) const;
 
         enum class averaging_type {classic, SRMP} averaging_type = averaging_type::classic;
         enum class variable_order {input, bfs, cuthill, mindegree} variable_order = variable_order::input;
@@ -147,14 +149,7 @@ namespace LPMP {
     void bdd_base<BDD_VARIABLE, BDD_BRANCH_NODE>::init()
     {
         ilp_input_ = ILP_parser::parse_file(input_file_arg_.getValue());
-
-        if (options.variable_order == bdd_min_marginal_averaging_options::variable_order::bfs)
-            ilp_input_.reorder_bfs();
-        else if (options.variable_order == bdd_min_marginal_averaging_options::variable_order::cuthill)
-            ilp_input_.reorder_Cuthill_McKee();
-        else if (options.variable_order == bdd_min_marginal_averaging_options::variable_order::mindegree)
-            ilp_input_.reorder_minimum_degree_averaging();
-
+        options.reorder(ilp_input_);
         bdd_storage_.init(ilp_input_);
 
         init_branch_nodes();
@@ -552,6 +547,8 @@ namespace LPMP {
         void min_marginal_averaging_step_backward(const size_t var, std::vector<std::array<double,2>>& min_marginals); 
 
         std::array<double, 2> min_marginal(const std::size_t var, const std::size_t bdd_index) const;
+        // min-marginals of all bdds containing var in one sweep over the var's contiguous branch node range
+        void compute_min_marginals(const std::size_t var, std::vector<std::array<double,2>>& min_marginals) const;
         template <typename ITERATOR>
         static std::array<double, 2> average_marginals(ITERATOR marginals_begin, ITERATOR marginals_end, const std::size_t nr_marginals_to_distribute = std::numeric_limits<std::size_t>::max());
         template <typename ITERATOR>
@@ -619,6 +616,16 @@ namespace LPMP {
                 throw std::runtime_error("variable fixing preferred value not recognized");
         }
 
+    inline void bdd_min_marginal_averaging_options::reorder(ILP_input& input) const
+    {
+        if (variable_order == bdd_min_marginal_averaging_options::variable_order::bfs)
+            input.reorder_bfs();
+        else if (variable_order == bdd_min_marginal_averaging_options::variable_order::cuthill)
+            input.reorder_Cuthill_McKee();
+        else if (variable_order == bdd_min_marginal_averaging_options::variable_order::mindegree)
+            input.reorder_minimum_degree_averaging();
+    }
+
     template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
     void bdd_mma_base<BDD_VARIABLE, BDD_BRANCH_NODE>::init_costs()
     {
@@ -669,6 +676,49 @@ namespace LPMP {
         return m;
     }
 
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_base<BDD_VARIABLE, BDD_BRANCH_NODE>::compute_min_marginals(const std::size_t var, std::vector<std::array<double,2>>& min_marginals) const
+    {
+        assert(var < this->nr_variables());
+        min_marginals.resize(this->nr_bdds(var));
+        if(this->nr_bdds(var) == 0)
+            return;
+
+        const std::size_t first = this->bdd_variables_(var,0).first_node_index;
+        const std::size_t last = this->bdd_variables_[var].back().last_node_index;
+
+        // per node candidate values. Thread local, since the parallel solver processes intervals concurrently.
+        thread_local std::vector<double> low_m;
+        thread_local std::vector<double> high_m;
+        if(low_m.size() < last - first) {
+            low_m.resize(last - first);
+            high_m.resize(last - first);
+        }
+
+        // gather, the only pointer chasing part
+        for(std::size_t i=first; i<last; ++i) {
+            const auto [m0,m1] = this->bdd_branch_nodes_[i].min_marginal();
+            low_m[i-first] = m0;
+            high_m[i-first] = m1;
+        }
+
+        const double* low = low_m.data();
+        const double* high = high_m.data();
+        for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index) {
+            const auto& bdd_var = this->bdd_variables_(var,bdd_index);
+            double m0 = std::numeric_limits<double>::infinity();
+            double m1 = std::numeric_limits<double>::infinity();
+#pragma omp simd reduction(min:m0,m1)
+            for(std::size_t i=bdd_var.first_node_index-first; i<bdd_var.last_node_index-first; ++i) {
+                m0 = std::min(m0, low[i]);
+                m1 = std::min(m1, high[i]);
+            }
+            assert(std::isfinite(m0));
+            assert(std::isfinite(m1));
+            min_marginals[bdd_index] = {m0, m1};
+        }
+    }
+
     template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
     void bdd_mma_base<BDD_VARIABLE, BDD_BRANCH_NODE>::set_marginal(const std::size_t var, const std::size_t bdd_index, const std::array<double,2> marginals, const std::array<double,2> min_marginals)
     {
@@ -893,11 +943,9 @@ namespace LPMP {
     {
         //std::cout << "variable " << var << " of " << this->nr_variables() << std::endl;
         // collect min marginals
-        min_marginals.clear();
-        for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index) {
+        for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index)
             this->forward_step(var,bdd_index);
-            min_marginals.push_back(min_marginal(var,bdd_index)); 
-        }
+        compute_min_marginals(var, min_marginals);
 
         const std::array<double,2> average_marginal = average_marginals(min_marginals.begin(), min_marginals.end());
 
@@ -940,12 +988,9 @@ namespace LPMP {
         for(std::size_t var=0; var<this->nr_variables(); ++var) {
 
             // collect min marginals
-            min_marginals.clear();
-            for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index) {
+            for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index)
                 this->forward_step(var,bdd_index);
-                min_marginals.push_back(min_marginal(var,bdd_index));
-            }
-
+            compute_min_marginals(var, min_marginals);
 
             const auto average_marginal = average_marginals_forward_SRMP(min_marginals.begin(), min_marginals.end(), var);
             const std::array<double,2> avg_marg = average_marginal.first;
@@ -963,10 +1008,7 @@ namespace LPMP {
     {
         //std::cout << "variable " << var << " of " << this->nr_variables() << std::endl;
         // collect min marginals
-        min_marginals.clear();
-        for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index) {
-            min_marginals.push_back(min_marginal(var,bdd_index)); 
-        }
+        compute_min_marginals(var, min_marginals);
 
         const std::array<double,2> average_marginal = average_marginals(min_marginals.begin(), min_marginals.end());
 
@@ -1025,10 +1067,7 @@ namespace LPMP {
         for(long int var=this->nr_variables()-1; var>=0; --var) {
 
             // collect min marginals
-            min_marginals.clear();
-            for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index) {
-                min_marginals.push_back(min_marginal(var,bdd_index)); 
-            }
+            compute_min_marginals(var, min_marginals);
 
             const auto average_marginal = average_marginals_backward_SRMP(min_marginals.begin(), min_marginals.end(), var);
             const std::array<double,2> avg_marg = average_marginal.first;
@@ -0,0 +1,419 @@
+#pragma once
+
+#include "bdd_min_marginal_averaging.h"
+#include "tclap/CmdLine.h"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <thread>
+#include <cassert>
+
+namespace LPMP {
+
+    ////////////////////////////////////////////////////
+    // Parallel Min-Marginal Averaging Solver
+    ////////////////////////////////////////////////////
+
+    // Variables are partitioned into consecutive intervals with roughly equal numbers of BDD nodes.
+    // Forward and backward min-marginal averaging passes run on all intervals concurrently.
+    // For the passes, arcs of BDDs crossing interval boundaries are split: nodes read duplicates of their neighbours in other intervals.
+    // Duplicates are reconciled with the nodes they stand for after each pass, i.e. messages across intervals are delayed by one iteration.
+    // Costs are only reparametrized, hence the lower bound, which is recomputed exactly, stays valid.
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    class bdd_mma_parallel_base : public bdd_mma_base<BDD_VARIABLE, BDD_BRANCH_NODE>
+    {
+    public:
+        bdd_mma_parallel_base(TCLAP::CmdLine& cmd);
+        bdd_mma_parallel_base(const bdd_mma_parallel_base &) = delete; // no copy constructor because of pointers in bdd_branch_node
+
+        void init();
+
+        double compute_lower_bound();
+        void iteration();
+
+        std::size_t nr_intervals() const { return interval_boundaries_.size()-1; }
+
+    private:
+        struct split_node {
+            std::size_t original; // index of node in bdd_branch_nodes_
+            std::size_t duplicate; // index of its duplicate in bdd_branch_nodes_
+        };
+
+        void init_split_nodes();
+        void split_arcs();
+        void join_arcs();
+        std::size_t interval_of_node(const BDD_BRANCH_NODE* bdd) const;
+        BDD_BRANCH_NODE* forward_duplicate(const BDD_BRANCH_NODE* bdd);
+        BDD_BRANCH_NODE* backward_duplicate(const BDD_BRANCH_NODE* bdd);
+
+        void forward_run_exact();
+        void min_marginal_averaging_forward(const std::size_t interval);
+        void min_marginal_averaging_backward(const std::size_t interval);
+        void reconcile_forward_split_nodes();
+
+        std::vector<std::size_t> interval_boundaries_; // first variable of each interval
+        std::vector<std::size_t> interval_node_begin_; // first bdd branch node of each interval
+        // duplicates of nodes with arcs into later intervals, read by forward steps there. Sorted by original and by duplicate.
+        std::vector<split_node> forward_split_nodes_;
+        std::vector<double> forward_split_node_costs_;
+        // duplicates of nodes with arcs from earlier intervals, read by backward steps and min-marginals there. Sorted by original and by duplicate.
+        std::vector<split_node> backward_split_nodes_;
+        std::vector<BDD_VARIABLE*> first_bdd_variables_;
+        std::vector<BDD_VARIABLE*> last_bdd_variables_;
+        int nr_threads_ = 1;
+
+        TCLAP::ValueArg<int> nr_threads_arg_;
+        TCLAP::ValueArg<int> nr_intervals_arg_;
+    };
+
+    typedef bdd_mma_parallel_base<bdd_variable_mma, bdd_branch_node_opt> bdd_min_marginal_averaging_parallel;
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::bdd_mma_parallel_base(TCLAP::CmdLine& cmd)
+        : bdd_mma_base<BDD_VARIABLE, BDD_BRANCH_NODE>(cmd),
+        nr_threads_arg_("","threads","number of threads, 0 for all hardware threads",false,0,"int", cmd),
+        nr_intervals_arg_("","intervals","number of variable intervals processed concurrently, 0 for number of threads",false,0,"int", cmd)
+    {}
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::init()
+    {
+        bdd_mma_base<BDD_VARIABLE, BDD_BRANCH_NODE>::init();
+
+        nr_threads_ = nr_threads_arg_.getValue() > 0 ? nr_threads_arg_.getValue() : std::max(1u, std::thread::hardware_concurrency());
+        const std::size_t nr_intervals = nr_intervals_arg_.getValue() > 0 ? nr_intervals_arg_.getValue() : nr_threads_;
+        this->bdd_storage_.compute_intervals(nr_intervals);
+        interval_boundaries_.clear();
+        for(std::size_t i=0; i<=this->bdd_storage_.nr_intervals(); ++i)
+            interval_boundaries_.push_back(this->bdd_storage_.interval_boundary(i));
+
+        init_split_nodes();
+
+        first_bdd_variables_.clear();
+        last_bdd_variables_.clear();
+        for(std::size_t var=0; var<this->nr_variables(); ++var) {
+            for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index) {
+                if(this->first_variable_of_bdd(var, bdd_index))
+                    first_bdd_variables_.push_back(&this->bdd_variables_(var, bdd_index));
+                if(this->last_variable_of_bdd(var, bdd_index))
+                    last_bdd_variables_.push_back(&this->bdd_variables_(var, bdd_index));
+            }
+        }
+
+        // duplicates need forward values before the first iteration, other nodes backward ones
+        forward_run_exact();
+        reconcile_forward_split_nodes();
+        compute_lower_bound();
+    }
+
+    // Insert a region of duplicates between the nodes of consecutive intervals.
+    // The region after interval i holds forward duplicates of nodes in interval i and backward duplicates of nodes in interval i+1.
+    // Hence duplicates preserve the address order of bdd branch nodes along arcs.
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::init_split_nodes()
+    {
+        const std::size_t nr_intervals = this->nr_intervals();
+        interval_node_begin_.clear();
+        for(std::size_t i=0; i<nr_intervals; ++i) {
+            assert(this->nr_bdds(interval_boundaries_[i]) > 0);
+            interval_node_begin_.push_back(this->bdd_variables_(interval_boundaries_[i], 0).first_node_index);
+        }
+        interval_node_begin_.push_back(this->bdd_branch_nodes_.size());
+
+        auto interval_of_index = [&](const std::size_t i) -> std::size_t {
+            return std::distance(interval_node_begin_.begin(), std::upper_bound(interval_node_begin_.begin(), interval_node_begin_.end(), i)) - 1;
+        };
+        auto foreign = [&](const BDD_BRANCH_NODE* bdd, const std::size_t interval) {
+            return !BDD_BRANCH_NODE::is_terminal(const_cast<BDD_BRANCH_NODE*>(bdd)) && interval_of_index(this->bdd_branch_node_index(bdd)) != interval;
+        };
+
+        // determine split nodes and the number of duplicates in each region
+        std::vector<char> has_forward_split(this->bdd_branch_nodes_.size(), 0);
+        std::vector<char> has_backward_split(this->bdd_branch_nodes_.size(), 0);
+        for(std::size_t i=0; i<this->bdd_branch_nodes_.size(); ++i) {
+            const auto& bdd = this->bdd_branch_nodes_[i];
+            const std::size_t interval = interval_of_index(i);
+            if(foreign(bdd.low_outgoing, interval)) {
+                has_forward_split[i] = 1;
+                has_backward_split[this->bdd_branch_node_index(bdd.low_outgoing)] = 1;
+            }
+            if(foreign(bdd.high_outgoing, interval)) {
+                has_forward_split[i] = 1;
+                has_backward_split[this->bdd_branch_node_index(bdd.high_outgoing)] = 1;
+            }
+        }
+
+        std::vector<std::size_t> region_size(nr_intervals, 0);
+        for(std::size_t i=0; i<this->bdd_branch_nodes_.size(); ++i) {
+            if(has_forward_split[i])
+                ++region_size[interval_of_index(i)];
+            if(has_backward_split[i]) {
+                assert(interval_of_index(i) > 0);
+                ++region_size[interval_of_index(i)-1];
+            }
+        }
+
+        // offset[i] = number of duplicates placed before nodes of interval i
+        std::vector<std::size_t> offset(nr_intervals, 0);
+        for(std::size_t i=1; i<nr_intervals; ++i)
+            offset[i] = offset[i-1] + region_size[i-1];
+        const std::size_t nr_duplicates = offset.back() + region_size.back();
+
+        // copy nodes to their new position and relocate all pointers
+        std::vector<BDD_BRANCH_NODE> bdd_branch_nodes(this->bdd_branch_nodes_.size() + nr_duplicates);
+        auto new_index = [&](const std::size_t i) { return i + offset[interval_of_index(i)]; };
+        auto relocate = [&](BDD_BRANCH_NODE* p) -> BDD_BRANCH_NODE* {
+            if(p == nullptr || BDD_BRANCH_NODE::is_terminal(p))
+                return p;
+            return &bdd_branch_nodes[new_index(this->bdd_branch_node_index(p))];
+        };
+        for(std::size_t i=0; i<this->bdd_branch_nodes_.size(); ++i) {
+            BDD_BRANCH_NODE& bdd = bdd_branch_nodes[new_index(i)];
+            bdd = this->bdd_branch_nodes_[i];
+            bdd.low_outgoing = relocate(bdd.low_outgoing);
+            bdd.high_outgoing = relocate(bdd.high_outgoing);
+            bdd.first_low_incoming = relocate(bdd.first_low_incoming);
+            bdd.first_high_incoming = relocate(bdd.first_high_incoming);
+            bdd.next_low_incoming = relocate(bdd.next_low_incoming);
+            bdd.next_high_incoming = relocate(bdd.next_high_incoming);
+        }
+
+        for(std::size_t var=0; var<this->nr_variables(); ++var) {
+            for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index) {
+                auto& bdd_var = this->bdd_variables_(var, bdd_index);
+                const std::size_t o = offset[interval_of_index(bdd_var.first_node_index)];
+                bdd_var.first_node_index += o;
+                bdd_var.last_node_index += o;
+            }
+        }
+
+        // fill regions: forward duplicates of interval i come first, then backward duplicates of interval i+1
+        forward_split_nodes_.clear();
+        backward_split_nodes_.clear();
+        std::vector<std::size_t> region_fill(nr_intervals, 0);
+        for(std::size_t i=0; i<this->bdd_branch_nodes_.size(); ++i) {
+            if(has_forward_split[i]) {
+                const std::size_t interval = interval_of_index(i);
+                const std::size_t d = interval_node_begin_[interval+1] + offset[interval] + region_fill[interval]++;
+                forward_split_nodes_.push_back({new_index(i), d});
+            }
+        }
+        for(std::size_t i=0; i<this->bdd_branch_nodes_.size(); ++i) {
+            if(has_backward_split[i]) {
+                const std::size_t interval = interval_of_index(i)-1;
+                const std::size_t d = interval_node_begin_[interval+1] + offset[interval] + region_fill[interval]++;
+                backward_split_nodes_.push_back({new_index(i), d});
+            }
+        }
+        assert(std::equal(region_fill.begin(), region_fill.end(), region_size.begin()));
+
+        for(std::size_t i=0; i<nr_intervals; ++i)
+            interval_node_begin_[i] += offset[i];
+        interval_node_begin_.back() = bdd_branch_nodes.size();
+
+        this->bdd_branch_nodes_.swap(bdd_branch_nodes);
+
+        // forward duplicates keep the arcs into other intervals, so that incoming lists there stay consistent. Costs are copied, since they change during passes.
+        forward_split_node_costs_.clear();
+        forward_split_node_costs_.resize(forward_split_nodes_.size(), 0.0);
+        for(std::size_t j=0; j<forward_split_nodes_.size(); ++j) {
+            const auto& bdd = this->bdd_branch_nodes_[forward_split_nodes_[j].original];
+            auto& dup = this->bdd_branch_nodes_[forward_split_nodes_[j].duplicate];
+            const std::size_t interval = interval_of_node(&bdd);
+            dup.low_outgoing = foreign(bdd.low_outgoing, interval) ? bdd.low_outgoing : BDD_BRANCH_NODE::terminal_0();
+            dup.high_outgoing = foreign(bdd.high_outgoing, interval) ? bdd.high_outgoing : BDD_BRANCH_NODE::terminal_0();
+            dup.variable_cost = &forward_split_node_costs_[j];
+        }
+
+        // backward duplicates are never stepped, only their value is read
+        for(const auto [original, duplicate] : backward_split_nodes_) {
+            auto& dup = this->bdd_branch_nodes_[duplicate];
+            dup.low_outgoing = BDD_BRANCH_NODE::terminal_1();
+            dup.high_outgoing = BDD_BRANCH_NODE::terminal_1();
+            dup.variable_cost = this->bdd_branch_nodes_[original].variable_cost;
+        }
+    }
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    std::size_t bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::interval_of_node(const BDD_BRANCH_NODE* bdd) const
+    {
+        const std::size_t i = this->bdd_branch_node_index(bdd);
+        return std::distance(interval_node_begin_.begin(), std::upper_bound(interval_node_begin_.begin(), interval_node_begin_.end(), i)) - 1;
+    }
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    BDD_BRANCH_NODE* bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::forward_duplicate(const BDD_BRANCH_NODE* bdd)
+    {
+        const std::size_t i = this->bdd_branch_node_index(bdd);
+        auto it = std::lower_bound(forward_split_nodes_.begin(), forward_split_nodes_.end(), i, [](const split_node& s, const std::size_t i) { return s.original < i; });
+        assert(it != forward_split_nodes_.end() && it->original == i);
+        return &this->bdd_branch_nodes_[it->duplicate];
+    }
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    BDD_BRANCH_NODE* bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::backward_duplicate(const BDD_BRANCH_NODE* bdd)
+    {
+        const std::size_t i = this->bdd_branch_node_index(bdd);
+        auto it = std::lower_bound(backward_split_nodes_.begin(), backward_split_nodes_.end(), i, [](const split_node& s, const std::size_t i) { return s.original < i; });
+        assert(it != backward_split_nodes_.end() && it->original == i);
+        return &this->bdd_branch_nodes_[it->duplicate];
+    }
+
+    // Redirect arcs crossing interval boundaries to duplicates. Backward duplicates receive the current backward values.
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::split_arcs()
+    {
+        auto split_incoming = [&](BDD_BRANCH_NODE* bdd, BDD_BRANCH_NODE* bdd_dup, BDD_BRANCH_NODE* BDD_BRANCH_NODE::* first_incoming, BDD_BRANCH_NODE* BDD_BRANCH_NODE::* next_incoming, BDD_BRANCH_NODE* BDD_BRANCH_NODE::* outgoing) {
+            const std::size_t interval = interval_of_node(bdd);
+            BDD_BRANCH_NODE** link = &(bdd->*first_incoming);
+            while(*link != nullptr) {
+                BDD_BRANCH_NODE* cur = *link;
+                if(interval_of_node(cur) != interval) {
+                    BDD_BRANCH_NODE* cur_dup = forward_duplicate(cur);
+                    cur_dup->*next_incoming = cur->*next_incoming;
+                    cur->*outgoing = bdd_dup;
+                    *link = cur_dup;
+                    link = &(cur_dup->*next_incoming);
+                } else {
+                    link = &(cur->*next_incoming);
+                }
+            }
+        };
+
+#pragma omp parallel for schedule(static) num_threads(nr_threads_)
+        for(std::size_t j=0; j<backward_split_nodes_.size(); ++j) {
+            BDD_BRANCH_NODE* bdd = &this->bdd_branch_nodes_[backward_split_nodes_[j].original];
+            BDD_BRANCH_NODE* bdd_dup = &this->bdd_branch_nodes_[backward_split_nodes_[j].duplicate];
+            bdd_dup->m = bdd->m;
+            split_incoming(bdd, bdd_dup, &BDD_BRANCH_NODE::first_low_incoming, &BDD_BRANCH_NODE::next_low_incoming, &BDD_BRANCH_NODE::low_outgoing);
+            split_incoming(bdd, bdd_dup, &BDD_BRANCH_NODE::first_high_incoming, &BDD_BRANCH_NODE::next_high_incoming, &BDD_BRANCH_NODE::high_outgoing);
+        }
+    }
+
+    // Undo split_arcs, afterwards the BDDs are the original ones again.
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::join_arcs()
+    {
+        auto join_incoming = [&](BDD_BRANCH_NODE* bdd, BDD_BRANCH_NODE* BDD_BRANCH_NODE::* first_incoming, BDD_BRANCH_NODE* BDD_BRANCH_NODE::* next_incoming, BDD_BRANCH_NODE* BDD_BRANCH_NODE::* outgoing) {
+            BDD_BRANCH_NODE** link = &(bdd->*first_incoming);
+            while(*link != nullptr) {
+                BDD_BRANCH_NODE* cur = *link;
+                const std::size_t i = this->bdd_branch_node_index(cur);
+                auto it = std::lower_bound(forward_split_nodes_.begin(), forward_split_nodes_.end(), i, [](const split_node& s, const std::size_t i) { return s.duplicate < i; });
+                if(it != forward_split_nodes_.end() && it->duplicate == i) {
+                    BDD_BRANCH_NODE* cur_orig = &this->bdd_branch_nodes_[it->original];
+                    cur_orig->*next_incoming = cur->*next_incoming;
+                    cur_orig->*outgoing = bdd;
+                    *link = cur_orig;
+                    link = &(cur_orig->*next_incoming);
+                } else {
+                    link = &(cur->*next_incoming);
+                }
+            }
+        };
+
+#pragma omp parallel for schedule(static) num_threads(nr_threads_)
+        for(std::size_t j=0; j<backward_split_nodes_.size(); ++j) {
+            BDD_BRANCH_NODE* bdd = &this->bdd_branch_nodes_[backward_split_nodes_[j].original];
+            join_incoming(bdd, &BDD_BRANCH_NODE::first_low_incoming, &BDD_BRANCH_NODE::next_low_incoming, &BDD_BRANCH_NODE::low_outgoing);
+            join_incoming(bdd, &BDD_BRANCH_NODE::first_high_incoming, &BDD_BRANCH_NODE::next_high_incoming, &BDD_BRANCH_NODE::high_outgoing);
+        }
+    }
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::reconcile_forward_split_nodes()
+    {
+#pragma omp parallel for schedule(static) num_threads(nr_threads_)
+        for(std::size_t j=0; j<forward_split_nodes_.size(); ++j) {
+            const auto& bdd = this->bdd_branch_nodes_[forward_split_nodes_[j].original];
+            this->bdd_branch_nodes_[forward_split_nodes_[j].duplicate].m = bdd.m;
+            forward_split_node_costs_[j] = *bdd.variable_cost;
+        }
+    }
+
+    // BDDs are independent of each other, hence shortest paths can be computed for all of them in parallel
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::forward_run_exact()
+    {
+#pragma omp parallel for schedule(dynamic, 64) num_threads(nr_threads_)
+        for(std::size_t b=0; b<first_bdd_variables_.size(); ++b)
+            for(const BDD_VARIABLE* bdd_var = first_bdd_variables_[b]; bdd_var != nullptr; bdd_var = bdd_var->next)
+                for(std::size_t i=bdd_var->first_node_index; i<bdd_var->last_node_index; ++i)
+                    this->bdd_branch_nodes_[i].forward_step();
+    }
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    double bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::compute_lower_bound()
+    {
+        double lb = 0.0;
+#pragma omp parallel for schedule(dynamic, 64) num_threads(nr_threads_) reduction(+:lb)
+        for(std::size_t b=0; b<last_bdd_variables_.size(); ++b) {
+            const BDD_VARIABLE* bdd_var = last_bdd_variables_[b];
+            for(; bdd_var->prev != nullptr; bdd_var = bdd_var->prev)
+                for(std::ptrdiff_t i=std::ptrdiff_t(bdd_var->last_node_index)-1; i>=std::ptrdiff_t(bdd_var->first_node_index); --i)
+                    this->bdd_branch_nodes_[i].backward_step();
+            assert(bdd_var->nr_bdd_nodes() == 1);
+            auto& root = this->bdd_branch_nodes_[bdd_var->first_node_index];
+            root.backward_step();
+            lb += root.m;
+        }
+        this->lower_bound_ = lb;
+        return lb;
+    }
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::min_marginal_averaging_forward(const std::size_t interval)
+    {
+        std::vector<std::array<double,2>> min_marginals;
+        for(std::size_t var=interval_boundaries_[interval]; var<interval_boundaries_[interval+1]; ++var) {
+            if(this->options.averaging_type == bdd_min_marginal_averaging_options::averaging_type::classic) {
+                this->min_marginal_averaging_step_forward(var, min_marginals);
+            } else {
+                for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index)
+                    this->forward_step(var,bdd_index);
+                this->compute_min_marginals(var, min_marginals);
+                const auto [average_marginal, default_averaging] = this->average_marginals_forward_SRMP(min_marginals.begin(), min_marginals.end(), var);
+                for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index)
+                    this->set_marginal_forward_SRMP(var, bdd_index, average_marginal, min_marginals[bdd_index], default_averaging);
+            }
+        }
+    }
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::min_marginal_averaging_backward(const std::size_t interval)
+    {
+        std::vector<std::array<double,2>> min_marginals;
+        for(std::ptrdiff_t var=std::ptrdiff_t(interval_boundaries_[interval+1])-1; var>=std::ptrdiff_t(interval_boundaries_[interval]); --var) {
+            if(this->options.averaging_type == bdd_min_marginal_averaging_options::averaging_type::classic) {
+                this->min_marginal_averaging_step_backward(var, min_marginals);
+            } else {
+                this->compute_min_marginals(var, min_marginals);
+                const auto [average_marginal, default_averaging] = this->average_marginals_backward_SRMP(min_marginals.begin(), min_marginals.end(), var);
+                for(std::size_t bdd_index=0; bdd_index<this->nr_bdds(var); ++bdd_index) {
+                    this->set_marginal_backward_SRMP(var, bdd_index, average_marginal, min_marginals[bdd_index], default_averaging);
+                    this->backward_step(var, bdd_index);
+                }
+            }
+        }
+    }
+
+    template<typename BDD_VARIABLE, typename BDD_BRANCH_NODE>
+    void bdd_mma_parallel_base<BDD_VARIABLE, BDD_BRANCH_NODE>::iteration()
+    {
+        split_arcs();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nr_threads_)
+        for(std::size_t i=0; i<nr_intervals(); ++i)
+            min_marginal_averaging_forward(i);
+
+        reconcile_forward_split_nodes();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nr_threads_)
+        for(std::size_t i=0; i<nr_intervals(); ++i)
+            min_marginal_averaging_backward(i);
+
+        join_arcs();
+        compute_lower_bound();
+    }
+
+}
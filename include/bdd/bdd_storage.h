@@ -12,6 +12,9 @@
 #include <unordered_set>
 #include <stack>
 #include <numeric>
+#include <memory>
+#include <thread>
+#include <exception>
 
 namespace LPMP {
 
@@ -23,7 +26,7 @@ namespace LPMP {
             constexpr static std::size_t terminal_0 = std::numeric_limits<std::size_t>::max()-1;
             constexpr static std::size_t terminal_1 = std::numeric_limits<std::size_t>::max();
             bool low_is_terminal() const { return low == terminal_0 || low == terminal_1; }
-            bool high_is_terminal() const { return low == terminal_0 || low == terminal_1; }
+            bool high_is_terminal() const { return high == terminal_0 || high == terminal_1; }
 
             std::size_t low;
             std::size_t high;
@@ -55,6 +58,13 @@ namespace LPMP {
         // return all edges with endpoints being variables that are consecutive in some BDD
         std::vector<std::array<size_t,2>> dependency_graph() const;
 
+        // for BDD decomposition: partition variables into at most nr_intervals consecutive intervals with roughly equal numbers of BDD nodes
+        void compute_intervals(const size_t nr_intervals);
+        size_t interval(const size_t variable) const;
+        size_t nr_intervals() const;
+        // first variable of interval, interval_boundary(nr_intervals()) == nr_variables()
+        size_t interval_boundary(const size_t interval) const;
+
     private:
         void check_node_valid(const bdd_node bdd) const;
 
@@ -78,17 +88,16 @@ namespace LPMP {
         // for BDD decomposition //
         std::vector<size_t> interval_boundaries;
         std::vector<size_t> intervals;
-        void compute_intervals(const size_t nr_intervals);
-        size_t interval(const size_t variable) const;
-        size_t nr_intervals() const;
         std::tuple<two_dim_variable_array<bdd_storage::bdd_node>, two_dim_variable_array<size_t>> split_bdd_nodes(const size_t nr_intervals);
 
         TCLAP::MultiArg<std::string> preprocessing_arg;
+        TCLAP::ValueArg<int> construction_threads_arg;
     };
 
 
     bdd_storage::bdd_storage(TCLAP::CmdLine& cmd)
-        : preprocessing_arg("","bdd_preprocessing","preprocess BDDs",false,"{none|bridge|subsumption|subsumption_except_one|contiguous_overlap|partial_contiguous_overlap|cliques}", cmd)
+        : preprocessing_arg("","bdd_preprocessing","preprocess BDDs",false,"{none|bridge|subsumption|subsumption_except_one|contiguous_overlap|partial_contiguous_overlap|cliques}", cmd),
+        construction_threads_arg("","bdd_construction_threads","number of threads for converting constraints to BDDs, 0 for all hardware threads",false,0,"int", cmd)
     {}
 
     template<typename BDD_VARIABLES_ITERATOR>
@@ -242,31 +251,57 @@ namespace LPMP {
 
     void bdd_storage::init(const ILP_input& input)
     {
-        BDD::bdd_mgr bdd_mgr;
-
         bdd_preprocessor bdd_pre;
         const bool preprocess = preprocessing_arg.getValue().size() > 0;
 
-        // first transform linear inequalities into BDDs
-        std::vector<int> coefficients;
+        // first transform linear inequalities into BDDs.
+        // Constraints are split into contiguous chunks, each converted by its own thread with its own bdd manager and converter caches.
+        const std::size_t nr_threads = construction_threads_arg.getValue() > 0 ? construction_threads_arg.getValue() : std::max(1u, std::thread::hardware_concurrency());
+        const std::size_t nr_chunks = std::max(std::size_t(1), std::min(nr_threads, input.nr_constraints()));
+        std::vector<std::unique_ptr<BDD::bdd_mgr>> bdd_mgrs;
+        for(std::size_t c=0; c<nr_chunks; ++c)
+            bdd_mgrs.push_back(std::make_unique<BDD::bdd_mgr>());
+        std::vector<std::vector<BDD::node_ref>> bdds(nr_chunks);
+        auto chunk_begin = [&](const std::size_t c) { return c * input.nr_constraints() / nr_chunks; };
+        // exceptions must not leave the parallel region, they are rethrown afterwards
+        std::vector<std::exception_ptr> errors(nr_chunks);
+
+#pragma omp parallel for schedule(static) num_threads(nr_chunks)
+        for(std::size_t c=0; c<nr_chunks; ++c) {
+            try {
+                bdd_converter converter(*bdd_mgrs[c]);
+                std::vector<int> coefficients;
+                bdds[c].reserve(chunk_begin(c+1) - chunk_begin(c));
+                for(std::size_t i=chunk_begin(c); i<chunk_begin(c+1); ++i) {
+                    const auto& constraint = input.constraints()[i];
+                    coefficients.clear();
+                    for(const auto e : constraint.variables)
+                        coefficients.push_back(e.coefficient);
+                    bdds[c].push_back(converter.convert_to_bdd(coefficients, constraint.ineq, constraint.right_hand_side));
+                }
+            } catch(...) {
+                errors[c] = std::current_exception();
+            }
+        }
+        for(const auto& error : errors)
+            if(error)
+                std::rethrow_exception(error);
+
+        // export in constraint order, independent of the number of threads
         std::vector<std::size_t> variables;
-        std::vector<BDD::node_ref> bdds;
-        bdd_converter converter(bdd_mgr);
-
-        for(const auto& constraint : input.constraints()) {
-            coefficients.clear();
-            variables.clear();
-            for(const auto e : constraint.variables) {
-                coefficients.push_back(e.coefficient);
-                variables.push_back(e.var);
+        for(std::size_t c=0; c<nr_chunks; ++c) {
+            for(std::size_t i=chunk_begin(c); i<chunk_begin(c+1); ++i) {
+                const auto& constraint = input.constraints()[i];
+                variables.clear();
+                for(const auto e : constraint.variables)
+                    variables.push_back(e.var);
+                assert(std::is_sorted(variables.begin(), variables.end()));
+
+                if(preprocess)
+                    bdd_pre.add_bdd(bdds[c][i - chunk_begin(c)], variables.begin(), variables.end());
+                else
+                    add_bdd(*bdd_mgrs[c], bdds[c][i - chunk_begin(c)], variables.begin(), variables.end());
             }
-            assert(std::is_sorted(variables.begin(), variables.end()));
-            
-            BDD::node_ref bdd = converter.convert_to_bdd(coefficients, constraint.ineq, constraint.right_hand_side);
-            if(preprocess)
-                bdd_pre.add_bdd(bdd, variables.begin(), variables.end());
-            else
-                add_bdd(bdd_mgr, bdd, variables.begin(), variables.end());
         }
 
         // second, preprocess BDDs
@@ -372,17 +407,24 @@ namespace LPMP {
 
     void bdd_storage::compute_intervals(const size_t nr_intervals)
     {
-        // first approach: Just partition variables equidistantly.
-        // TODO: Take into account number of BDD nodes in each interval
-        
-        assert(nr_intervals > 1);
+        assert(nr_intervals > 0);
+        std::vector<size_t> nr_nodes_per_variable(this->nr_variables(), 0);
+        for(const auto& bdd : bdd_nodes_)
+            ++nr_nodes_per_variable[bdd.variable];
+
+        // close an interval as soon as the nodes of all intervals so far exceed their share. Intervals are never empty, hence there may be fewer than nr_intervals.
         interval_boundaries.clear();
         interval_boundaries.reserve(nr_intervals+1);
-        for(size_t interval=0; interval<nr_intervals; ++interval)
-            interval_boundaries.push_back(std::round(double(interval*this->nr_variables())/double(nr_intervals)));
-
+        interval_boundaries.push_back(0);
+        size_t nr_nodes = 0;
+        for(size_t var=0; var+1<this->nr_variables(); ++var)
+        {
+            nr_nodes += nr_nodes_per_variable[var];
+            if(interval_boundaries.size() < nr_intervals && nr_nodes * nr_intervals >= interval_boundaries.size() * bdd_nodes_.size())
+                interval_boundaries.push_back(var+1);
+        }
         interval_boundaries.push_back(this->nr_variables()); 
-        assert(interval_boundaries.size() == nr_intervals+1);
+        assert(interval_boundaries.size() <= nr_intervals+1);
 
         intervals.clear();
         intervals.reserve(this->nr_variables());
@@ -394,7 +436,7 @@ namespace LPMP {
     size_t bdd_storage::interval(const size_t variable) const
     {
         assert(variable < this->nr_variables());
-        assert(interval_boundaries.size() > 2 || interval_boundaries.size() == 0);
+        assert(interval_boundaries.size() >= 2 || interval_boundaries.size() == 0);
         if(interval_boundaries.size() == 0)
             return 0;
         assert(intervals.size() == this->nr_variables());
@@ -403,19 +445,27 @@ namespace LPMP {
 
     size_t bdd_storage::nr_intervals() const
     {
-        assert(interval_boundaries.size() > 2 || interval_boundaries.size() == 0);
+        assert(interval_boundaries.size() >= 2 || interval_boundaries.size() == 0);
         if(interval_boundaries.size() == 0)
             return 1;
         return interval_boundaries.size()-1;
     }
 
+    size_t bdd_storage::interval_boundary(const size_t interval) const
+    {
+        assert(interval <= nr_intervals());
+        if(interval_boundaries.size() == 0)
+            return interval == 0 ? 0 : this->nr_variables();
+        return interval_boundaries[interval];
+    }
+
     // take bdd_nodes_ and return two_dim_variable_array<bdd_node> bdd_nodes_split_, two_dim_variable_array<size_t> bdd_delimiters_split_
     std::tuple<two_dim_variable_array<bdd_storage::bdd_node>, two_dim_variable_array<size_t>> bdd_storage::split_bdd_nodes(const size_t nr_intervals)
     {
         compute_intervals(nr_intervals);
 
-        std::vector<size_t> nr_bdd_nodes_per_interval(nr_intervals(), 0);
-        std::vector<size_t> nr_bdds_per_inteval(nr_intervals(), 1);
+        std::vector<size_t> nr_bdd_nodes_per_interval(this->nr_intervals(), 0);
+        std::vector<size_t> nr_bdds_per_inteval(this->nr_intervals(), 1);
         std::unordered_set<size_t> active_intervals;
 
         for(size_t bdd_counter=0; bdd_counter<bdd_delimiters_.size()-1; ++bdd_counter)
@@ -545,14 +595,14 @@ namespace LPMP {
                         assert(split_bdd_node_indices.count({bdd.high, i}) > 0);
                         const size_t high_idx = split_bdd_node_indices.find({bdd.high, i})->second;
 
-                        split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd.variable, low_idx, high_idx};
+                        split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {low_idx, high_idx, bdd.variable};
                         split_bdd_node_indices.insert(std::make_pair(std::array<size_t,2>{bdd_node_counter, i}, nr_bdd_nodes_per_interval[i]));
                         ++nr_bdd_nodes_per_interval[i];
                     }
                     else // case (ii)
                     {
                         // in interval i, low and high arcs should point to topsink
-                        split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd.variable, bdd_node::terminal_1, bdd_node::terminal_1};
+                        split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd_node::terminal_1, bdd_node::terminal_1, bdd.variable};
                         split_bdd_node_indices.insert(std::make_pair(std::array<size_t,2>{bdd_node_counter, i}, nr_bdd_nodes_per_interval[i]));
                         ++nr_bdd_nodes_per_interval[i];
 
@@ -561,7 +611,7 @@ namespace LPMP {
                         assert(i < next_i);
                         const size_t next_lo_idx = split_bdd_node_indices.find({bdd.low, next_i})->second;
                         const size_t next_hi_idx = split_bdd_node_indices.find({bdd.high, next_i})->second;
-                        split_bdd_nodes(next_i, nr_bdd_nodes_per_interval[next_i]) = {bdd.variable, next_lo_idx, next_hi_idx};
+                        split_bdd_nodes(next_i, nr_bdd_nodes_per_interval[next_i]) = {next_lo_idx, next_hi_idx, bdd.variable};
                         split_bdd_node_indices.insert(std::make_pair(std::array<size_t,2>{bdd_node_counter, next_i}, nr_bdd_nodes_per_interval[next_i]));
                         ++nr_bdd_nodes_per_interval[next_i]; 
 
@@ -572,7 +622,7 @@ namespace LPMP {
                 {
                     assert(bdd.low == bdd_node::terminal_1 || bdd.high == bdd_node::terminal_1);
                     const size_t i = interval(bdd.variable);
-                    split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd.variable, bdd.low, bdd.high};
+                    split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd.low, bdd.high, bdd.variable};
                     split_bdd_node_indices.insert(std::make_pair(std::array<size_t,2>{bdd_node_counter, i}, nr_bdd_nodes_per_interval[i])); 
                     ++nr_bdd_nodes_per_interval[i]; 
                 }
@@ -586,20 +636,20 @@ namespace LPMP {
                         {
                             assert(split_bdd_node_indices.count({bdd.high,i}) > 0);
                             const size_t high_idx = split_bdd_node_indices.find({bdd.high,i})->second;
-                            split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd.variable, bdd_node::terminal_0, high_idx};
+                            split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd_node::terminal_0, high_idx, bdd.variable};
                             split_bdd_node_indices.insert(std::make_pair(std::array<size_t,2>{bdd_node_counter, i}, nr_bdd_nodes_per_interval[i])); 
                             ++nr_bdd_nodes_per_interval[i]; 
                         }
                         else // case (iv)
                         {
-                            split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd.variable, bdd_node::terminal_0, bdd_node::terminal_1};
+                            split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd_node::terminal_0, bdd_node::terminal_1, bdd.variable};
                             split_bdd_node_indices.insert(std::make_pair(std::array<size_t,2>{bdd_node_counter, i}, nr_bdd_nodes_per_interval[i])); 
                             ++nr_bdd_nodes_per_interval[i]; 
 
                             const size_t next_i = interval(high_var);
                             assert(split_bdd_node_indices.count({bdd.high, next_i}) > 0);
                             const size_t next_high_idx = split_bdd_node_indices.find({bdd.high, next_i})->second;
-                            split_bdd_nodes(next_i, nr_bdd_nodes_per_interval[next_i]) = {bdd.variable, bdd_node::terminal_0, next_high_idx};
+                            split_bdd_nodes(next_i, nr_bdd_nodes_per_interval[next_i]) = {bdd_node::terminal_0, next_high_idx, bdd.variable};
                             ++nr_bdd_nodes_per_interval[next_i]; 
 
                             duplicated_nodes.push_back({split_node{i, nr_bdd_nodes_per_interval[i]-1}, split_node{next_i, nr_bdd_nodes_per_interval[next_i]-1}});
@@ -612,21 +662,21 @@ namespace LPMP {
                         if(interval(bdd.variable) == interval(low_var)) // case (iii)
                         {
                             assert(split_bdd_node_indices.count({bdd.low,i}) > 0);
-                            const size_t low_idx = split_bdd_node_indices.find({bdd.high,i})->second;
-                            split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd.variable, low_idx, bdd_node::terminal_0};
+                            const size_t low_idx = split_bdd_node_indices.find({bdd.low,i})->second;
+                            split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {low_idx, bdd_node::terminal_0, bdd.variable};
                             split_bdd_node_indices.insert(std::make_pair(std::array<size_t,2>{bdd_node_counter, i}, nr_bdd_nodes_per_interval[i])); 
                             ++nr_bdd_nodes_per_interval[i]; 
                         }
                         else // case (iv)
                         {
-                            split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd.variable, bdd_node::terminal_1, bdd_node::terminal_0};
+                            split_bdd_nodes(i, nr_bdd_nodes_per_interval[i]) = {bdd_node::terminal_1, bdd_node::terminal_0, bdd.variable};
                             split_bdd_node_indices.insert(std::make_pair(std::array<size_t,2>{bdd_node_counter, i}, nr_bdd_nodes_per_interval[i])); 
                             ++nr_bdd_nodes_per_interval[i]; 
 
                             const size_t next_i = interval(low_var);
                             assert(split_bdd_node_indices.count({bdd.low, next_i}) > 0);
                             const size_t next_low_idx = split_bdd_node_indices.find({bdd.low, next_i})->second;
-                            split_bdd_nodes(next_i, nr_bdd_nodes_per_interval[next_i]) = {bdd.variable, next_low_idx, bdd_node::terminal_0};
+                            split_bdd_nodes(next_i, nr_bdd_nodes_per_interval[next_i]) = {next_low_idx, bdd_node::terminal_0, bdd.variable};
                             ++nr_bdd_nodes_per_interval[next_i]; 
 
                             duplicated_nodes.push_back({split_node{i, nr_bdd_nodes_per_interval[i]-1}, split_node{next_i, nr_bdd_nodes_per_interval[next_i]-1}});
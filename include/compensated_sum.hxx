@@ -0,0 +1,50 @@
+#ifndef LPMP_COMPENSATED_SUM_HXX
+#define LPMP_COMPENSATED_SUM_HXX
+
+#include <cmath>
+#include <type_traits>
+
+namespace LPMP {
+
+// Kahan-Babuska-Neumaier summation: keeps track of the rounding error of each addition in a separate compensation term.
+// Used for reductions over all factors (lower bound, primal cost), whose summands can be of very different magnitude, in particular when potentials are stored in single precision.
+template<typename T = double>
+class compensated_sum {
+   static_assert(std::is_floating_point<T>::value, "");
+public:
+   compensated_sum(const T init = 0.0) : sum_(init), c_(0.0) {}
+
+   compensated_sum& operator+=(const T x)
+   {
+      const T t = sum_ + x;
+      if(!std::isfinite(t)) { // compensation would become nan
+         sum_ = t;
+         return *this;
+      }
+      if(std::abs(sum_) >= std::abs(x)) {
+         c_ += (sum_ - t) + x;
+      } else {
+         c_ += (x - t) + sum_;
+      }
+      sum_ = t;
+      return *this;
+   }
+
+   compensated_sum& operator+=(const compensated_sum& o)
+   {
+      *this += o.sum_;
+      *this += o.c_;
+      return *this;
+   }
+
+   T value() const { return std::isfinite(sum_) ? sum_ + c_ : sum_; }
+   operator T() const { return value(); }
+
+private:
+   T sum_;
+   T c_;
+};
+
+} // namespace LPMP
+
+#endif // LPMP_COMPENSATED_SUM_HXX
@@ -18,14 +18,20 @@
 namespace LPMP {
 
    // data types for all floating point/integer operations 
-   // float is inaccurate for large problems and I observed oscillation. Possibly, some sort of numerical stabilization needs to be employed
-   //using REAL = float;
-   //constexpr std::size_t REAL_ALIGNMENT = 8;
-   //using REAL_VECTOR = simdpp::float32<REAL_ALIGNMENT>;
-
+   // float storage halves memory bandwidth of message passing, but summing up many float lower bounds is inaccurate for large problems and I observed oscillation.
+   // Hence all reductions over factors (lower bound, primal cost) accumulate in double with compensated summation, see compensated_sum.hxx.
+#ifdef LPMP_SINGLE_PRECISION
+   using REAL = float;
+   constexpr std::size_t REAL_ALIGNMENT = 8;
+   using REAL_VECTOR = simdpp::float32<REAL_ALIGNMENT>;
+#else
    using REAL = double;
    constexpr std::size_t REAL_ALIGNMENT = 4;
    using REAL_VECTOR = simdpp::float64<REAL_ALIGNMENT>;
+#endif
+   // vectors and matrices of float and double are both padded to multiples of REAL_ALIGNMENT, so simd code must pick the lane type from the stored type, not from REAL.
+   template<typename T>
+   using simd_vector = std::conditional_t<std::is_same<T,float>::value, simdpp::float32<REAL_ALIGNMENT>, simdpp::float64<REAL_ALIGNMENT>>;
 
    using INDEX = std::size_t;
    using UNSIGNED_INDEX = INDEX;
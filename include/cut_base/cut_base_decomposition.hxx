@@ -0,0 +1,212 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+#include "cut_base_instance.hxx"
+#include "union_find.hxx"
+
+namespace LPMP {
+
+    // splits a cut instance (multicut, max-cut) into its connected components. Components are independent subproblems.
+    // Nodes of each component are numbered consecutively. Nodes without edges belong to no component.
+    template<typename INSTANCE>
+        class cut_base_decomposition {
+            public:
+                cut_base_decomposition(const INSTANCE& instance);
+
+                std::size_t no_components() const { return components_.size(); }
+                const INSTANCE& component(const std::size_t c) const { assert(c < no_components()); return components_[c]; }
+
+                // edge labelings of the components are written to the corresponding edges of the original instance
+                cut_base_edge_labeling lift(const std::vector<cut_base_edge_labeling>& component_labelings) const;
+                // distinct components receive distinct labels, nodes without edges are singletons
+                cut_base_node_labeling lift(const std::vector<cut_base_node_labeling>& component_labelings) const;
+
+            private:
+                constexpr static std::size_t no_component = std::numeric_limits<std::size_t>::max();
+
+                std::vector<INSTANCE> components_;
+                std::vector<std::size_t> node_component_; // component of each original node
+                std::vector<std::size_t> component_node_; // index of each original node inside its component
+                std::vector<std::size_t> edge_component_; // component of each original edge
+                std::vector<std::size_t> component_edge_; // index of each original edge inside its component
+        };
+
+    // optimal node labeling by enumerating all partitions of the nodes into at most max_no_labels sets, i.e. max_no_labels = 2 for max-cut.
+    // Only viable for a handful of nodes.
+    template<typename INSTANCE>
+        cut_base_node_labeling enumerate_optimal_node_labeling(const INSTANCE& instance, const std::size_t max_no_labels);
+
+    struct decomposed_solution {
+        double lower_bound = 0.0;
+        double cost = 0.0;
+        cut_base_edge_labeling labeling;
+    };
+
+    // solve every component of the instance on its own. Components with at most max_enumeration_nodes nodes are solved exactly by enumeration,
+    // larger ones by an individual solver constructed from solver_options. Components are distributed over nr_threads threads, largest first.
+    // Lower bounds and labelings of components are merged into those of the original instance.
+    template<typename SOLVER, typename INSTANCE>
+        decomposed_solution solve_decomposed(const INSTANCE& instance, const std::vector<std::string>& solver_options, const int nr_threads, const std::size_t max_no_labels, const std::size_t max_enumeration_nodes = 8);
+
+    // implementation
+
+    template<typename INSTANCE>
+        cut_base_decomposition<INSTANCE>::cut_base_decomposition(const INSTANCE& instance)
+        {
+            union_find uf(instance.no_nodes());
+            for(const auto& e : instance.edges())
+                uf.merge(e[0], e[1]);
+
+            std::vector<std::size_t> component_of_root(instance.no_nodes(), no_component);
+            std::vector<char> has_edge(instance.no_nodes(), 0);
+            for(const auto& e : instance.edges())
+                has_edge[e[0]] = has_edge[e[1]] = 1;
+
+            node_component_.assign(instance.no_nodes(), no_component);
+            component_node_.assign(instance.no_nodes(), 0);
+            std::vector<std::size_t> component_size;
+            for(std::size_t i=0; i<instance.no_nodes(); ++i) {
+                if(!has_edge[i])
+                    continue;
+                const std::size_t r = uf.find(i);
+                if(component_of_root[r] == no_component) {
+                    component_of_root[r] = component_size.size();
+                    component_size.push_back(0);
+                }
+                node_component_[i] = component_of_root[r];
+                component_node_[i] = component_size[node_component_[i]]++;
+            }
+
+            components_.resize(component_size.size());
+            edge_component_.reserve(instance.no_edges());
+            component_edge_.reserve(instance.no_edges());
+            for(const auto& e : instance.edges()) {
+                const std::size_t c = node_component_[e[0]];
+                assert(c == node_component_[e[1]]);
+                edge_component_.push_back(c);
+                component_edge_.push_back(components_[c].no_edges());
+                components_[c].add_edge(component_node_[e[0]], component_node_[e[1]], e.cost);
+            }
+        }
+
+    template<typename INSTANCE>
+        cut_base_edge_labeling cut_base_decomposition<INSTANCE>::lift(const std::vector<cut_base_edge_labeling>& component_labelings) const
+        {
+            assert(component_labelings.size() == no_components());
+            cut_base_edge_labeling output;
+            output.reserve(edge_component_.size());
+            for(std::size_t e=0; e<edge_component_.size(); ++e) {
+                assert(component_labelings[edge_component_[e]].size() == components_[edge_component_[e]].no_edges());
+                output.push_back(component_labelings[edge_component_[e]][component_edge_[e]]);
+            }
+            return output;
+        }
+
+    template<typename INSTANCE>
+        cut_base_node_labeling cut_base_decomposition<INSTANCE>::lift(const std::vector<cut_base_node_labeling>& component_labelings) const
+        {
+            assert(component_labelings.size() == no_components());
+            std::vector<std::size_t> label_offset(no_components()+1, 0);
+            for(std::size_t c=0; c<no_components(); ++c) {
+                assert(component_labelings[c].size() == components_[c].no_nodes());
+                label_offset[c+1] = label_offset[c] + *std::max_element(component_labelings[c].begin(), component_labelings[c].end()) + 1;
+            }
+
+            cut_base_node_labeling output(node_component_.size());
+            std::size_t next_label = label_offset.back();
+            for(std::size_t i=0; i<node_component_.size(); ++i) {
+                const std::size_t c = node_component_[i];
+                output[i] = c != no_component ? label_offset[c] + component_labelings[c][component_node_[i]] : next_label++;
+            }
+            return output;
+        }
+
+    template<typename INSTANCE>
+        cut_base_node_labeling enumerate_optimal_node_labeling(const INSTANCE& instance, const std::size_t max_no_labels)
+        {
+            assert(max_no_labels >= 1);
+            const std::size_t n = instance.no_nodes();
+            cut_base_node_labeling labeling(n, 0);
+            cut_base_node_labeling best_labeling = labeling;
+            double best_cost = instance.evaluate(labeling);
+            if(n == 0)
+                return best_labeling;
+
+            // restricted growth strings: labeling[i] <= max(labeling[0..i-1]) + 1. no_labels[i] is the number of labels used by labeling[0..i]
+            std::vector<std::size_t> no_labels(n, 1);
+            while(true) {
+                std::size_t i = n-1;
+                while(i > 0 && (labeling[i] + 1 >= max_no_labels || labeling[i] + 1 > no_labels[i-1]))
+                    --i;
+                if(i == 0)
+                    break;
+                ++labeling[i];
+                no_labels[i] = std::max(no_labels[i-1], labeling[i]+1);
+                for(std::size_t j=i+1; j<n; ++j) {
+                    labeling[j] = 0;
+                    no_labels[j] = no_labels[i];
+                }
+
+                const double cost = instance.evaluate(labeling);
+                if(cost < best_cost) {
+                    best_cost = cost;
+                    best_labeling = labeling;
+                }
+            }
+            return best_labeling;
+        }
+
+    template<typename SOLVER, typename INSTANCE>
+        decomposed_solution solve_decomposed(const INSTANCE& instance, const std::vector<std::string>& solver_options, const int nr_threads, const std::size_t max_no_labels, const std::size_t max_enumeration_nodes)
+        {
+            const cut_base_decomposition<INSTANCE> decomposition(instance);
+            const std::size_t no_components = decomposition.no_components();
+
+            std::vector<std::size_t> order(no_components);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](const std::size_t c1, const std::size_t c2) {
+                    return decomposition.component(c1).no_edges() > decomposition.component(c2).no_edges();
+                    });
+
+            std::vector<double> lower_bounds(no_components, 0.0);
+            std::vector<cut_base_edge_labeling> labelings(no_components);
+            std::mutex construction_mutex; // solver construction parses command line options into global settings
+
+#pragma omp parallel for schedule(dynamic) num_threads(nr_threads)
+            for(std::size_t k=0; k<no_components; ++k) {
+                const std::size_t c = order[k];
+                const INSTANCE& component = decomposition.component(c);
+                if(component.no_nodes() <= max_enumeration_nodes) {
+                    const cut_base_node_labeling node_labeling = enumerate_optimal_node_labeling(component, max_no_labels);
+                    labelings[c] = cut_base_edge_labeling(component, node_labeling);
+                    lower_bounds[c] = component.evaluate(node_labeling);
+                } else {
+                    std::unique_ptr<SOLVER> solver;
+                    {
+                        std::lock_guard<std::mutex> lock(construction_mutex);
+                        solver = std::make_unique<SOLVER>(solver_options);
+                        solver->GetProblemConstructor().construct(component);
+                    }
+                    solver->Solve();
+                    lower_bounds[c] = solver->lower_bound();
+                    labelings[c].reserve(component.no_edges());
+                    for(const auto& e : component.edges())
+                        labelings[c].push_back(solver->GetProblemConstructor().get_edge_label(e[0], e[1]));
+                }
+            }
+
+            decomposed_solution output;
+            output.lower_bound = instance.constant() + std::accumulate(lower_bounds.begin(), lower_bounds.end(), 0.0);
+            output.labeling = decomposition.lift(labelings);
+            output.cost = instance.evaluate(output.labeling);
+            return output;
+        }
+
+} // namespace LPMP
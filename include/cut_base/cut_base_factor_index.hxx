@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <limits>
+#include <tsl/robin_map.h>
+
+namespace LPMP {
+
+    // open addressing index from sorted node tuples (edges, triplets) to positions in a contiguous factor vector.
+    // Node indices are packed into 32 bits each, hence instances may have at most 2^32-1 nodes.
+    template<std::size_t N>
+        class packed_node_tuple_index {
+            public:
+                static_assert(N == 2 || N == 3);
+                using key_type = std::array<uint32_t,N>;
+                constexpr static std::size_t not_found = std::numeric_limits<std::size_t>::max();
+
+                static key_type pack(const std::array<std::size_t,N>& nodes)
+                {
+                    key_type key;
+                    for(std::size_t i=0; i<N; ++i) {
+                        assert(nodes[i] < std::numeric_limits<uint32_t>::max());
+                        assert(i == 0 || nodes[i-1] < nodes[i]);
+                        key[i] = nodes[i];
+                    }
+                    return key;
+                }
+
+                void reserve(const std::size_t n) { index_.reserve(n); }
+                std::size_t size() const { return index_.size(); }
+                void clear() { index_.clear(); }
+
+                void insert(const std::array<std::size_t,N>& nodes, const std::size_t pos)
+                {
+                    [[maybe_unused]] const bool inserted = index_.insert({pack(nodes), pos}).second;
+                    assert(inserted);
+                }
+
+                // position of node tuple or not_found
+                std::size_t find(const std::array<std::size_t,N>& nodes) const
+                {
+                    const auto it = index_.find(pack(nodes));
+                    return it != index_.end() ? it->second : not_found;
+                }
+
+                bool contains(const std::array<std::size_t,N>& nodes) const { return find(nodes) != not_found; }
+
+            private:
+                // node tuples of sparse graphs have highly regular bit patterns. Mix them so that the power of two buckets of the robin map are evenly used.
+                static uint64_t mix(uint64_t x)
+                {
+                    x ^= x >> 33;
+                    x *= 0xff51afd7ed558ccdULL;
+                    x ^= x >> 33;
+                    x *= 0xc4ceb9fe1a85ec53ULL;
+                    x ^= x >> 33;
+                    return x;
+                }
+
+                struct key_hash {
+                    std::size_t operator()(const key_type& k) const
+                    {
+                        const uint64_t first = (uint64_t(k[0]) << 32) | uint64_t(k[1]);
+                        if constexpr(N == 2) {
+                            return mix(first);
+                        } else {
+                            return mix(first ^ mix(k[2]));
+                        }
+                    }
+                };
+
+                tsl::robin_map<key_type, std::size_t, key_hash> index_;
+        };
+
+} // namespace LPMP
@@ -2,8 +2,9 @@
 
 #include <array>
 #include <vector>
-#include <map> // TODO: change to unordered_map
+#include <map>
 #include "cut_base_apply_packing.hxx"
+#include "cut_base_factor_index.hxx"
 #include "LP.h"
 
 namespace LPMP {
@@ -30,8 +31,10 @@ namespace LPMP {
                     bool get_edge_label(const std::size_t i0, const std::size_t i1) const;
                     edge_factor* add_edge_factor(const std::size_t i1, const std::size_t i2, const double cost);
                     edge_factor* get_edge_factor(const std::size_t i1, const std::size_t i2) const;
-                    std::size_t number_of_edges() const { return edge_factors_.size(); }
-                    std::size_t number_of_triplets() const { return triplet_factors_.size(); }
+                    std::size_t number_of_edges() const { return unary_factors_vector_.size(); }
+                    std::size_t number_of_triplets() const { return triplet_factor_vector_.size(); }
+                    void reserve_edge_factors(const std::size_t n);
+                    void reserve_triplet_factors(const std::size_t n);
 
                     template<typename MESSAGE_CONTAINER>
                         MESSAGE_CONTAINER* link_unary_triplet_factor(edge_factor* u, triplet_factor* t);
@@ -41,6 +44,9 @@ namespace LPMP {
                     bool has_edge_factor(const std::size_t i1, const std::size_t i2) const;
                     bool has_triplet_factor(const std::size_t i1, const std::size_t i2, const std::size_t i3) const;
                     triplet_factor* get_triplet_factor(const std::size_t i1, const std::size_t i2, const std::size_t i3) const;
+                    // single lookup variants of has_*/get_*, return nullptr if factor is not present
+                    edge_factor* find_edge_factor(const std::size_t i1, const std::size_t i2) const;
+                    triplet_factor* find_triplet_factor(const std::size_t i1, const std::size_t i2, const std::size_t i3) const;
                     std::array<std::size_t,2> get_edge(const std::size_t i1, const std::size_t i2) const;
                     double get_edge_cost(const std::size_t i1, const std::size_t i2) const;
 
@@ -118,13 +124,14 @@ namespace LPMP {
                         const auto& triplet_factors() const { return triplet_factor_vector_; }
 
                 protected:
+                    // lexicographically sorted edges, only used for determining factor relations of newly added edges. Lookups go through edge_index_.
                     std::map<std::array<std::size_t,2>, edge_factor*> edge_factors_; // actually unary factors in multicut are defined on edges. assume first index < second one
                     std::size_t no_original_edges_ = std::numeric_limits<std::size_t>::max();
-                    //std::unordered_map<std::array<std::size_t,2>, edge_factor*> edge_factors_; // actually unary factors in multicut are defined on edges. assume first index < second one
-                    std::vector<std::pair<std::array<std::size_t,2>, edge_factor*>> unary_factors_vector_; // we store a second copy of unary factors for faster iterating
-                    // sort triplet factors as follows: Let indices be i=(i1,i2,i3) and j=(j1,j2,j3). Then i<j iff i1+i2+i3 < j1+j2+j3 or for ties sort lexicographically
-                    std::unordered_map<std::array<std::size_t,3>, triplet_factor*> triplet_factors_;
+                    std::vector<std::pair<std::array<std::size_t,2>, edge_factor*>> unary_factors_vector_;
+                    packed_node_tuple_index<2> edge_index_; // position in unary_factors_vector_
+                    // all triplet factors in one contiguous vector, indexed by their nodes
                     std::vector<std::pair<std::array<std::size_t,3>, triplet_factor*>> triplet_factor_vector_;
+                    packed_node_tuple_index<3> triplet_index_; // position in triplet_factor_vector_
                     std::size_t no_nodes_ = 0;
 
                     LP<FMC>* lp_;
@@ -153,6 +160,7 @@ namespace LPMP {
             auto* u = lp_->template add_factor<edge_factor>();
             (*u->get_factor())[0] = cost;
             auto it = edge_factors_.insert(std::make_pair(std::array<std::size_t,2>{i1,i2}, u)).first;
+            edge_index_.insert({i1,i2}, unary_factors_vector_.size());
             unary_factors_vector_.push_back(std::make_pair(std::array<std::size_t,2>{i1,i2}, u));
 
             if(it != edge_factors_.begin()) {
@@ -175,7 +183,29 @@ namespace LPMP {
         EDGE_FACTOR* cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::get_edge_factor(const std::size_t i1, const std::size_t i2) const
         {
             assert(has_edge_factor(i1,i2));
-            return edge_factors_.find(std::array<std::size_t,2>{i1,i2})->second;
+            return unary_factors_vector_[edge_index_.find({i1,i2})].second;
+        }
+
+    template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2>
+        EDGE_FACTOR* cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::find_edge_factor(const std::size_t i1, const std::size_t i2) const
+        {
+            assert(i1 < i2);
+            const std::size_t pos = edge_index_.find({i1,i2});
+            return pos != edge_index_.not_found ? unary_factors_vector_[pos].second : nullptr;
+        }
+
+    template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2>
+        void cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::reserve_edge_factors(const std::size_t n)
+        {
+            unary_factors_vector_.reserve(n);
+            edge_index_.reserve(n);
+        }
+
+    template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2>
+        void cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::reserve_triplet_factors(const std::size_t n)
+        {
+            triplet_factor_vector_.reserve(n);
+            triplet_index_.reserve(n);
         }
 
         template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2>
@@ -190,24 +220,22 @@ namespace LPMP {
         {
             assert(i1 < i2 && i2 < i3);
             assert(!has_triplet_factor(i1,i2,i3));
-            assert(triplet_factors_.size() == triplet_factor_vector_.size());
-            if(!has_edge_factor(i1,i2))
-                add_edge_factor(i1,i2,0.0);
-            if(!has_edge_factor(i1,i3))
-                add_edge_factor(i1,i3,0.0);
-            if(!has_edge_factor(i2,i3))
-                add_edge_factor(i2,i3,0.0);
+            assert(triplet_index_.size() == triplet_factor_vector_.size());
+            auto get_or_add_edge = [this](const std::size_t j1, const std::size_t j2) {
+                auto* e = find_edge_factor(j1,j2);
+                return e != nullptr ? e : add_edge_factor(j1,j2,0.0);
+            };
+            // use following ordering of unary and triplet factors: triplet comes after edge factor (i1,i2) and before (i2,i3)
+            auto* before = get_or_add_edge(i1,i2);
+            auto* middle = get_or_add_edge(i1,i3);
+            auto* after = get_or_add_edge(i2,i3);
             assert(has_edge_factor(i1,i2) && has_edge_factor(i1,i3) && has_edge_factor(i2,i3));
             auto* t = lp_->template add_factor<triplet_factor>();
             std::array<std::size_t,3> idx{i1,i2,i3};
-            triplet_factors_.insert(std::make_pair( idx, t ));
+            triplet_index_.insert(idx, triplet_factor_vector_.size());
             triplet_factor_vector_.push_back(std::make_pair(idx,t));
-            // use following ordering of unary and triplet factors: triplet comes after edge factor (i1,i2) and before (i2,i3)
-            auto* before = get_edge_factor(i1,i2);
             lp_->add_factor_relation(before,t);
-            auto* middle = get_edge_factor(i1,i3);
             lp_->add_factor_relation(middle,t);
-            auto* after = get_edge_factor(i2,i3);
             lp_->add_factor_relation(t,after);
             // link with all three unary factors
             link_unary_triplet_factor<edge_triplet_message_0>(before, t);
@@ -220,30 +248,36 @@ namespace LPMP {
         bool cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::has_edge_factor(const std::array<std::size_t,2> e) const 
         {
             return has_edge_factor(std::get<0>(e), std::get<1>(e));
-            assert(std::get<0>(e) < std::get<1>(e));
-            return edge_factors_.find(std::array<std::size_t,2>{std::get<0>(e),std::get<1>(e)}) != edge_factors_.end();
         }
 
     template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2> 
         bool cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::has_edge_factor(const std::size_t i1, const std::size_t i2) const 
         {
             assert(i1 < i2 && i2 < no_nodes_);
-            return (edge_factors_.find(std::array<std::size_t,2>{i1,i2}) != edge_factors_.end());
+            return edge_index_.contains({i1,i2});
         }
 
     template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2> 
         bool cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::has_triplet_factor(const std::size_t i1, const std::size_t i2, const std::size_t i3) const 
         {
             assert(i1 < i2 && i2 < i3 && i3 < no_nodes_);
-            return (triplet_factors_.find(std::array<std::size_t,3>{i1,i2,i3}) != triplet_factors_.end());
+            return triplet_index_.contains({i1,i2,i3});
         }
 
     template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2> 
         TRIPLET_FACTOR* cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::get_triplet_factor(const std::size_t i1, const std::size_t i2, const std::size_t i3) const 
         {
             assert(has_triplet_factor(i1,i2,i3));
-            assert(triplet_factors_.size() == triplet_factor_vector_.size());
-            return triplet_factors_.find(std::array<std::size_t,3>{i1,i2,i3})->second;
+            assert(triplet_index_.size() == triplet_factor_vector_.size());
+            return triplet_factor_vector_[triplet_index_.find({i1,i2,i3})].second;
+        }
+
+    template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2> 
+        TRIPLET_FACTOR* cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::find_triplet_factor(const std::size_t i1, const std::size_t i2, const std::size_t i3) const 
+        {
+            assert(i1 < i2 && i2 < i3);
+            const std::size_t pos = triplet_index_.find({i1,i2,i3});
+            return pos != triplet_index_.not_found ? triplet_factor_vector_[pos].second : nullptr;
         }
 
     template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2> 
@@ -256,7 +290,7 @@ namespace LPMP {
         double cut_base_triplet_constructor<FACTOR_MESSAGE_CONNECTION, EDGE_FACTOR, TRIPLET_FACTOR, EDGE_TRIPLET_MESSAGE_0, EDGE_TRIPLET_MESSAGE_1, EDGE_TRIPLET_MESSAGE_2>::get_edge_cost(const std::size_t i1, const std::size_t i2) const
         {
             assert(has_edge_factor(i1,i2));
-            return *(edge_factors_.find(std::array<std::size_t,2>{i1,i2})->second->get_factor());
+            return *(get_edge_factor(i1,i2)->get_factor());
         }
 
     template<class FACTOR_MESSAGE_CONNECTION, typename EDGE_FACTOR, typename TRIPLET_FACTOR, typename EDGE_TRIPLET_MESSAGE_0, typename EDGE_TRIPLET_MESSAGE_1, typename EDGE_TRIPLET_MESSAGE_2> 
@@ -329,16 +363,18 @@ namespace LPMP {
         {
             using edge_factor_type = typename EDGE_FACTOR::FactorType;
             auto get_edge_func = [&,this](const std::array<std::size_t,2> nodes) -> edge_factor_type& {
-                if(!this->has_edge_factor(nodes[0], nodes[1]))
-                    this->add_edge_factor(nodes[0], nodes[1], 0.0);
-                return *(this->get_edge_factor(nodes[0], nodes[1])->get_factor());
+                auto* e = this->find_edge_factor(nodes[0], nodes[1]);
+                if(e == nullptr)
+                    e = this->add_edge_factor(nodes[0], nodes[1], 0.0);
+                return *(e->get_factor());
             };
 
             using triplet_factor_type = typename TRIPLET_FACTOR::FactorType;
             auto get_triplet_func = [&,this](const std::array<std::size_t,3> nodes) -> triplet_factor_type& {
-                if(!this->has_triplet_factor(nodes[0], nodes[1], nodes[2]))
-                    this->add_triplet_factor(nodes[0], nodes[1], nodes[2]);
-                return *(this->get_triplet_factor(nodes[0], nodes[1], nodes[2])->get_factor());
+                auto* t = this->find_triplet_factor(nodes[0], nodes[1], nodes[2]);
+                if(t == nullptr)
+                    t = this->add_triplet_factor(nodes[0], nodes[1], nodes[2]);
+                return *(t->get_factor());
             };
 
             using msg_type = std::variant<typename EDGE_TRIPLET_MESSAGE_0::MessageType, typename EDGE_TRIPLET_MESSAGE_1::MessageType, typename EDGE_TRIPLET_MESSAGE_2::MessageType>;
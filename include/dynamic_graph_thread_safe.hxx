@@ -5,9 +5,11 @@
 #include <numeric>
 #include <limits>
 #include <algorithm>
+#include <atomic>
 #include <tsl/robin_map.h>
 #include <taskflow/taskflow.hpp>
 #include "hash_helper.hxx"
+#include "atomic_helper.h"
 
 // This class provides a similar interface as dynamic_graph, but edges can be added/deleted concurrently if they do not share endpoints
 namespace LPMP {
@@ -47,11 +49,28 @@ namespace LPMP {
             void remove_edge(const std::size_t i, const std::size_t j);
             void remove_node(const std::size_t i);
 
-            const auto edges(const std::size_t i) const { assert(i < no_nodes()); return edge_maps_[i]; }
+            const auto& edges(const std::size_t i) const { assert(i < no_nodes()); return edge_maps_[i]; }
+
+            // Concurrent edge contraction.
+            // Contracting edge (i,j) modifies the adjacency maps of i, j and of all their neighbors.
+            // A thread locks i and j with try_lock_node, then their neighbors with try_lock_neighborhood, and only then calls contract_edge.
+            // Contractions whose locked neighborhoods are disjoint touch disjoint adjacency maps and can run concurrently.
+            bool try_lock_node(const std::size_t i);
+            void unlock_node(const std::size_t i);
+            // i and j must be locked by the caller. On success all neighbors of i and j not locked before are appended to locked_nodes.
+            // On failure, the neighbors locked by this call are released again and false is returned.
+            bool try_lock_neighborhood(const std::size_t i, const std::size_t j, std::vector<std::size_t>& locked_nodes);
+            void unlock_nodes(const std::vector<std::size_t>& nodes);
+
+            // Contract edge (i,j) into the endpoint with more edges, which is returned. Parallel edges are combined with merge_op(EDGE_INFORMATION& stable_edge, const EDGE_INFORMATION& removed_edge).
+            // edge_op(stable_node, head, EDGE_INFORMATION&) is called for every edge of the returned node that has changed or was added.
+            template<typename MERGE_OP, typename EDGE_OP>
+                std::size_t contract_edge(const std::size_t i, const std::size_t j, MERGE_OP merge_op, EDGE_OP edge_op);
 
         private:
             std::array<std::size_t,2> normal_edge(const std::size_t i, const std::size_t j) const { return {std::min(i,j), std::max(i,j)}; }
             std::vector< tsl::robin_map<std::size_t, EDGE_INFORMATION> > edge_maps_;
+            std::vector<CopyableAtomic<char>> node_locks_;
     };
 
     template<typename EDGE_INFORMATION>
@@ -82,6 +101,8 @@ namespace LPMP {
             }
 
             edge_maps_.resize(adjacency_list_count.size());
+            node_locks_.clear();
+            node_locks_.resize(adjacency_list_count.size());
 
             for(std::size_t i=0; i<adjacency_list_count.size(); ++i)
                 edge_maps_[i].reserve(adjacency_list_count[i]);
@@ -135,6 +156,7 @@ namespace LPMP {
         dynamic_graph_thread_safe<EDGE_INFORMATION>::dynamic_graph_thread_safe(const std::size_t no_nodes)
         {
             edge_maps_.resize(no_nodes);
+            node_locks_.resize(no_nodes);
         }
 
     template<typename EDGE_INFORMATION>
@@ -197,4 +219,81 @@ namespace LPMP {
                 edge_maps_[e.first].erase(i);
             edge_maps_[i].clear();
         }
+
+    template<typename EDGE_INFORMATION>
+        bool dynamic_graph_thread_safe<EDGE_INFORMATION>::try_lock_node(const std::size_t i)
+        {
+            assert(i < no_nodes());
+            char expected = 0;
+            return node_locks_[i].compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+    template<typename EDGE_INFORMATION>
+        void dynamic_graph_thread_safe<EDGE_INFORMATION>::unlock_node(const std::size_t i)
+        {
+            assert(i < no_nodes());
+            assert(node_locks_[i].load() == 1);
+            node_locks_[i].store(0, std::memory_order_release);
+        }
+
+    template<typename EDGE_INFORMATION>
+        bool dynamic_graph_thread_safe<EDGE_INFORMATION>::try_lock_neighborhood(const std::size_t i, const std::size_t j, std::vector<std::size_t>& locked_nodes)
+        {
+            assert(node_locks_[i].load() == 1 && node_locks_[j].load() == 1);
+            const std::size_t no_locked_before = locked_nodes.size();
+            auto lock_neighbor = [&](const std::size_t n) {
+                if(try_lock_node(n)) {
+                    locked_nodes.push_back(n);
+                    return true;
+                }
+                for(std::size_t k=no_locked_before; k<locked_nodes.size(); ++k)
+                    unlock_node(locked_nodes[k]);
+                locked_nodes.resize(no_locked_before);
+                return false;
+            };
+
+            for(const auto& e : edge_maps_[i])
+                if(e.first != j && !lock_neighbor(e.first))
+                    return false;
+            for(const auto& e : edge_maps_[j])
+                if(e.first != i && edge_maps_[i].count(e.first) == 0 && !lock_neighbor(e.first))
+                    return false;
+            return true;
+        }
+
+    template<typename EDGE_INFORMATION>
+        void dynamic_graph_thread_safe<EDGE_INFORMATION>::unlock_nodes(const std::vector<std::size_t>& nodes)
+        {
+            for(const std::size_t i : nodes)
+                unlock_node(i);
+        }
+
+    template<typename EDGE_INFORMATION>
+        template<typename MERGE_OP, typename EDGE_OP>
+        std::size_t dynamic_graph_thread_safe<EDGE_INFORMATION>::contract_edge(const std::size_t i, const std::size_t j, MERGE_OP merge_op, EDGE_OP edge_op)
+        {
+            assert(edge_present(i,j));
+            const auto [stable_node, merge_node] = no_edges(i) < no_edges(j) ? std::array<std::size_t,2>{j,i} : std::array<std::size_t,2>{i,j};
+
+            edge_maps_[stable_node].erase(merge_node);
+            for(const auto& e : edge_maps_[merge_node]) {
+                const std::size_t head = e.first;
+                if(head == stable_node)
+                    continue;
+                edge_maps_[head].erase(merge_node);
+                auto stable_it = edge_maps_[stable_node].find(head);
+                if(stable_it != edge_maps_[stable_node].end()) {
+                    merge_op(stable_it.value(), e.second);
+                    merge_op(edge_maps_[head].find(stable_node).value(), e.second);
+                    edge_op(stable_node, head, stable_it.value());
+                } else {
+                    edge_maps_[head].insert(std::make_pair(stable_node, e.second));
+                    auto inserted_it = edge_maps_[stable_node].insert(std::make_pair(head, e.second)).first;
+                    edge_op(stable_node, head, inserted_it.value());
+                }
+            }
+            edge_maps_[merge_node].clear();
+
+            return stable_node;
+        }
 }
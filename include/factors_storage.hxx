@@ -5,10 +5,14 @@
 #include <unordered_map>
 #include <tuple>
 #include <cassert>
+#include <memory>
 #include <tsl/robin_map.h>
 #include "meta/meta.hpp"
 #include "topological_sort.hxx"
 #include "factor_container_interface.h"
+#include "memory_allocator.hxx"
+#include "template_utilities.hxx"
+#include "function_existence.hxx"
 
 namespace LPMP {
 
@@ -41,6 +45,31 @@ public:
    auto cend() const { return factors_.cend(); }
 
    std::size_t get_factor_index(const FactorTypeAdapter* f) const;
+   // position of factor's type in FMC::FactorList
+   std::size_t get_factor_type_index(const std::size_t i) const { assert(i<number_of_factors()); return factor_type_index_[i]; }
+
+   // maximal run of consecutive factors of the same type in a factor sequence
+   struct factor_type_run {
+      std::size_t type_index;
+      std::size_t begin;
+      std::size_t end;
+   };
+   template<typename FACTOR_ITERATOR>
+   std::vector<factor_type_run> compute_factor_type_runs(FACTOR_ITERATOR factor_begin, FACTOR_ITERATOR factor_end) const;
+
+   // call func with a null pointer of the factor container type at position type_index in FMC::FactorList.
+   // Allows to process runs of same-typed factors without virtual dispatch for every factor.
+   template<typename FUNC> void dispatch_factor_type(const std::size_t type_index, FUNC&& func) const;
+
+   // FMCs with many factors of the same type, e.g. MRFs with unary and pairwise factors, can set batched_factor_update = true.
+   // Passes are then executed per run of same-typed factors.
+   template<typename T> using has_batched_factor_update_t = decltype(T::batched_factor_update);
+   constexpr static bool batched_factor_update();
+
+   // Payloads (vectors, matrices) of subsequently added factors are allocated from one arena owned by the storage instead of individually from the heap.
+   // Must be called before factors are added. Memory is released when the storage is destroyed.
+   void enable_arena(const std::size_t slab_size = 64*MB);
+   monotonic_arena* get_arena() const { return arena_.get(); }
 
 private:
    template<typename FACTOR_CONTAINER_TYPE>
@@ -51,6 +80,7 @@ private:
       sort_factors(const std::vector<std::array<FactorTypeAdapter*,2>>& factor_rel);
 
    std::vector<FactorTypeAdapter*> factors_;
+   std::vector<std::size_t> factor_type_index_;
    tsl::robin_map<const FactorTypeAdapter*,std::size_t> factor_address_to_index_;
    //std::unordered_map<const FactorTypeAdapter*,std::size_t> factor_address_to_index_;
    std::vector<std::array<FactorTypeAdapter*,2>> forward_pass_factor_relation_, backward_pass_factor_relation_;
@@ -65,12 +95,16 @@ private:
    using factors_tuple_type = meta::apply<meta::quote<std::tuple>, factors_vector_list>;
 
    factors_tuple_type factors_tuple_;
+
+   // destructor body deletes the factors before any member is destroyed, so payloads in the arena outlive their factors
+   std::unique_ptr<monotonic_arena> arena_;
 };
 
 template<typename FMC>
 template<typename FACTOR_CONTAINER_TYPE, typename... ARGS>
 FACTOR_CONTAINER_TYPE* factors_storage<FMC>::add_factor(ARGS&&... args)
 { 
+   monotonic_arena::scope arena_scope(arena_.get());
    auto* f = new FACTOR_CONTAINER_TYPE(std::forward<ARGS>(args)...);
    assert(factor_address_to_index_.size() == factors_.size());
    factors_.push_back(f);
@@ -81,9 +115,21 @@ FACTOR_CONTAINER_TYPE* factors_storage<FMC>::add_factor(ARGS&&... args)
 
    constexpr auto factor_idx = factors_tuple_index<FACTOR_CONTAINER_TYPE>();
    std::get<factor_idx>(factors_tuple_).push_back(f);
+   factor_type_index_.push_back(factor_idx);
    return f;
 }
 
+template<typename FMC>
+void factors_storage<FMC>::enable_arena(const std::size_t slab_size)
+{
+   if(number_of_factors() > 0) {
+      throw std::runtime_error("arena must be enabled before factors are added");
+   }
+   if(!arena_) {
+      arena_ = std::make_unique<monotonic_arena>(slab_size);
+   }
+}
+
 template<typename FMC>
 inline void factors_storage<FMC>::add_factor_relation(FactorTypeAdapter* f1, FactorTypeAdapter* f2)
 {
@@ -152,6 +198,47 @@ std::size_t factors_storage<FMC>::get_factor_index(const FactorTypeAdapter* f) c
    return factor_address_to_index_.find(f)->second;
 }
 
+template<typename FMC>
+template<typename FACTOR_ITERATOR>
+std::vector<typename factors_storage<FMC>::factor_type_run> factors_storage<FMC>::compute_factor_type_runs(FACTOR_ITERATOR factor_begin, FACTOR_ITERATOR factor_end) const
+{
+   std::vector<factor_type_run> runs;
+   const std::size_t n = std::distance(factor_begin, factor_end);
+   for(std::size_t i=0; i<n; ++i) {
+      const std::size_t type_index = get_factor_type_index(get_factor_index(*(factor_begin + i)));
+      if(runs.size() > 0 && runs.back().type_index == type_index) {
+         assert(runs.back().end == i);
+         runs.back().end = i+1;
+      } else {
+         runs.push_back({type_index, i, i+1});
+      }
+   }
+   return runs;
+}
+
+template<typename FMC>
+template<typename FUNC>
+void factors_storage<FMC>::dispatch_factor_type(const std::size_t type_index, FUNC&& func) const
+{
+   assert(type_index < std::tuple_size<factors_tuple_type>::value);
+   std::size_t i = 0;
+   for_each_tuple(factors_tuple_, [&](const auto& v) {
+         using factor_container_type = std::remove_pointer_t<typename std::decay_t<decltype(v)>::value_type>;
+         if(i++ == type_index) {
+            func(static_cast<factor_container_type*>(nullptr));
+         }
+   });
+}
+
+template<typename FMC>
+constexpr bool factors_storage<FMC>::batched_factor_update()
+{
+   if constexpr(is_detected<has_batched_factor_update_t, FMC>::value)
+      return FMC::batched_factor_update;
+   else
+      return false;
+}
+
 template<typename FMC>
 template<typename FACTOR_CONTAINER_TYPE>
 constexpr std::size_t factors_storage<FMC>::factors_tuple_index()
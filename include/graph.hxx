@@ -156,6 +156,8 @@ namespace LPMP {
 
             template<typename EDGE_OP>
                 std::vector<std::size_t> trace_path(const std::size_t i1, const std::size_t i2, EDGE_OP edge_op, const edge_information& edge_info) const;
+            template<typename EDGE_OP>
+                void trace_path(const std::size_t i1, const std::size_t i2, EDGE_OP edge_op, const edge_information& edge_info, std::vector<std::size_t>& path) const;
 
             // do bfs with thresholded costs and iteratively lower threshold until enough cycles are found
             // only consider edges that have cost equal or larger than th
@@ -165,6 +167,9 @@ namespace LPMP {
 
             template<typename MASK_OP, typename EDGE_OP>
                 std::vector<std::size_t> find_path(const std::size_t start_node, const std::size_t end_node, MASK_OP mask_op, EDGE_OP edge_op);
+            // same as above, but path is written into given vector to avoid reallocation in repeated searches. Path is empty if none is found.
+            template<typename MASK_OP, typename EDGE_OP>
+                void find_path(const std::size_t start_node, const std::size_t end_node, MASK_OP mask_op, EDGE_OP edge_op, std::vector<std::size_t>& path);
 
             // traverse all edges that have at least one endpoint in current component
             template<typename CUT_EDGE_OP>
@@ -690,10 +695,19 @@ namespace LPMP {
     template<typename GRAPH>
         template<typename EDGE_OP>
         std::vector<std::size_t> bfs_data<GRAPH>::trace_path(const std::size_t i1, const std::size_t i2, EDGE_OP edge_op, const edge_information& edge_info) const
+        {
+            std::vector<std::size_t> path;
+            trace_path(i1, i2, edge_op, edge_info, path);
+            return path;
+        }
+
+    template<typename GRAPH>
+        template<typename EDGE_OP>
+        void bfs_data<GRAPH>::trace_path(const std::size_t i1, const std::size_t i2, EDGE_OP edge_op, const edge_information& edge_info, std::vector<std::size_t>& path) const
         {
             assert(i1 != i2);
 
-            std::vector<std::size_t> path;
+            path.clear();
             path.push_back(i1);
             std::size_t j=i1;
             edge_op(i1,i2,edge_info);
@@ -710,8 +724,6 @@ namespace LPMP {
                 j = parent(j);
                 path.push_back(j);
             }
-
-            return path;
         }
 
     template<typename GRAPH>
@@ -723,8 +735,18 @@ namespace LPMP {
     template<typename GRAPH>
         template<typename MASK_OP, typename EDGE_OP>
         std::vector<std::size_t> bfs_data<GRAPH>::find_path(const std::size_t start_node, const std::size_t end_node, MASK_OP mask_op, EDGE_OP edge_op)
+        {
+            std::vector<std::size_t> path;
+            find_path(start_node, end_node, mask_op, edge_op, path);
+            return path;
+        }
+
+    template<typename GRAPH>
+        template<typename MASK_OP, typename EDGE_OP>
+        void bfs_data<GRAPH>::find_path(const std::size_t start_node, const std::size_t end_node, MASK_OP mask_op, EDGE_OP edge_op, std::vector<std::size_t>& path)
         {
             assert(start_node != end_node);
+            path.clear();
             assert(start_node < g.no_nodes() && end_node < g.no_nodes());
             reset();
             visit.push_back({start_node, 0});
@@ -754,7 +776,8 @@ namespace LPMP {
                                 label1(j);
                             } else if(labelled2(j)) { // shortest path found
                                 // trace back path from j to end_node and from i to start_node
-                                return trace_path(i,j, edge_op, a_it->edge());
+                                trace_path(i,j, edge_op, a_it->edge(), path);
+                                return;
                             }
 
                         }
@@ -773,7 +796,8 @@ namespace LPMP {
                                 label2(j);
                             } else if(labelled1(j)) { // shortest path found
                                 // trace back path from j to end_node and from i to start_node
-                                return trace_path(i,j, edge_op, a_it->edge());
+                                trace_path(i,j, edge_op, a_it->edge(), path);
+                                return;
                             }
 
                         }
@@ -782,7 +806,6 @@ namespace LPMP {
 
 
             }
-            return std::vector<std::size_t>({});
         }
 
     // traverse all edges that have at least one endpoint in current component
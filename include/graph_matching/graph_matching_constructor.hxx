@@ -153,6 +153,40 @@ public:
        construct_pairwise_factors(gm_input);
        mcf_ = std::make_unique<mcf_solver_type>(gm_input.no_mcf_nodes(), gm_input.no_mcf_edges());
        gm_input.initialize_mcf(*mcf_);
+       constructed_input_ = gm_input;
+    }
+
+    // replace costs of the constructed instance by those of gm_input, which must have the same assignments and quadratic terms.
+    // Only the cost differences are added to the factors, hence the current reparametrization is kept and serves as warm start for further optimization.
+    void update_costs(const graph_matching_input& gm_input)
+    {
+       if(gm_input.assignments.size() != constructed_input_.assignments.size() || gm_input.quadratic_terms.size() != constructed_input_.quadratic_terms.size())
+          throw std::runtime_error("cost update must have the same number of assignments and quadratic terms as constructed graph matching problem.");
+
+       graph_matching_input cost_difference = gm_input;
+       for(std::size_t i=0; i<cost_difference.assignments.size(); ++i) {
+          auto& a = cost_difference.assignments[i];
+          const auto& a_prev = constructed_input_.assignments[i];
+          if(a.left_node != a_prev.left_node || a.right_node != a_prev.right_node)
+             throw std::runtime_error("cost update must have the same assignments as constructed graph matching problem.");
+          a.cost -= a_prev.cost;
+       }
+       for(std::size_t i=0; i<cost_difference.quadratic_terms.size(); ++i) {
+          auto& q = cost_difference.quadratic_terms[i];
+          const auto& q_prev = constructed_input_.quadratic_terms[i];
+          if(q.assignment_1 != q_prev.assignment_1 || q.assignment_2 != q_prev.assignment_2)
+             throw std::runtime_error("cost update must have the same quadratic terms as constructed graph matching problem.");
+          q.cost -= q_prev.cost;
+       }
+
+       const std::size_t no_pairwise_factors = left_mrf.get_number_of_pairwise_factors() + right_mrf.get_number_of_pairwise_factors();
+       add_unary_costs(cost_difference);
+       construct_pairwise_factors(cost_difference);
+       assert(no_pairwise_factors == left_mrf.get_number_of_pairwise_factors() + right_mrf.get_number_of_pairwise_factors());
+
+       constructed_input_ = gm_input;
+       best_labeling_.clear();
+       best_labeling_cost_ = std::numeric_limits<double>::infinity();
     }
 
     // solve underlying linear assignment problem with combinatorial problems. Use optimal dual node potentials to reparametrize unary factors in MRFs
@@ -489,7 +523,11 @@ protected:
    {
        construct_empty_unary_factors(left_mrf, graph_);
        construct_empty_unary_factors(right_mrf, inverse_graph_);
+       add_unary_costs(input);
+   }
 
+   void add_unary_costs(const linear_assignment_problem_input& input)
+   {
        const auto [left_weight, right_weight] = [&]() -> std::array<double,2> {
            if(construction_arg_.getValue() == "left") {
                return {1.0, 0.0};
@@ -508,7 +546,6 @@ protected:
              {
                 const std::size_t left_index = get_left_index(a.left_node, a.right_node);
                 auto *left_factor = left_mrf.get_unary_factor(a.left_node);
-                assert((*left_factor->get_factor())[left_index] == 0.0);
                 return {left_index, left_factor};
              }
              else
@@ -522,7 +559,6 @@ protected:
              {
                 const std::size_t right_index = get_right_index(a.right_node, a.left_node);
                 auto *right_factor = right_mrf.get_unary_factor(a.right_node);
-                assert((*right_factor->get_factor())[right_index] == 0.0);
                 return {right_index, right_factor};
              }
              else
@@ -532,16 +568,16 @@ protected:
           }();
 
           if(left_factor != nullptr && right_factor != nullptr) {
-             (*left_factor->get_factor())[left_index] = left_weight * a.cost;
-             (*right_factor->get_factor())[right_index] = right_weight * a.cost;
+             (*left_factor->get_factor())[left_index] += left_weight * a.cost;
+             (*right_factor->get_factor())[right_index] += right_weight * a.cost;
           }
           else if (left_factor != nullptr)
           {
-             (*left_factor->get_factor())[left_index] = a.cost;
+             (*left_factor->get_factor())[left_index] += a.cost;
           }
           else if (right_factor != nullptr)
           {
-             (*right_factor->get_factor())[right_index] = a.cost;
+             (*right_factor->get_factor())[right_index] += a.cost;
           }
        }
    }
@@ -732,6 +768,7 @@ protected:
    std::vector<quadratic> quadratic_; 
    graph_matching_input::labeling best_labeling_;
    double best_labeling_cost_ = std::numeric_limits<double>::infinity();
+   graph_matching_input constructed_input_;
 };
 
 template<typename GRAPH_MATCHING_MRF_CONSTRUCTOR, typename ASSIGNMENT_MESSAGE>
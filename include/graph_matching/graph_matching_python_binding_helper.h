@@ -5,21 +5,238 @@
 #include <pybind11/stl.h>
 #include <pybind11/operators.h>
 #include <pybind11/numpy.h>
+#include <vector>
+#include <array>
+#include <string>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <limits>
+#include <cassert>
 
 namespace py = pybind11;
 
 namespace LPMP {
     namespace py_helper {
 
-    void add_assignments(LPMP::graph_matching_input& instance, const py::array_t<double> assignments);
+    // Costs and edges are accepted as numpy arrays or anything numpy can convert, e.g. nested lists or objects implementing __array__.
+    // C-contiguous float32/float64 costs and int32/int64 edges are read in place without conversion, everything else is converted once.
 
-    void add_quadratic_terms(LPMP::graph_matching_input& instance, const py::array_t<double> quadratic_terms, const py::array_t<int> left_edges, const py::array_t<int> right_edges);
+    // numpy arrays are returned as they are, other objects are converted
+    py::array as_array(const py::object& obj);
 
-    void construct_from_arrays(LPMP::graph_matching_input& instance, const py::array_t<double> assignments, const py::array_t<double> quadratic_terms, const py::array_t<int> left_edges, const py::array_t<int> right_edges);
+    using edge_list = std::vector<std::array<std::size_t,2>>;
+    // edges of shape (#edges, 2) with endpoints smaller than no_nodes
+    edge_list read_edges(const py::object& edges, const std::size_t no_nodes = std::numeric_limits<std::size_t>::max());
 
-    py::array_t<char> get_assignment_mask(LPMP::graph_matching_input::labeling labeling, const py::array_t<double> assignments);
+    // calls f with a pointer to the C-contiguous cost buffer, which is const float* or const double*
+    template<typename FUNC>
+    void visit_costs(const py::array& costs, FUNC&& f)
+    {
+        if(py::array_t<double, py::array::c_style>::check_(costs)) {
+            f(static_cast<const double*>(costs.data()));
+        } else if(py::array_t<float, py::array::c_style>::check_(costs)) {
+            f(static_cast<const float*>(costs.data()));
+        } else {
+            const auto converted = py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(costs);
+            if(!converted)
+                throw py::error_already_set();
+            f(converted.data());
+        }
+    }
+
+    // assignment costs of left node i and right node j are assignments[i*stride + j]
+    template<typename COST>
+    void add_assignment_costs(LPMP::graph_matching_input& instance, const COST* assignments, const std::size_t no_left_nodes, const std::size_t no_right_nodes, const std::size_t stride);
+
+    // quadratic costs of left edge i and right edge j are quadratic_terms[i*stride + j]. Assignments must have been added by add_assignment_costs before.
+    template<typename COST>
+    void add_quadratic_costs(LPMP::graph_matching_input& instance, const COST* quadratic_terms, const edge_list& left_edges, const edge_list& right_edges, const std::size_t stride);
+
+    void add_assignments(LPMP::graph_matching_input& instance, const py::object& assignments);
+
+    void add_quadratic_terms(LPMP::graph_matching_input& instance, const py::object& quadratic_terms, const py::object& left_edges, const py::object& right_edges);
+
+    void construct_from_arrays(LPMP::graph_matching_input& instance, const py::object& assignments, const py::object& quadratic_terms, const py::object& left_edges, const py::object& right_edges);
+
+    py::array_t<char> get_assignment_mask(const LPMP::graph_matching_input::labeling& labeling, const py::object& assignments);
+
+    py::array_t<char> get_quadratic_terms_mask(const LPMP::graph_matching_input::labeling& labeling, const py::object& quadratic_terms, const py::object& left_edges, const py::object& right_edges);
+
+    template<typename COST>
+    void add_assignment_costs(LPMP::graph_matching_input& instance, const COST* assignments, const std::size_t no_left_nodes, const std::size_t no_right_nodes, const std::size_t stride)
+    {
+        instance.assignments.reserve(instance.assignments.size() + no_left_nodes*no_right_nodes);
+        for(std::size_t i=0; i<no_left_nodes; ++i)
+            for(std::size_t j=0; j<no_right_nodes; ++j)
+                instance.add_assignment(i, j, assignments[i*stride + j]);
+    }
+
+    template<typename COST>
+    void add_quadratic_costs(LPMP::graph_matching_input& instance, const COST* quadratic_terms, const edge_list& left_edges, const edge_list& right_edges, const std::size_t stride)
+    {
+        const std::size_t no_right_nodes = instance.no_right_nodes;
+        instance.quadratic_terms.reserve(instance.quadratic_terms.size() + left_edges.size()*right_edges.size());
+        for(std::size_t i=0; i<left_edges.size(); ++i) {
+            const auto [l1, l2] = left_edges[i];
+            assert(l1 < instance.no_left_nodes && l2 < instance.no_left_nodes);
+            for(std::size_t j=0; j<right_edges.size(); ++j) {
+                const auto [r1, r2] = right_edges[j];
+                assert(r1 < no_right_nodes && r2 < no_right_nodes);
+                instance.add_quadratic_term(l1*no_right_nodes + r1, l2*no_right_nodes + r2, quadratic_terms[i*stride + j]);
+            }
+        }
+    }
+
+    // Solves a batch of graph matching instances on nr_threads threads without holding the GIL.
+    // Instance k matches graphs with no_left_nodes[k] resp. no_right_nodes[k] nodes and edges left_edges[k] resp. right_edges[k].
+    // Costs of all instances are passed as zero padded arrays of shape (batch size, max |V_1|, max |V_2|) and (batch size, max |E_1|, max |E_2|) and are read in place.
+    // Results are returned as zero padded masks of the same shapes.
+    // Problems are constructed in the first call of solve, subsequent calls update costs and warm start from the current duals.
+    template<typename SOLVER>
+    class graph_matching_batch_solver {
+        public:
+            graph_matching_batch_solver(const std::vector<std::string>& options,
+                    const std::vector<py::object>& left_edges, const std::vector<py::object>& right_edges,
+                    const std::vector<std::size_t>& no_left_nodes, const std::vector<std::size_t>& no_right_nodes,
+                    const int nr_threads);
+
+            std::size_t size() const { return solvers_.size(); }
+
+            std::pair<py::array_t<char>, py::array_t<char>> solve(const py::object& assignment_costs, const py::object& quadratic_costs);
+
+        private:
+            template<typename ASSIGNMENT_COST, typename QUADRATIC_COST>
+            std::vector<std::string> solve(const ASSIGNMENT_COST* assignments, const std::array<std::size_t,2> assignment_shape,
+                    const QUADRATIC_COST* quadratic_terms, const std::array<std::size_t,2> quadratic_shape,
+                    char* assignment_mask, char* quadratic_mask);
 
-    py::array_t<char> get_quadratic_terms_mask(LPMP::graph_matching_input::labeling labeling, const py::array_t<double> quadratic_terms, const py::array_t<int> left_edges, const py::array_t<int> right_edges);
+            std::vector<std::unique_ptr<SOLVER>> solvers_;
+            std::vector<edge_list> left_edges_;
+            std::vector<edge_list> right_edges_;
+            std::vector<std::size_t> no_left_nodes_;
+            std::vector<std::size_t> no_right_nodes_;
+            std::vector<char> constructed_;
+            int nr_threads_;
+    };
+
+    template<typename SOLVER>
+    graph_matching_batch_solver<SOLVER>::graph_matching_batch_solver(const std::vector<std::string>& options,
+            const std::vector<py::object>& left_edges, const std::vector<py::object>& right_edges,
+            const std::vector<std::size_t>& no_left_nodes, const std::vector<std::size_t>& no_right_nodes,
+            const int nr_threads)
+        : no_left_nodes_(no_left_nodes),
+        no_right_nodes_(no_right_nodes),
+        nr_threads_(nr_threads > 0 ? nr_threads : std::max(1, int(std::thread::hardware_concurrency())))
+    {
+        const std::size_t batch_size = left_edges.size();
+        if(right_edges.size() != batch_size || no_left_nodes.size() != batch_size || no_right_nodes.size() != batch_size)
+            throw std::runtime_error("graph matching batch solver: edges and node numbers must be given for every instance");
+
+        // edges are copied once, so that solving does not access python objects
+        for(std::size_t k=0; k<batch_size; ++k) {
+            left_edges_.push_back(read_edges(left_edges[k], no_left_nodes[k]));
+            right_edges_.push_back(read_edges(right_edges[k], no_right_nodes[k]));
+        }
+
+        // solver construction parses options into global settings, hence solvers are constructed here and not concurrently
+        for(std::size_t k=0; k<batch_size; ++k)
+            solvers_.push_back(std::make_unique<SOLVER>(options));
+        constructed_.resize(batch_size, 0);
+    }
+
+    template<typename SOLVER>
+    std::pair<py::array_t<char>, py::array_t<char>> graph_matching_batch_solver<SOLVER>::solve(const py::object& assignment_costs, const py::object& quadratic_costs)
+    {
+        const py::array assignments = as_array(assignment_costs);
+        const py::array quadratic_terms = as_array(quadratic_costs);
+        const std::size_t batch_size = size();
+        if(assignments.ndim() != 3 || quadratic_terms.ndim() != 3)
+            throw std::runtime_error("graph matching batch solver: costs must be three dimensional arrays");
+        if(assignments.shape(0) != batch_size || quadratic_terms.shape(0) != batch_size)
+            throw std::runtime_error("graph matching batch solver: first cost dimension must be the batch size");
+        const std::array<std::size_t,2> assignment_shape = {std::size_t(assignments.shape(1)), std::size_t(assignments.shape(2))};
+        const std::array<std::size_t,2> quadratic_shape = {std::size_t(quadratic_terms.shape(1)), std::size_t(quadratic_terms.shape(2))};
+        for(std::size_t k=0; k<batch_size; ++k) {
+            if(assignment_shape[0] < no_left_nodes_[k] || assignment_shape[1] < no_right_nodes_[k])
+                throw std::runtime_error("graph matching batch solver: assignment costs smaller than number of nodes");
+            if(quadratic_shape[0] < left_edges_[k].size() || quadratic_shape[1] < right_edges_[k].size())
+                throw std::runtime_error("graph matching batch solver: quadratic costs smaller than number of edges");
+        }
+
+        py::array_t<char> assignment_mask({assignments.shape(0), assignments.shape(1), assignments.shape(2)});
+        py::array_t<char> quadratic_mask({quadratic_terms.shape(0), quadratic_terms.shape(1), quadratic_terms.shape(2)});
+        std::fill(assignment_mask.mutable_data(), assignment_mask.mutable_data() + assignment_mask.size(), 0);
+        std::fill(quadratic_mask.mutable_data(), quadratic_mask.mutable_data() + quadratic_mask.size(), 0);
+
+        std::vector<std::string> errors;
+        visit_costs(assignments, [&](const auto* a) {
+            visit_costs(quadratic_terms, [&](const auto* q) {
+                py::gil_scoped_release release;
+                errors = solve(a, assignment_shape, q, quadratic_shape, assignment_mask.mutable_data(), quadratic_mask.mutable_data());
+            });
+        });
+
+        for(std::size_t k=0; k<batch_size; ++k)
+            if(!errors[k].empty())
+                throw std::runtime_error("graph matching batch solver, instance " + std::to_string(k) + ": " + errors[k]);
+
+        return {assignment_mask, quadratic_mask};
+    }
+
+    // called without holding the GIL. Returns an error message for every instance, empty if the instance was solved.
+    template<typename SOLVER>
+    template<typename ASSIGNMENT_COST, typename QUADRATIC_COST>
+    std::vector<std::string> graph_matching_batch_solver<SOLVER>::solve(const ASSIGNMENT_COST* assignments, const std::array<std::size_t,2> assignment_shape,
+            const QUADRATIC_COST* quadratic_terms, const std::array<std::size_t,2> quadratic_shape,
+            char* assignment_mask, char* quadratic_mask)
+    {
+        const std::size_t batch_size = size();
+        const std::size_t assignment_size = assignment_shape[0]*assignment_shape[1];
+        const std::size_t quadratic_size = quadratic_shape[0]*quadratic_shape[1];
+        std::vector<std::string> errors(batch_size);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nr_threads_)
+        for(std::size_t k=0; k<batch_size; ++k) {
+            try {
+                const std::size_t no_left_nodes = no_left_nodes_[k];
+                const std::size_t no_right_nodes = no_right_nodes_[k];
+                graph_matching_input instance;
+                add_assignment_costs(instance, assignments + k*assignment_size, no_left_nodes, no_right_nodes, assignment_shape[1]);
+                add_quadratic_costs(instance, quadratic_terms + k*quadratic_size, left_edges_[k], right_edges_[k], quadratic_shape[1]);
+
+                auto& solver = *solvers_[k];
+                if(!constructed_[k]) {
+                    solver.GetProblemConstructor().construct(instance);
+                    constructed_[k] = 1;
+                } else {
+                    solver.GetProblemConstructor().update_costs(instance);
+                }
+                solver.Solve();
+
+                const auto labeling = solver.GetProblemConstructor().best_labeling();
+                if(labeling.size() != no_left_nodes)
+                    throw std::runtime_error("no labeling computed");
+                char* a_mask = assignment_mask + k*assignment_size;
+                for(std::size_t i=0; i<no_left_nodes; ++i)
+                    if(labeling[i] != linear_assignment_problem_input::no_assignment)
+                        a_mask[i*assignment_shape[1] + labeling[i]] = 1;
+                char* q_mask = quadratic_mask + k*quadratic_size;
+                for(std::size_t i=0; i<left_edges_[k].size(); ++i) {
+                    const auto [l1, l2] = left_edges_[k][i];
+                    for(std::size_t j=0; j<right_edges_[k].size(); ++j) {
+                        const auto [r1, r2] = right_edges_[k][j];
+                        if(labeling[l1] == r1 && labeling[l2] == r2)
+                            q_mask[i*quadratic_shape[1] + j] = 1;
+                    }
+                }
+            } catch(const std::exception& e) {
+                errors[k] = e.what();
+            }
+        }
+
+        return errors;
+    }
 
     }
 }
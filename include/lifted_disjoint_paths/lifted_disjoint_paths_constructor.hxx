@@ -10,6 +10,7 @@
 #include<map>
 //#include"ldp_cut_factor.hxx"
 #include <memory>
+#include <functional>
 #include "ldp_min_marginals_extractor.hxx"
 #include "ldp_path_separator.hxx"
 #include "ldp_cut_message_creator.hxx"
@@ -34,6 +35,10 @@ public:
     void construct(const lifted_disjoint_paths::LdpInstance& instance);
 
     void ComputePrimal();
+    // read off base edge costs into a copy of the flow network, the returned task solves it without accessing the LP
+    std::function<std::vector<long>()> export_primal_rounding_task();
+    // set base edges according to the flow per mcf edge, then lifted edges, cut and path factors
+    void read_in_primal_rounding(const std::vector<long>& flows);
 
     void WritePrimal(std::stringstream& strStream)const;
 
@@ -1046,6 +1051,12 @@ void lifted_disjoint_paths_constructor<FACTOR_MESSAGE_CONNECTION, SINGLE_NODE_CU
 
 template <class FACTOR_MESSAGE_CONNECTION, class SINGLE_NODE_CUT_FACTOR,class CUT_FACTOR_CONT, class SINGLE_NODE_CUT_LIFTED_MESSAGE,class SNC_CUT_MESSAGE,class PATH_FACTOR,class SNC_PATH_MESSAGE>
 void lifted_disjoint_paths_constructor<FACTOR_MESSAGE_CONNECTION, SINGLE_NODE_CUT_FACTOR, CUT_FACTOR_CONT, SINGLE_NODE_CUT_LIFTED_MESSAGE,SNC_CUT_MESSAGE,PATH_FACTOR,SNC_PATH_MESSAGE>::ComputePrimal()
+{
+    read_in_primal_rounding(export_primal_rounding_task()());
+}
+
+template <class FACTOR_MESSAGE_CONNECTION, class SINGLE_NODE_CUT_FACTOR,class CUT_FACTOR_CONT, class SINGLE_NODE_CUT_LIFTED_MESSAGE,class SNC_CUT_MESSAGE,class PATH_FACTOR,class SNC_PATH_MESSAGE>
+std::function<std::vector<long>()> lifted_disjoint_paths_constructor<FACTOR_MESSAGE_CONNECTION, SINGLE_NODE_CUT_FACTOR, CUT_FACTOR_CONT, SINGLE_NODE_CUT_LIFTED_MESSAGE,SNC_CUT_MESSAGE,PATH_FACTOR,SNC_PATH_MESSAGE>::export_primal_rounding_task()
 {
 //If used here, more stable primal solution. However, slower convergence.
   //  if(diagnostics()) std::cout<<"computing primal"<<std::endl;
@@ -1060,8 +1071,24 @@ void lifted_disjoint_paths_constructor<FACTOR_MESSAGE_CONNECTION, SINGLE_NODE_CU
 
 
     read_in_mcf_costs();
-    mcf_->solve();
+    // pre_iterate reuses mcf_ for reparametrizing single node cut factors, hence solve on a copy
+    auto mcf = std::make_shared<mcf_solver_type>(*mcf_);
+    std::size_t nr_mcf_edges = 0;
+    for(std::size_t i=0; i<mcf->no_nodes(); ++i)
+        nr_mcf_edges = std::max(nr_mcf_edges, std::size_t(mcf->first_outgoing_arc(i) + mcf->no_outgoing_arcs(i)));
+
+    return [mcf, nr_mcf_edges]() {
+        mcf->solve();
+        std::vector<long> flows(nr_mcf_edges);
+        for(std::size_t e=0; e<nr_mcf_edges; ++e)
+            flows[e] = mcf->flow(e);
+        return flows;
+    };
+}
 
+template <class FACTOR_MESSAGE_CONNECTION, class SINGLE_NODE_CUT_FACTOR,class CUT_FACTOR_CONT, class SINGLE_NODE_CUT_LIFTED_MESSAGE,class SNC_CUT_MESSAGE,class PATH_FACTOR,class SNC_PATH_MESSAGE>
+void lifted_disjoint_paths_constructor<FACTOR_MESSAGE_CONNECTION, SINGLE_NODE_CUT_FACTOR, CUT_FACTOR_CONT, SINGLE_NODE_CUT_LIFTED_MESSAGE,SNC_CUT_MESSAGE,PATH_FACTOR,SNC_PATH_MESSAGE>::read_in_primal_rounding(const std::vector<long>& flows)
+{
     std::vector<size_t> startingNodes;
     std::vector<size_t> descendants(nr_nodes(),base_graph_terminal_node());
 
@@ -1077,7 +1104,7 @@ void lifted_disjoint_paths_constructor<FACTOR_MESSAGE_CONNECTION, SINGLE_NODE_CU
             const std::size_t node = mcf_->head(edge_id);
             if(base_graph_node(node) != graph_node) {
                 auto* pSNC=single_node_cut_factors_[graph_node][0]->get_factor();
-                if(mcf_->flow(edge_id) == -1) {
+                if(flows[edge_id] == -1) {
                     pSNC->setBaseEdgeActive(vertex_index);
                     size_t nodeID=pSNC->getBaseID(vertex_index);
                     if(nodeID==base_graph_source_node()){
@@ -1097,7 +1124,7 @@ void lifted_disjoint_paths_constructor<FACTOR_MESSAGE_CONNECTION, SINGLE_NODE_CU
             const std::size_t node = mcf_->head(edge_id);
             if(base_graph_node(node) != graph_node) {
                 auto* pSNC=single_node_cut_factors_[graph_node][1]->get_factor();
-                if(mcf_->flow(edge_id) == 1) {
+                if(flows[edge_id] == 1) {
                     pSNC->setBaseEdgeActive(vertex_index);
                     size_t nodeID=pSNC->getBaseID(vertex_index);
                     assert(descendants[graph_node]==base_graph_terminal_node());
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <cstring>
 #include <mutex>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
 #include "config.hxx"
 #include "spinlock.hxx"
 
@@ -680,6 +683,75 @@ template<typename T>
   //}
 
 
+// bump allocator handing out 32 byte aligned chunks from a few large slabs.
+// Single chunks cannot be released, all memory is freed together when the arena is destroyed.
+// Used for payloads of factors and messages (see vector), so that they sit contiguously in memory.
+class monotonic_arena {
+public:
+   constexpr static std::size_t alignment = 32;
+
+   monotonic_arena(const std::size_t slab_size = 16*MB) : slab_size_(align_up(slab_size)) {}
+   ~monotonic_arena() { for(void* s : slabs_) { std::free(s); } }
+   monotonic_arena(const monotonic_arena&) = delete;
+   monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+   void* allocate(const std::size_t size_bytes)
+   {
+      const std::size_t n = align_up(size_bytes);
+      std::lock_guard<spinlock> guard(lock_);
+      if(cur_ + n > end_) {
+         add_slab(std::max(n, slab_size_));
+      }
+      void* p = cur_;
+      cur_ += n;
+      used_ += n;
+      return p;
+   }
+
+   std::size_t mem_used() const { return used_; }
+   std::size_t mem_reserved() const { return reserved_; }
+   std::size_t no_slabs() const { return slabs_.size(); }
+
+   static std::size_t align_up(const std::size_t size_bytes) { return (size_bytes + alignment - 1)/alignment*alignment; }
+
+   // arena into which allocations of the current thread are routed. nullptr means allocation from heap.
+   static monotonic_arena*& current()
+   {
+      thread_local monotonic_arena* a = nullptr;
+      return a;
+   }
+
+   // route allocations of the current thread into given arena while in scope
+   class scope {
+   public:
+      scope(monotonic_arena* a) : prev_(current()) { current() = a; }
+      ~scope() { current() = prev_; }
+      scope(const scope&) = delete;
+      scope& operator=(const scope&) = delete;
+   private:
+      monotonic_arena* prev_;
+   };
+
+private:
+   void add_slab(const std::size_t size_bytes)
+   {
+      char* slab = (char*) std::aligned_alloc(alignment, size_bytes);
+      if(slab == nullptr) { throw std::bad_alloc(); }
+      slabs_.push_back(slab);
+      cur_ = slab;
+      end_ = slab + size_bytes;
+      reserved_ += size_bytes;
+   }
+
+   const std::size_t slab_size_;
+   std::vector<char*> slabs_;
+   char* cur_ = nullptr;
+   char* end_ = nullptr;
+   std::size_t used_ = 0;
+   std::size_t reserved_ = 0;
+   spinlock lock_;
+};
+
 // global stack allocator
 static int stack_arena_mem[100000];
 static stack_arena global_real_stack_arena(stack_arena_mem,100000);
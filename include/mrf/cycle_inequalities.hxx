@@ -8,7 +8,10 @@
 #include <stdlib.h>
 #include <vector>
 #include <algorithm>
+#include <iterator>
 #include <set>
+#include <tuple>
+#include <omp.h>
 //#include <list>
 //#include <map>
 //#include <queue>
@@ -30,13 +33,49 @@ namespace LPMP {
          assert(i < j && j < k);
       }
 
-      bool operator<(const triplet_candidate& o) const { return std::abs(cost) > std::abs(o.cost); }
+      // total order, candidates with equal cost are ordered by their nodes. Hence sorted candidate lists do not depend on the order in which threads found them.
+      bool operator<(const triplet_candidate& o) const
+      { 
+         if(std::abs(cost) != std::abs(o.cost)) { return std::abs(cost) > std::abs(o.cost); }
+         return std::make_tuple(i,j,k) < std::make_tuple(o.i,o.j,o.k);
+      }
       bool operator==(const triplet_candidate& o) const { return i == o.i && j == o.j && k == o.k; }
 
       double cost;
       std::size_t i,j,k; 
    };
 
+   // merge lists of candidates found by individual threads into one sorted list.
+   // Lists are sorted in parallel and then merged pairwise in a fixed order, so the result is identical for any number of threads if operator< is a total order.
+   template<typename T>
+   std::vector<T> merge_thread_local_candidates(std::vector<std::vector<T>>& candidates_local)
+   {
+      if(candidates_local.size() == 0) { return {}; }
+
+#pragma omp parallel for schedule(dynamic)
+      for(std::size_t t=0; t<candidates_local.size(); ++t) {
+         std::sort(candidates_local[t].begin(), candidates_local[t].end());
+      }
+
+      for(std::size_t stride=1; stride<candidates_local.size(); stride*=2) {
+         const std::size_t no_merges = (candidates_local.size() + 2*stride - 1) / (2*stride);
+#pragma omp parallel for schedule(dynamic)
+         for(std::size_t m=0; m<no_merges; ++m) {
+            const std::size_t t = 2*stride*m;
+            if(t + stride >= candidates_local.size()) { continue; }
+            auto& a = candidates_local[t];
+            auto& b = candidates_local[t+stride];
+            std::vector<T> merged;
+            merged.reserve(a.size() + b.size());
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(merged));
+            a = std::move(merged);
+            b = std::vector<T>();
+         }
+      }
+
+      return std::move(candidates_local[0]);
+   }
+
 template<typename MRF_CONSTRUCTOR>
 class triplet_search 
 {
@@ -73,13 +112,13 @@ public:
          std::sort(adjacency_list[i].begin(), adjacency_list[i].end());
       }
 
-      std::vector<triplet_candidate> triplet_candidates;
+      std::vector<std::vector<triplet_candidate>> triplet_candidates_local(omp_get_max_threads());
 
       // Iterate over all of the edge intersection sets
 #pragma omp parallel 
       {
          std::vector<std::size_t> commonNodes(gm_.get_number_of_variables()-1);
-         std::vector<triplet_candidate> triplet_candidates_local;
+         auto& triplet_candidates_thread = triplet_candidates_local[omp_get_thread_num()];
 #pragma omp for schedule(guided)
          for(size_t factorId=0; factorId<gm_.get_number_of_pairwise_factors(); factorId++) {
             auto vars = gm_.get_pairwise_variables(factorId);
@@ -108,19 +147,13 @@ public:
                assert(bound >=  - eps);
                if(bound > eps_) {
                   triplet_candidate t(i,j,k, bound);
-                  triplet_candidates_local.push_back(t);
+                  triplet_candidates_thread.push_back(t);
                }
             }
          }
-#pragma omp critical
-         {
-            triplet_candidates.insert(triplet_candidates.end(), triplet_candidates_local.begin(), triplet_candidates_local.end());
-         }
       }
 
-      std::sort(triplet_candidates.begin(), triplet_candidates.end());
-
-      return std::move(triplet_candidates);
+      return merge_thread_local_candidates(triplet_candidates_local);
    }
 
 protected:
@@ -201,7 +234,12 @@ protected:
    { 
        weighted_edge(const std::size_t i, const std::size_t j, const double c) : std::array<std::size_t,2>({i,j}), cost(c) {}
        double cost; 
-       bool operator<(const weighted_edge& o) const { return cost > o.cost; } 
+       // total order for thread count independent sorting
+       bool operator<(const weighted_edge& o) const
+       {
+          if(cost != o.cost) { return cost > o.cost; }
+          return static_cast<const std::array<std::size_t,2>&>(*this) < static_cast<const std::array<std::size_t,2>&>(o);
+       }
    };
    std::vector<weighted_edge> projection_edges_;
    std::vector<std::size_t> proj_graph_offsets_;
@@ -322,8 +360,10 @@ k_ary_cycle_inequalities_search<MRF_CONSTRUCTOR, EXTENDED>::find_cycles(const st
       } 
    }
 
-   std::vector<triplet_candidate> triplet_candidates;
-   std::vector<bool> already_searched(proj_graph_to_gm_node_.size(),false);
+   std::vector<std::vector<triplet_candidate>> triplet_candidates_local(omp_get_max_threads());
+   std::size_t no_triplet_candidates = 0;
+   // not std::vector<bool>, since threads write to neighboring entries concurrently
+   std::vector<char> already_searched(proj_graph_to_gm_node_.size(),false);
    // first update union find datastructure by merging additional edges with cost greater than th
    double th = 0.5*largest_th;
    for(std::size_t iter=0; iter<8 && th>=eps_; ++iter, th*=0.1) {
@@ -340,9 +380,10 @@ k_ary_cycle_inequalities_search<MRF_CONSTRUCTOR, EXTENDED>::find_cycles(const st
       }
 
       // now actually search for odd signed cycles
-#pragma omp parallel
+#pragma omp parallel reduction(+:no_triplet_candidates)
       {
-         std::vector<triplet_candidate> triplet_candidates_local;
+         auto& triplet_candidates_thread = triplet_candidates_local[omp_get_thread_num()];
+         const std::size_t no_triplet_candidates_prev = triplet_candidates_thread.size();
          bfs_data bfs(proj_graph_);
 #pragma omp for schedule(guided)
          for(std::size_t i=0; i<proj_graph_to_gm_node_.size(); ++i) {
@@ -352,21 +393,18 @@ k_ary_cycle_inequalities_search<MRF_CONSTRUCTOR, EXTENDED>::find_cycles(const st
                auto cycle = bfs.find_path(2*i, 2*i+1, decltype(bfs)::no_mask_op, [&th](const std::size_t i, const std::size_t j, const double w) { th = std::min(th,w); });
                assert(cycle.size() >= 3);
                if(cycle.size() >= 3) {
-                  triangulate(triplet_candidates_local, std::move(cycle), th);
+                  triangulate(triplet_candidates_thread, std::move(cycle), th);
                }
             }
          }
-#pragma omp critical
-         {
-            triplet_candidates.insert(triplet_candidates.end(), triplet_candidates_local.begin(), triplet_candidates_local.end()); 
-         }
+         no_triplet_candidates += triplet_candidates_thread.size() - no_triplet_candidates_prev;
       }
-      if(triplet_candidates.size() > max_triplets) {
+      if(no_triplet_candidates > max_triplets) {
          break;
       }
    }
 
-   std::sort(triplet_candidates.begin(), triplet_candidates.end());
+   auto triplet_candidates = merge_thread_local_candidates(triplet_candidates_local);
    if(triplet_candidates.size() > 0) {
       assert(triplet_candidates[0].cost >= triplet_candidates.back().cost);
    }
@@ -704,9 +742,10 @@ k_ary_cycle_inequalities_search<MRF_CONSTRUCTOR, EXTENDED>::construct_projection
       } 
    };
 
+   std::vector<std::vector<weighted_edge>> projection_edges_thread(omp_get_max_threads());
 #pragma omp parallel
    {
-      auto projection_edges_local = projection_edges_;
+      auto& projection_edges_local = projection_edges_thread[omp_get_thread_num()];
 #pragma omp for schedule(guided)
       for(size_t factorId=0; factorId<gm_.get_number_of_pairwise_factors(); factorId++) {
          // Get the two nodes i & j and the edge intersection set. Put in right order.
@@ -779,30 +818,27 @@ k_ary_cycle_inequalities_search<MRF_CONSTRUCTOR, EXTENDED>::construct_projection
             }
          }
       }
-#pragma omp critical
-      {
-         projection_edges_.insert(projection_edges_.end(), projection_edges_local.begin(), projection_edges_local.end());
-      }
    }
 
-    std::vector<weighted_edge> doubled_edges;
-    doubled_edges.reserve(2*projection_edges_.size());
+   // sort before building the graph, so that its adjacency order and hence the cycles found by bfs do not depend on thread scheduling
+   projection_edges_ = merge_thread_local_candidates(projection_edges_thread);
 
-    for(const auto edge : projection_edges_) {
+    std::vector<weighted_edge> doubled_edges(2*projection_edges_.size(), weighted_edge(0,0,0.0));
+#pragma omp parallel for schedule(static)
+    for(std::size_t e=0; e<projection_edges_.size(); ++e) {
+        const auto& edge = projection_edges_[e];
         const auto cost = edge.cost;
         const auto n = edge[0];
         const auto m = edge[1];
         if(cost < 0.0) {
-            doubled_edges.push_back(weighted_edge(2*n, 2*m, -cost));
-            doubled_edges.push_back(weighted_edge(2*n+1, 2*m+1, -cost));
+            doubled_edges[2*e] = weighted_edge(2*n, 2*m, -cost);
+            doubled_edges[2*e+1] = weighted_edge(2*n+1, 2*m+1, -cost);
         } else {
-            doubled_edges.push_back(weighted_edge(2*n, 2*m+1, cost));
-            doubled_edges.push_back(weighted_edge(2*n+1, 2*m, cost));
+            doubled_edges[2*e] = weighted_edge(2*n, 2*m+1, cost);
+            doubled_edges[2*e+1] = weighted_edge(2*n+1, 2*m, cost);
         }
     }
    proj_graph_ = graph<double>(doubled_edges.begin(), doubled_edges.end(), [](const auto& weighted_graph) { return weighted_graph.cost; });
-
-   std::sort(projection_edges_.begin(), projection_edges_.end());
 }
 } // end namespace LPMP
 
@@ -13,6 +13,7 @@ namespace LPMP {
 
 struct FMC_SRMP { // equivalent to SRMP or TRWS
    constexpr static const char* name = "SRMP for pairwise case = TRWS";
+   constexpr static bool batched_factor_update = true;
 
    using UnaryFactor = FactorContainer<UnarySimplexFactor, FMC_SRMP, 0, true >;
    using PairwiseFactor = FactorContainer<PairwiseSimplexFactor, FMC_SRMP, 1, false >;
@@ -29,6 +30,7 @@ struct FMC_SRMP { // equivalent to SRMP or TRWS
 
 struct FMC_SRMP_T { // equivalent to SRMP or TRWS
    constexpr static const char* name = "SRMP for pairwise case with tightening triplets";
+   constexpr static bool batched_factor_update = true;
 
    using UnaryFactor = FactorContainer<UnarySimplexFactor, FMC_SRMP_T, 0, true>;
    using PairwiseFactor = FactorContainer<PairwiseSimplexFactor, FMC_SRMP_T, 1, false>;
@@ -55,6 +57,7 @@ struct FMC_SRMP_T { // equivalent to SRMP or TRWS
 
 struct FMC_MPLP {
    constexpr static const char* name = "MPLP for pairwise case";
+   constexpr static bool batched_factor_update = true;
 
    using UnaryFactor = FactorContainer<UnarySimplexFactor, FMC_MPLP, 0, true>;
    using PairwiseFactor = FactorContainer<PairwiseSimplexFactor, FMC_MPLP, 1, false>;
@@ -8,7 +8,7 @@ namespace LPMP {
 // do zrobienia: if pairwise was supplied to us (e.g. external factor, then reflect this in constructor and only allocate space for messages.
 // When tightening, we can simply replace pairwise pointer to external factor with an explicit copy. Reallocate left_msg_ and right_msg_ to make memory contiguous? Not sure, depends whether we use block_allocator, which will not acually release the memory
 // when factor is copied, then pairwise_ must only be copied if it is actually modified. This depends on whether we execute SMRP or MPLP style message passing. Templatize for this possibility
-class PairwiseSimplexFactor : public matrix_expression<double, PairwiseSimplexFactor> {
+class PairwiseSimplexFactor : public matrix_expression<REAL, PairwiseSimplexFactor> {
 public:
    PairwiseSimplexFactor(const std::size_t _dim1, const std::size_t _dim2);
    template<typename MATRIX>
@@ -18,8 +18,8 @@ public:
    void operator=(const PairwiseSimplexFactor& o);
    double operator[](const std::size_t x) const;
    double operator()(const std::size_t x1, const std::size_t x2) const;
-   double& cost(const std::size_t x1, const std::size_t x2);
-   double& cost(const std::size_t idx);
+   REAL& cost(const std::size_t x1, const std::size_t x2);
+   REAL& cost(const std::size_t idx);
    double LowerBound() const;
    template<std::size_t N>
    double lower_bound_except(const std::array<std::size_t,N> indices) const;
@@ -28,21 +28,21 @@ public:
    std::size_t dim1() const { return left_msg_.size(); }
    std::size_t dim2() const { return right_msg_.size(); }
    std::size_t dim(const std::size_t d) const;
-   double& pairwise(const std::size_t x1, const std::size_t x2) { assert(x1<dim1() && x2<dim2()); return pairwise_(x1,x2); }
-   double& msg1(const std::size_t x1) { assert(x1<dim1()); return left_msg_[x1]; }
-   double& msg2(const std::size_t x2) { assert(x2<dim2()); return right_msg_[x2]; }
+   REAL& pairwise(const std::size_t x1, const std::size_t x2) { assert(x1<dim1() && x2<dim2()); return pairwise_(x1,x2); }
+   REAL& msg1(const std::size_t x1) { assert(x1<dim1()); return left_msg_[x1]; }
+   REAL& msg2(const std::size_t x2) { assert(x2<dim2()); return right_msg_[x2]; }
    void init_primal();
    double EvaluatePrimal() const;
    void MaximizePotentialAndComputePrimal();
 
    template<class ARCHIVE> void serialize_primal(ARCHIVE& ar) { ar( primal_[0], primal_[1] ); }
-   //template<class ARCHIVE> void serialize_dual(ARCHIVE& ar) { ar( cereal::binary_data( pairwise_, sizeof(double)*(size()+dim1()+dim2()) ) ); }
+   //template<class ARCHIVE> void serialize_dual(ARCHIVE& ar) { ar( cereal::binary_data( pairwise_, sizeof(REAL)*(size()+dim1()+dim2()) ) ); }
    template<class ARCHIVE> void serialize_dual(ARCHIVE& ar) { ar( left_msg_, right_msg_, pairwise_ ); }
 
    auto export_variables() { return std::tie(left_msg_, right_msg_, pairwise_); }
 
-   vector<double> min_marginal_1() const;
-   vector<double> min_marginal_2() const;
+   vector<REAL> min_marginal_1() const;
+   vector<REAL> min_marginal_2() const;
 
    template<typename ARRAY>
    void apply(ARRAY& a) const;
@@ -55,11 +55,11 @@ public:
    std::array<std::size_t,2>& primal() { return primal_; }
 
 private:
-   mutable matrix<double> pairwise_;
+   mutable matrix<REAL> pairwise_;
    std::array<std::size_t,2> get_indices(const std::size_t idx) const;
    std::size_t get_index(const std::size_t x, const std::size_t y) const;
-   vector<double> left_msg_;
-   vector<double> right_msg_;
+   vector<REAL> left_msg_;
+   vector<REAL> right_msg_;
    std::array<std::size_t,2> primal_;
 };
 
@@ -113,11 +113,11 @@ void PairwiseSimplexFactor::convert_primal(SOLVER& s, typename SOLVER::vector le
 template<std::size_t N>
 double PairwiseSimplexFactor::lower_bound_except(const std::array<std::size_t,N> indices) const
 {
-   std::array<double,N> vars;
+   std::array<REAL,N> vars;
    for(std::size_t i=0; i<N;++i) {
       const auto [x,y] = get_indices(indices[i]);
       vars[i] = pairwise_(x,y);
-      pairwise_(x,y) = std::numeric_limits<double>::infinity();
+      pairwise_(x,y) = std::numeric_limits<REAL>::infinity();
    }
    const double lb = LowerBound();
    for(std::size_t i=0; i<N;++i) {
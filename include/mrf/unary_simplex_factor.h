@@ -4,9 +4,9 @@
 
 namespace LPMP {
 
-class UnarySimplexFactor : public vector<double> {
+class UnarySimplexFactor : public vector<REAL> {
 public:
-    using vector<double>::vector;
+    using vector<REAL>::vector;
 
     UnarySimplexFactor(std::size_t dim) : vector(dim, 0.0) {}
 
@@ -20,9 +20,9 @@ public:
 
    // load/store function for the primal value
    template<class ARCHIVE> void serialize_primal(ARCHIVE& ar) { ar(primal_); }
-   template<class ARCHIVE> void serialize_dual(ARCHIVE& ar) { ar( *static_cast<vector<double>*>(this) ); }
+   template<class ARCHIVE> void serialize_dual(ARCHIVE& ar) { ar( *static_cast<vector<REAL>*>(this) ); }
 
-   auto export_variables() { return std::tie(*static_cast<vector<double>*>(this)); }
+   auto export_variables() { return std::tie(*static_cast<vector<REAL>*>(this)); }
 
    void init_primal() { primal_ = std::numeric_limits<std::size_t>::max(); }
    std::size_t primal() const { return primal_; }
@@ -7,4 +7,7 @@ namespace LPMP {
 
     multicut_edge_labeling greedy_additive_edge_contraction_parallel(const multicut_instance& instance, const int nr_threads, const std::string option);
 
+    // option "concurrent" of the above. Edges that still conflict with other threads after max_conflict_rounds retries are contracted serially at the end.
+    multicut_edge_labeling greedy_additive_edge_contraction_concurrent(const multicut_instance& instance, const int nr_threads, const std::size_t max_conflict_rounds = 16);
+
 }
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <limits>
+#include "multicut_instance.h"
+#include "graph.hxx"
+
+namespace LPMP {
+
+    // Kernighan&Lin local search for multicut working directly on multicut_instance, without converting to andres' graph.
+    // Each outer iteration considers all pairs of adjacent clusters and all pairs of a cluster with a new empty one.
+    // Pairs are grouped into rounds in which every cluster occurs at most once. Two-cluster moves of one round are computed in parallel and applied in a fixed order afterwards.
+    // Hence the result does not depend on the number of threads.
+    // The adjacency structure is built once on construction and reused by subsequent calls of optimize.
+    class multicut_kernighan_lin_parallel {
+        public:
+            multicut_kernighan_lin_parallel(const multicut_instance& instance);
+
+            multicut_node_labeling optimize(multicut_node_labeling labeling, const int nr_threads, const std::size_t max_outer_iterations = 100) const;
+            multicut_edge_labeling optimize(const multicut_edge_labeling& labeling, const int nr_threads, const std::size_t max_outer_iterations = 100) const;
+
+        private:
+            constexpr static std::size_t new_cluster = std::numeric_limits<std::size_t>::max();
+
+            struct two_cluster_moves {
+                double gain = 0.0;
+                std::vector<std::size_t> to_first;
+                std::vector<std::size_t> to_second;
+            };
+
+            // nodes of each cluster: cluster_nodes[cluster_offsets[c]], ..., cluster_nodes[cluster_offsets[c+1]-1]
+            two_cluster_moves optimize_cluster_pair(const std::vector<std::size_t>& cluster_offsets, const std::vector<std::size_t>& cluster_nodes, const std::size_t first, const std::size_t second) const;
+            std::vector<std::vector<std::array<std::size_t,2>>> cluster_pair_rounds(const multicut_node_labeling& labeling, const std::size_t no_clusters, const std::vector<char>& changed) const;
+
+            const multicut_instance& instance_;
+            graph<double> g_;
+    };
+
+    multicut_edge_labeling compute_multicut_kernighan_lin_parallel(const multicut_instance& instance, const multicut_edge_labeling& labeling, const int nr_threads);
+    // warm start from parallel greedy additive edge contraction
+    multicut_edge_labeling compute_multicut_gaec_kernighan_lin_parallel(const multicut_instance& instance, const int nr_threads);
+
+}
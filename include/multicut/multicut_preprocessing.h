@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cassert>
+#include "multicut_instance.h"
+
+namespace LPMP {
+
+    // Decides edges of a multicut instance by persistency criteria before solving it:
+    // - an edge whose positive cost is at least the summed absolute cost of all other edges at one of its endpoints is contracted,
+    // - a node whose edges all have nonpositive cost is separated from its neighbours,
+    // - leaves are contracted into their neighbour or cut off, depending on the sign of their edge. Hence dangling trees are removed entirely,
+    // - edges of zero cost are removed.
+    // The rules are applied until no further edge can be decided. The remaining reduced instance decomposes into connected components that can be solved independently.
+    // Labelings of the reduced instance resp. of its components are lifted back to labelings of the original instance.
+    class multicut_reduction {
+        public:
+            multicut_reduction(const multicut_instance& instance);
+
+            // nodes of the reduced instance are consecutive. Its constant holds the cost of all decided edges.
+            const multicut_instance& reduced_instance() const { return reduced_instance_; }
+            double decided_cost() const { return decided_cost_; }
+            std::size_t no_decided_edges() const { return no_decided_edges_; }
+
+            std::size_t no_components() const { return components_.size(); }
+            const multicut_instance& component(const std::size_t c) const { assert(c < no_components()); return components_[c]; }
+
+            multicut_node_labeling lift(const multicut_node_labeling& reduced_labeling) const;
+            multicut_edge_labeling lift(const multicut_instance& original_instance, const multicut_edge_labeling& reduced_labeling) const;
+            multicut_node_labeling lift(const std::vector<multicut_node_labeling>& component_labelings) const;
+
+        private:
+            constexpr static std::size_t no_node = std::numeric_limits<std::size_t>::max();
+
+            // one round of all reduction rules on instance with given number of nodes. Updates contracted_node_ and returns whether an edge was decided.
+            bool reduce(multicut_instance& instance, std::size_t& no_nodes);
+            void compute_components();
+
+            std::vector<std::size_t> contracted_node_; // original nodes contracted together share the same index
+            std::vector<std::size_t> reduced_node_; // node of reduced instance for every contracted node, no_node for contracted nodes without edges
+            multicut_instance reduced_instance_;
+            std::vector<std::size_t> component_; // component of every node of the reduced instance
+            std::vector<std::size_t> component_node_; // index of every node of the reduced instance inside its component
+            std::vector<multicut_instance> components_;
+            double decided_cost_ = 0.0;
+            std::size_t no_decided_edges_ = 0;
+    };
+
+} // namespace LPMP
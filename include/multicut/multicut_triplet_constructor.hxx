@@ -3,12 +3,14 @@
 #include <vector>
 #include <cassert>
 #include <future>
+#include <optional>
 #include "cut_base/cut_base_triplet_constructor.hxx"
 #include "multicut_instance.h"
 #include "multicut_cycle_packing.h"
 #include "graph.hxx"
 #include "multicut_greedy_additive_edge_contraction.h"
 #include "multicut_greedy_edge_fixation.h"
+#include "multicut_preprocessing.h"
 
 namespace LPMP {
 
@@ -51,12 +53,19 @@ public:
    void ComputePrimal();
    void Begin();
    void End();
+   template<typename STREAM>
+       void WritePrimal(STREAM& s);
 protected:
     std::future<multicut_edge_labeling> primal_result_handle_;
 
     TCLAP::ValueArg<std::string> rounding_method_arg_;
     TCLAP::SwitchArg no_informative_factors_arg_;
     TCLAP::SwitchArg no_tightening_packing_arg_;
+    TCLAP::SwitchArg preprocessing_arg_;
+
+    // when preprocessing, factors are built on the reduced instance only
+    std::optional<multicut_reduction> reduction_;
+    multicut_instance original_instance_;
 };
 
 template<class FACTOR_MESSAGE_CONNECTION, typename UNARY_FACTOR, typename TRIPLET_FACTOR, typename UNARY_TRIPLET_MESSAGE_0, typename UNARY_TRIPLET_MESSAGE_1, typename UNARY_TRIPLET_MESSAGE_2>
@@ -66,6 +75,7 @@ multicut_triplet_constructor<FACTOR_MESSAGE_CONNECTION, UNARY_FACTOR, TRIPLET_FA
         rounding_method_arg_("", "multicutRounding", "method for rounding primal solution", false, "gaec", "{gaec|gef}", s.get_cmd()),
         no_informative_factors_arg_("", "noInformativeFactorReparametrization", "do not make factors informative when rounding and tightening", s.get_cmd(), false),
         no_tightening_packing_arg_("", "noTighteningPacking", "do not pack inequalities after tightening", s.get_cmd(), false),
+        preprocessing_arg_("", "multicutPreprocessing", "contract persistent edges, remove dangling trees and separate nodes without attractive edges before building the relaxation", s.get_cmd(), false),
         base_constructor(s)
 {}
 
@@ -225,6 +235,14 @@ template<class FACTOR_MESSAGE_CONNECTION, typename UNARY_FACTOR, typename TRIPLE
    void multicut_triplet_constructor<FACTOR_MESSAGE_CONNECTION, UNARY_FACTOR, TRIPLET_FACTOR, UNARY_TRIPLET_MESSAGE_0, UNARY_TRIPLET_MESSAGE_1, UNARY_TRIPLET_MESSAGE_2>::construct(multicut_instance mc)
    {
        mc.normalize();
+       if(preprocessing_arg_.getValue()) {
+           reduction_.emplace(mc);
+           if(debug())
+               std::cout << "preprocessing decided " << reduction_->no_decided_edges() << " of " << mc.no_edges() << " edges, " << reduction_->no_components() << " components remain\n";
+           this->lp_->add_to_constant(reduction_->decided_cost());
+           original_instance_ = std::move(mc);
+           mc = reduction_->reduced_instance();
+       }
        for(const auto& e : mc.edges())
            this->add_edge_factor(e[0], e[1], e.cost);
        this->no_original_edges_ = this->unary_factors_vector_.size();
@@ -349,6 +367,24 @@ void multicut_triplet_constructor<FACTOR_MESSAGE_CONNECTION, UNARY_FACTOR, TRIPL
     }
 }
 
+template<class FACTOR_MESSAGE_CONNECTION, typename UNARY_FACTOR, typename TRIPLET_FACTOR, typename UNARY_TRIPLET_MESSAGE_0, typename UNARY_TRIPLET_MESSAGE_1, typename UNARY_TRIPLET_MESSAGE_2>
+    template<typename STREAM>
+void multicut_triplet_constructor<FACTOR_MESSAGE_CONNECTION, UNARY_FACTOR, TRIPLET_FACTOR, UNARY_TRIPLET_MESSAGE_0, UNARY_TRIPLET_MESSAGE_1, UNARY_TRIPLET_MESSAGE_2>::WritePrimal(STREAM& s)
+{
+    if(!reduction_) {
+        base_constructor::WritePrimal(s);
+        return;
+    }
+
+    // lift labeling of reduced instance back to original edges
+    multicut_edge_labeling reduced_labeling;
+    for(std::size_t e=0; e<this->no_original_edges_; ++e)
+        reduced_labeling.push_back(this->unary_factors_vector_[e].second->get_factor()->primal()[0]);
+    const multicut_edge_labeling labeling = reduction_->lift(original_instance_, reduced_labeling);
+    for(std::size_t e=0; e<original_instance_.no_edges(); ++e)
+        s << original_instance_.edges()[e][0] << " " << original_instance_.edges()[e][1] << " " << int(labeling[e]) << "\n";
+}
+
 //template<class FACTOR_MESSAGE_CONNECTION, typename UNARY_FACTOR, typename TRIPLET_FACTOR, typename UNARY_TRIPLET_MESSAGE_0, typename UNARY_TRIPLET_MESSAGE_1, typename UNARY_TRIPLET_MESSAGE_2>
 //   std::vector<char> multicut_triplet_constructor<FACTOR_MESSAGE_CONNECTION, UNARY_FACTOR, TRIPLET_FACTOR, UNARY_TRIPLET_MESSAGE_0, UNARY_TRIPLET_MESSAGE_1, UNARY_TRIPLET_MESSAGE_2>::round(std::vector<typename base_constructor::edge> edges)
 //   {
@@ -0,0 +1,61 @@
+#ifndef LPMP_PARALLEL_MESSAGE_PASSING_SCHEDULE_HXX
+#define LPMP_PARALLEL_MESSAGE_PASSING_SCHEDULE_HXX
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+#include "two_dimensional_variable_array.hxx"
+#include "factor_container_interface.h"
+
+namespace LPMP {
+
+// Group the factors of an update ordering into levels such that all factors of one level can be updated concurrently.
+// Updating a factor reads and writes its own potential, its messages and the potentials of its adjacent factors.
+// Hence two factor updates conflict if their footprints (factor + adjacent factors) intersect.
+// Every factor is put one level past the highest level of any preceding conflicting factor.
+// Consequently, conflicting factors are updated in the same order as in the sequential pass and the result is identical to it.
+// Returned are, for each level, the positions of its factors in the update ordering.
+template<typename FACTOR_ITERATOR, typename FACTOR_INDEX_FUNC>
+two_dim_variable_array<std::size_t> compute_parallel_update_levels(FACTOR_ITERATOR factor_begin, FACTOR_ITERATOR factor_end, const std::size_t no_factors, FACTOR_INDEX_FUNC factor_index)
+{
+   const std::size_t n = std::distance(factor_begin, factor_end);
+   // one past the highest level of an update touching the factor, zero if factor has not been touched yet
+   std::vector<std::size_t> next_free_level(no_factors, 0);
+   std::vector<std::size_t> level(n);
+   std::size_t no_levels = 0;
+
+   for(std::size_t i=0; i<n; ++i) {
+      auto* f = *(factor_begin + i);
+      const std::size_t f_idx = factor_index(f);
+      assert(f_idx < no_factors);
+      const auto adjacent_factors = f->get_adjacent_factors();
+
+      std::size_t l = next_free_level[f_idx];
+      for(auto* a : adjacent_factors) {
+         l = std::max(l, next_free_level[factor_index(a)]);
+      }
+
+      level[i] = l;
+      next_free_level[f_idx] = l+1;
+      for(auto* a : adjacent_factors) {
+         next_free_level[factor_index(a)] = l+1;
+      }
+      no_levels = std::max(no_levels, l+1);
+   }
+
+   std::vector<std::size_t> level_size(no_levels, 0);
+   for(const std::size_t l : level) { level_size[l]++; }
+
+   two_dim_variable_array<std::size_t> levels(level_size.begin(), level_size.end());
+   std::fill(level_size.begin(), level_size.end(), 0);
+   for(std::size_t i=0; i<n; ++i) {
+      levels(level[i], level_size[level[i]]++) = i;
+   }
+
+   return levels;
+}
+
+} // namespace LPMP
+
+#endif // LPMP_PARALLEL_MESSAGE_PASSING_SCHEDULE_HXX
@@ -6,6 +6,12 @@
 #include "vector.hxx"
 #include <bitset>
 #include <cstring>
+#include <string>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace LPMP {
 
@@ -224,6 +230,57 @@ private:
   char* cur_;
 };
 
+// file mapped into memory, so that archives can be written to and read from disk without intermediate copies
+class memory_mapped_file {
+public:
+   // create or truncate file to given size for writing
+   memory_mapped_file(const std::string& filename, const std::size_t size_in_bytes)
+   : size_(size_in_bytes)
+   {
+      fd_ = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if(fd_ < 0) { throw std::runtime_error("could not open file " + filename); }
+      if(::ftruncate(fd_, size_) != 0) { ::close(fd_); throw std::runtime_error("could not resize file " + filename); }
+      map(PROT_READ | PROT_WRITE, filename);
+   }
+
+   // map existing file read-only
+   memory_mapped_file(const std::string& filename)
+   {
+      fd_ = ::open(filename.c_str(), O_RDONLY);
+      if(fd_ < 0) { throw std::runtime_error("could not open file " + filename); }
+      struct stat st;
+      if(::fstat(fd_, &st) != 0) { ::close(fd_); throw std::runtime_error("could not read size of file " + filename); }
+      size_ = st.st_size;
+      map(PROT_READ, filename);
+   }
+
+   memory_mapped_file(const memory_mapped_file&) = delete;
+   memory_mapped_file& operator=(const memory_mapped_file&) = delete;
+
+   ~memory_mapped_file()
+   {
+      if(data_ != nullptr) { ::munmap(data_, size_); }
+      if(fd_ >= 0) { ::close(fd_); }
+   }
+
+   char* data() { return data_; }
+   const char* data() const { return data_; }
+   std::size_t size() const { return size_; }
+
+private:
+   void map(const int protection, const std::string& filename)
+   {
+      if(size_ == 0) { return; } // mmap does not accept empty mappings
+      void* p = ::mmap(nullptr, size_, protection, MAP_SHARED, fd_, 0);
+      if(p == MAP_FAILED) { ::close(fd_); fd_ = -1; throw std::runtime_error("could not map file " + filename); }
+      data_ = static_cast<char*>(p);
+   }
+
+   int fd_ = -1;
+   char* data_ = nullptr;
+   std::size_t size_ = 0;
+};
+
 // write data into archive
 class save_archive {
 public:
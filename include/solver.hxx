@@ -4,6 +4,8 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <future>
+#include <chrono>
 #include <fstream>
 #include <sstream>
 
@@ -100,8 +102,13 @@ namespace LPMP {
                 LPMP_FUNCTION_EXISTENCE_CLASS(has_solution,solution)
                     constexpr static bool visitor_has_solution();
 
+                // Calling Solve again, e.g. after the problem constructor has changed costs, continues from the current dual variables.
+                // Factors, messages, factor ordering and message passing weights are reused, only bounds and primal solutions are reset.
                 int Solve();
 
+                // prepare for another optimization of an already optimized problem
+                void WarmStart();
+
                 // TODO: renamce Begin functino to pre_optimization or similar
                 LPMP_FUNCTION_EXISTENCE_CLASS(has_begin,Begin)
                     constexpr static bool has_begin();
@@ -156,6 +163,18 @@ namespace LPMP {
 
                 VISITOR visitor_;
                 std::size_t iter = 0;
+                bool optimized_ = false;
+        };
+
+    // Problem constructors whose rounding can run concurrently to message passing provide
+    //   export_primal_rounding_task(): read off the current reparametrization and return a callable computing a primal result without accessing the LP,
+    //   read_in_primal_rounding(result): write the primal result into the factors.
+    template<typename PROBLEM_CONSTRUCTOR, typename = void>
+        struct primal_rounding_task_result { using type = void; };
+
+    template<typename PROBLEM_CONSTRUCTOR>
+        struct primal_rounding_task_result<PROBLEM_CONSTRUCTOR, std::void_t<decltype(std::declval<PROBLEM_CONSTRUCTOR&>().export_primal_rounding_task())>> {
+            using type = std::invoke_result_t<decltype(std::declval<PROBLEM_CONSTRUCTOR&>().export_primal_rounding_task())>;
         };
 
     // local rounding interleaved with message passing 
@@ -181,11 +200,24 @@ namespace LPMP {
 
             void ComputePrimal();
 
+            // rounding in a background thread: read in finished rounding, then start a new one on the current reparametrization
+            using primal_rounding_result_type = typename primal_rounding_task_result<typename SOLVER::problem_constructor_type>::type;
+            template<typename T>
+                using has_read_in_primal_rounding_t = decltype(std::declval<T&>().read_in_primal_rounding(std::declval<const primal_rounding_result_type&>()));
+            constexpr static bool can_round_asynchronously();
+            void ComputePrimalAsynchronously();
+            // wait for a running rounding and read it in
+            void join_primal_rounding();
+
             virtual void Begin();
 
             virtual void PostIterate(LpControl c);
 
             virtual void End();
+
+        private:
+            void read_in_primal_rounding();
+            std::future<primal_rounding_result_type> primal_rounding_handle_;
     };
 
     // rounding based on (i) interleaved message passing followed by (ii) problem constructor rounding.
@@ -354,8 +386,11 @@ namespace LPMP {
         std::size_t Solver<LP_TYPE, VISITOR>::Tighten(const std::size_t max_constraints_to_add) 
         {
             INDEX constraints_added = 0;
-            if constexpr(CanTighten())
+            if constexpr(CanTighten()) {
                 constraints_added += problem_constructor_.Tighten(max_constraints_to_add);
+                // tightening may also reparametrize existing factors
+                lp_.mark_all_dirty();
+            }
             return constraints_added;
         }
 
@@ -373,7 +408,12 @@ namespace LPMP {
             }
 
             LpControl c = visitor_.begin(this->lp_);
-            this->Begin();
+            if(optimized_) {
+                WarmStart();
+            } else {
+                this->Begin();
+                optimized_ = true;
+            }
             while(!c.end && !c.error) {
                 this->PreIterate(c);
                 this->Iterate(c);
@@ -396,6 +436,16 @@ namespace LPMP {
         }
 
 
+    template<typename LP_TYPE, typename VISITOR>
+        void Solver<LP_TYPE, VISITOR>::WarmStart()
+        {
+            // problem constructor's Begin and order_factors have already been called, only the LP needs to discard cost dependent quantities
+            lp_.Begin();
+            lowerBound_ = -std::numeric_limits<double>::infinity();
+            bestPrimalCost_ = std::numeric_limits<double>::infinity();
+            solution_.clear();
+        }
+
     template<typename LP_TYPE, typename VISITOR>
         constexpr bool Solver<LP_TYPE, VISITOR>::has_begin()
         {
@@ -406,8 +456,10 @@ namespace LPMP {
         void Solver<LP_TYPE, VISITOR>::Begin() 
         {
             lp_.Begin(); 
-            if constexpr(has_begin())
+            if constexpr(has_begin()) {
                 problem_constructor_.Begin();
+                lp_.mark_all_dirty();
+            }
             order_factors();
         }
 
@@ -421,8 +473,11 @@ namespace LPMP {
         void Solver<LP_TYPE, VISITOR>::PreIterate(LpControl c) 
         {
             lp_.set_reparametrization(c.lp_repam);
-            if constexpr(has_pre_iterate())
+            if constexpr(has_pre_iterate()) {
                 problem_constructor_.pre_iterate();
+                // problem constructors reparametrize outside of message passing, cached factor lower bounds are stale
+                lp_.mark_all_dirty();
+            }
         } 
 
     template<typename LP_TYPE, typename VISITOR>
@@ -452,8 +507,10 @@ namespace LPMP {
     template<typename LP_TYPE, typename VISITOR>
         void Solver<LP_TYPE, VISITOR>::End() 
         {
-            if constexpr(CanCallEnd())
+            if constexpr(CanCallEnd()) {
                 problem_constructor_.End();
+                lp_.mark_all_dirty();
+            }
             lp_.End();
         }
 
@@ -515,8 +572,62 @@ namespace LPMP {
             SOLVER::lp_.init_primal();
             // compute the primal in parallel.
             // for this, first we have to wait until the rounding procedure has read off everything from the LP model before optimizing further
-            if constexpr(can_compute_primal())
+            if constexpr(can_compute_primal()) {
                 this->problem_constructor_.ComputePrimal();
+                // rounding may send messages into factors, e.g. lifted disjoint paths
+                SOLVER::lp_.mark_all_dirty();
+            }
+        }
+
+    template<typename SOLVER>
+        constexpr bool ProblemConstructorRoundingSolver<SOLVER>::can_round_asynchronously()
+        {
+            if constexpr(std::is_void<primal_rounding_result_type>::value)
+                return false;
+            else
+                return is_detected<has_read_in_primal_rounding_t, typename SOLVER::problem_constructor_type>::value;
+        }
+
+    template<typename SOLVER>
+        void ProblemConstructorRoundingSolver<SOLVER>::read_in_primal_rounding()
+        {
+            if constexpr(can_round_asynchronously()) {
+                assert(primal_rounding_handle_.valid());
+                const auto result = primal_rounding_handle_.get();
+                if(debug()) { std::cout << "read in asynchronously computed primal\n"; }
+                SOLVER::lp_.init_primal();
+                this->problem_constructor_.read_in_primal_rounding(result);
+                SOLVER::lp_.mark_all_dirty();
+                this->RegisterPrimal();
+            }
+        }
+
+    template<typename SOLVER>
+        void ProblemConstructorRoundingSolver<SOLVER>::ComputePrimalAsynchronously()
+        {
+            if constexpr(can_round_asynchronously()) {
+                if(primal_rounding_handle_.valid()) {
+                    if(primal_rounding_handle_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                        return; // previous rounding still running, message passing continues
+                    read_in_primal_rounding();
+                }
+                // the task holds a snapshot of the reparametrization, hence the LP may change while it runs
+                auto task = this->problem_constructor_.export_primal_rounding_task();
+                // exporting may reparametrize, e.g. multigraph matching sends messages to unaries
+                SOLVER::lp_.mark_all_dirty();
+                primal_rounding_handle_ = std::async(std::launch::async, std::move(task));
+            }
+        }
+
+    template<typename SOLVER>
+        void ProblemConstructorRoundingSolver<SOLVER>::join_primal_rounding()
+        {
+            if constexpr(can_round_asynchronously()) {
+                if(primal_rounding_handle_.valid()) {
+                    primal_rounding_handle_.wait();
+                    read_in_primal_rounding();
+                }
+            }
         }
 
     template<typename SOLVER>
@@ -531,8 +642,12 @@ namespace LPMP {
         void ProblemConstructorRoundingSolver<SOLVER>::PostIterate(LpControl c)
         {
             if(c.computePrimal) {
-                ComputePrimal();
-                this->RegisterPrimal();
+                if constexpr(can_round_asynchronously()) {
+                    ComputePrimalAsynchronously();
+                } else {
+                    ComputePrimal();
+                    this->RegisterPrimal();
+                }
             }
             SOLVER::PostIterate(c);
         }
@@ -541,6 +656,7 @@ namespace LPMP {
         void ProblemConstructorRoundingSolver<SOLVER>::End()
         {
             SOLVER::End(); // first let problem constructors end (done in Solver)
+            join_primal_rounding();
             this->RegisterPrimal();
         }
 
@@ -4,6 +4,8 @@
 #include <cassert>
 #include <limits>
 #include <numeric>
+#include <atomic>
+#include "atomic_helper.h"
 
 namespace LPMP {
 
@@ -107,4 +109,62 @@ class union_find {
     }
 };
 
+// Lock-free union find for concurrent merges.
+// Roots are linked to the root with smaller index by compare-and-swap, hence parent indices decrease along every path and no cycles can form.
+// find performs path halving, which is safe under concurrent updates since it only replaces a parent by one of its ancestors.
+class concurrent_union_find {
+    std::vector<CopyableAtomic<std::size_t>> id;
+
+    public:
+    void init(const std::size_t N)
+    {
+        id.resize(N);
+        for(std::size_t i=0; i<N; ++i)
+            id[i].store(i, std::memory_order_relaxed);
+    }
+
+    concurrent_union_find(const std::size_t N = 0) { init(N); }
+    std::size_t size() const { return id.size(); }
+
+    std::size_t find(std::size_t p) {
+        assert(p < size());
+        while(true) {
+            std::size_t parent = id[p].load(std::memory_order_acquire);
+            if(parent == p)
+                return p;
+            const std::size_t grandparent = id[parent].load(std::memory_order_acquire);
+            if(parent != grandparent)
+                id[p].compare_exchange_weak(parent, grandparent, std::memory_order_release, std::memory_order_relaxed);
+            p = grandparent;
+        }
+    }
+
+    // returns false if x and y were already in the same set
+    bool merge(std::size_t x, std::size_t y) {
+        while(true) {
+            x = find(x);
+            y = find(y);
+            if(x == y)
+                return false;
+            if(x < y)
+                std::swap(x,y);
+            std::size_t expected = x;
+            if(id[x].compare_exchange_strong(expected, y, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return true;
+        }
+    }
+
+    bool connected(std::size_t x, std::size_t y) {
+        while(true) {
+            x = find(x);
+            y = find(y);
+            if(x == y)
+                return true;
+            // x may have been linked concurrently after find returned
+            if(id[x].load(std::memory_order_acquire) == x)
+                return false;
+        }
+    }
+};
+
 } // namespace LPMP
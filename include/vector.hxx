@@ -12,6 +12,9 @@
 
 namespace LPMP {
 
+    // float and double storage is padded with infinities to multiples of REAL_ALIGNMENT and processed with simd_vector<T>
+    template<typename T>
+    constexpr bool simd_padded = std::is_same<T,float>::value || std::is_same<T,double>::value;
 
     // fixed size vector allocated from block allocator
     // possibly holding size explicitly is not needed: It is held by allocator as well
@@ -88,8 +91,8 @@ namespace LPMP {
 
                 static std::size_t padding(const std::size_t size)
                 {
-                    const std::size_t padding = std::is_same<REAL,T>::value ? (REAL_ALIGNMENT-(size%REAL_ALIGNMENT))%REAL_ALIGNMENT : 0;
-                    if(std::is_same<REAL,T>::value) {
+                    const std::size_t padding = simd_padded<T> ? (REAL_ALIGNMENT-(size%REAL_ALIGNMENT))%REAL_ALIGNMENT : 0;
+                    if(simd_padded<T>) {
                         assert((padding + size)%REAL_ALIGNMENT == 0);
                     }
                     return padding;
@@ -100,8 +103,10 @@ namespace LPMP {
                 }
                 void fill_padding()
                 {
-                    if(padding() != 0)
-                        std::fill(end_, end_ + padding(), std::numeric_limits<REAL>::infinity());
+                    if constexpr(simd_padded<T>) {
+                        if(padding() != 0)
+                            std::fill(end_, end_ + padding(), std::numeric_limits<T>::infinity());
+                    }
                 }
                 void fill()
                 {
@@ -113,11 +118,7 @@ namespace LPMP {
                     {
                         const std::size_t size = std::distance(begin,end);
                         assert(size > 0);
-                        //begin_ = (T*) global_real_block_arena_array[stack_allocator_index].allocate((size+padding(size))*sizeof(T),32);
-                        begin_ = (T*) std::aligned_alloc(32, (size+padding(size))*sizeof(T));
-                        //begin_ = (T*) allocator::get().malloc((size+padding(size))*sizeof(T));
-                        assert(begin_ != nullptr);
-                        end_ = begin_ + size;
+                        allocate(size);
                         for(auto it=this->begin(); begin!=end; ++begin, ++it) {
                             (*it) = *begin;
                         }
@@ -126,12 +127,8 @@ namespace LPMP {
 
                 vector(const std::size_t size) 
                 {
-                    //begin_ = (T*) global_real_block_arena_array[stack_allocator_index].allocate((size+padding(size))*sizeof(T),32);
-                    begin_ = (T*) std::aligned_alloc(32, (size+padding(size))*sizeof(T));
-                    //begin_ = (T*) allocator::get().malloc((size+padding(size))*sizeof(T));
                     assert(size > 0);
-                    assert(begin_ != nullptr);
-                    end_ = begin_ + size;
+                    allocate(size);
                     // infinities in padding
                     fill();
                 }
@@ -147,10 +144,9 @@ namespace LPMP {
                     end_(nullptr)
             {}
                 ~vector() {
-                    if(begin_ != nullptr) {
-                        //global_real_block_arena_array[stack_allocator_index].deallocate((void*)begin_);
+                    // arena memory is released together with its arena
+                    if(begin_ != nullptr && !arena_allocated_) {
                         std::free(begin_);
-                        //allocator::get().free(begin_);
                     }
                     static_assert(sizeof(T) % sizeof(int) == 0,"");
                 }
@@ -168,6 +164,7 @@ namespace LPMP {
                     assert(begin_ != o.begin_ && end_ != o.end_);
                     std::swap(begin_, o.begin_);
                     std::swap(end_, o.end_);
+                    std::swap(arena_allocated_, o.arena_allocated_);
                 }
 
                 vector& operator=(const vector<T>& o)
@@ -175,7 +172,8 @@ namespace LPMP {
                     if(size() != o.size()) {
                         vector copy(o.size());
                         std::swap(begin_, copy.begin_);
-                        std::swap(end_, copy.begin_);
+                        std::swap(end_, copy.end_);
+                        std::swap(arena_allocated_, copy.arena_allocated_);
                     }
                     assert(size() == o.size());
                     for(std::size_t i=0; i<o.size(); ++i) { 
@@ -188,16 +186,17 @@ namespace LPMP {
                 {
                     std::swap(begin_, o.begin_);
                     std::swap(end_, o.end_);
+                    std::swap(arena_allocated_, o.arena_allocated_);
                     return *this;
                 }
 
                 vector& operator+=(const vector<T>& o)
                 {
-                    static_assert(std::is_same<T,double>::value,"");
+                    static_assert(simd_padded<T>,"");
                     assert(size() == o.size());
                     for(std::size_t i=0; i<size(); i+=REAL_ALIGNMENT) {
-                        REAL_VECTOR tmp = simdpp::load( begin_+i );
-                        REAL_VECTOR v = simdpp::load(o.begin() + i);
+                        simd_vector<T> tmp = simdpp::load( begin_+i );
+                        simd_vector<T> v = simdpp::load(o.begin() + i);
                         simdpp::store(begin_ + i, tmp + v);
                     }
                     return *this;
@@ -304,11 +303,11 @@ namespace LPMP {
 
                     assert((std::size_t(begin_) % 32) == 0);
 
-                    if(std::is_same<T,double>::value) {
+                    if constexpr(simd_padded<T>) {
 
-                        REAL_VECTOR min_val = simdpp::load( begin_ );
+                        simd_vector<T> min_val = simdpp::load( begin_ );
                         for(auto it=begin_+REAL_ALIGNMENT; it<end_; it+=REAL_ALIGNMENT) {
-                            REAL_VECTOR tmp = simdpp::load( it );
+                            simd_vector<T> tmp = simdpp::load( it );
                             min_val = simdpp::min(min_val, tmp); 
                         }
                         return simdpp::reduce_min(min_val);
@@ -323,7 +322,7 @@ namespace LPMP {
                 {
                     assert(i < this->size());
                     const auto val = (*this)[i];
-                    begin_[i] = std::numeric_limits<REAL>::infinity();
+                    begin_[i] = std::numeric_limits<T>::infinity();
                     const auto min_val = this->min();
                     begin_[i] = val;
                     return min_val;
@@ -451,8 +450,26 @@ namespace LPMP {
         }
 
     private:
+    // take memory from arena of current thread if set (see monotonic_arena::scope), otherwise from heap
+    void allocate(const std::size_t size)
+    {
+        const std::size_t size_bytes = (size+padding(size))*sizeof(T);
+        monotonic_arena* arena = monotonic_arena::current();
+        if(arena != nullptr) {
+            begin_ = (T*) arena->allocate(size_bytes);
+            arena_allocated_ = true;
+        } else {
+            begin_ = (T*) std::aligned_alloc(32, size_bytes);
+            arena_allocated_ = false;
+        }
+        assert(begin_ != nullptr);
+        assert((std::size_t(begin_) % 32) == 0);
+        end_ = begin_ + size;
+    }
+
     T* begin_ = nullptr;
     T* end_ = nullptr;
+    bool arena_allocated_ = false;
 };
 
 // vector that caches minimum value
@@ -784,17 +801,17 @@ class array : public vector_expression<T,array<T,N>> {
 
         T min() const
         {
-            static_assert(std::is_same<T,REAL>::value,"");
+            static_assert(simd_padded<T>,"");
 
             if(array_.size() > REAL_ALIGNMENT) {
-                REAL_VECTOR cur_min = simdpp::load(&array_[0]);
+                simd_vector<T> cur_min = simdpp::load(&array_[0]);
                 std::size_t last_aligned = array_.size() - (array_.size()%REAL_ALIGNMENT);
                 for(auto i=REAL_ALIGNMENT; i<last_aligned; i+=REAL_ALIGNMENT) {
-                    const REAL_VECTOR tmp = simdpp::load( &array_[i] );
+                    const simd_vector<T> tmp = simdpp::load( &array_[i] );
                     cur_min = simdpp::min(cur_min, tmp); 
                 }
 
-                REAL aligned_min = simdpp::reduce_min(cur_min);
+                T aligned_min = simdpp::reduce_min(cur_min);
 
                 for(std::size_t i=last_aligned; i<array_.size(); ++i) {
                     aligned_min = std::min(aligned_min, array_[i]);
@@ -917,7 +934,7 @@ class matrix : public matrix_expression<T,matrix<T>> {
             return d1*(d2 + padding(d2));
         }
         static std::size_t padding(const std::size_t i) {
-            if constexpr(std::is_same<T,float>::value || std::is_same<T,double>::value,"")
+            if constexpr(simd_padded<T>)
                 return (REAL_ALIGNMENT-(i%REAL_ALIGNMENT))%REAL_ALIGNMENT;
             else
                 return 0;
@@ -927,7 +944,7 @@ class matrix : public matrix_expression<T,matrix<T>> {
 
         void fill_padding()
         {
-            if constexpr(std::is_same<T,float>::value || std::is_same<T,double>::value,"") {
+            if constexpr(simd_padded<T>) {
                 for(std::size_t x1=0; x1<dim1(); ++x1) {
                     for(std::size_t x2=dim2(); x2<padded_dim2(); ++x2) {
                         vec_[x1*padded_dim2() + x2] = std::numeric_limits<T>::infinity();
@@ -972,7 +989,7 @@ class matrix : public matrix_expression<T,matrix<T>> {
 
         matrix& operator+=(const matrix<T>& o)
         {
-            static_assert(std::is_same<T,double>::value,"");
+            static_assert(simd_padded<T>,"");
             assert(dim1() == o.dim1());
             assert(dim2() == o.dim2());
             vec_ += o.vec_;
@@ -1053,10 +1070,9 @@ class matrix : public matrix_expression<T,matrix<T>> {
         // should be slower than min2, but possibly it is not, because reduce_min is still a fast operation and not the bottleneck. Measure!
         vector<T> min1() const
         {
-            // this function only works if T is REAL!
-            static_assert(std::is_same<T,REAL>::value, "");
+            static_assert(simd_padded<T>, "");
             vector<T> min(dim1());
-            if(std::is_same<T,float>::value || std::is_same<T,double>::value) {
+            if constexpr(simd_padded<T>) {
                 for(std::size_t x1=0; x1<dim1(); ++x1) {
                     min[x1] = col_min(x1);
                 }
@@ -1071,7 +1087,7 @@ class matrix : public matrix_expression<T,matrix<T>> {
         vector<T> min1(const vector<T>& v) const
         {
             assert(v.size() == dim2());
-            static_assert(std::is_same<T,REAL>::value, "");
+            static_assert(simd_padded<T>, "");
             vector<T> min(dim1());
             for(std::size_t x1=0; x1<dim1(); ++x1) {
                 min[x1] = col_min(x1, v);
@@ -1082,19 +1098,19 @@ class matrix : public matrix_expression<T,matrix<T>> {
         // minima along first dimension
         vector<T> min2() const
         {
-            static_assert(std::is_same<T,REAL>::value, "");
+            static_assert(simd_padded<T>, "");
             vector<T> min(dim2());
             // possibly iteration strategy is faster, e.g. doing a non-contiguous access, or explicitly holding a few variables and not storing them back in vector min for a few sizes
-            if(std::is_same<T,float>::value || std::is_same<T,double>::value) {
+            if constexpr(simd_padded<T>) {
                 for(std::size_t x2=0; x2<dim2(); x2+=REAL_ALIGNMENT) {
-                    REAL_VECTOR tmp = simdpp::load( vec_.begin() + x2 );
+                    simd_vector<T> tmp = simdpp::load( vec_.begin() + x2 );
                     simdpp::store(&min[x2], tmp);
                 }
 
                 for(std::size_t x1=1; x1<dim1(); ++x1) {
                     for(std::size_t x2=0; x2<dim2(); x2+=REAL_ALIGNMENT) {
-                        REAL_VECTOR tmp = simdpp::load( vec_.begin() + x1*padded_dim2() + x2 );
-                        REAL_VECTOR cur_min = simdpp::load( &min[x2] );
+                        simd_vector<T> tmp = simdpp::load( vec_.begin() + x1*padded_dim2() + x2 );
+                        simd_vector<T> cur_min = simdpp::load( &min[x2] );
                         auto updated_min = simdpp::min(cur_min, tmp);
                         simdpp::store(&min[x2], updated_min);
                     } 
@@ -1109,22 +1125,22 @@ class matrix : public matrix_expression<T,matrix<T>> {
         // possibly make free function!
         vector<T> min2(const vector<T>& v) const
         {
-            static_assert(std::is_same<T,REAL>::value, "");
+            static_assert(simd_padded<T>, "");
             assert(v.size() == dim1());
             vector<T> min(dim2());
 
             for(std::size_t x2=0; x2<dim2(); x2+=REAL_ALIGNMENT) {
-                REAL_VECTOR tmp = simdpp::load( vec_.begin() + x2 );
-                REAL_VECTOR _v = simdpp::load_splat(v.begin());
-                REAL_VECTOR _sum = tmp + _v;
+                simd_vector<T> tmp = simdpp::load( vec_.begin() + x2 );
+                simd_vector<T> _v = simdpp::load_splat(v.begin());
+                simd_vector<T> _sum = tmp + _v;
                 simdpp::store(&min[x2], _sum);
             }
             for(std::size_t x1=1; x1<dim1(); ++x1) {
                 for(std::size_t x2=0; x2<dim2(); x2+=REAL_ALIGNMENT) {
-                    REAL_VECTOR tmp = simdpp::load( vec_.begin() + x1*padded_dim2() + x2 );
-                    REAL_VECTOR _v = simdpp::load_splat(v.begin() + x1);
-                    REAL_VECTOR _sum = tmp + _v;
-                    REAL_VECTOR cur_min = simdpp::load( &min[x2] );
+                    simd_vector<T> tmp = simdpp::load( vec_.begin() + x1*padded_dim2() + x2 );
+                    simd_vector<T> _v = simdpp::load_splat(v.begin() + x1);
+                    simd_vector<T> _sum = tmp + _v;
+                    simd_vector<T> cur_min = simdpp::load( &min[x2] );
                     auto updated_min = simdpp::min(cur_min, _sum);
                     simdpp::store(&min[x2], updated_min);
                 } 
@@ -1133,17 +1149,78 @@ class matrix : public matrix_expression<T,matrix<T>> {
             return min;
         }
 
+        // minimum along second dimension of matrix + v, where v is added to each row and w to each column, i.e. min_x2 m(x1,x2) + v[x2] + w[x1]
+        vector<T> min1(const vector<T>& v, const vector<T>& w) const
+        {
+            assert(v.size() == dim2() && w.size() == dim1());
+            static_assert(simd_padded<T>, "");
+            vector<T> min(dim1());
+            // each row is reduced in a register and w is added before storing, so min is written only once.
+            for(std::size_t x1=0; x1<dim1(); ++x1) {
+                const T* row = vec_.begin() + x1*padded_dim2();
+                simd_vector<T> cur_min = simdpp::load( row );
+                cur_min = cur_min + simd_vector<T>(simdpp::load( v.begin() ));
+                for(std::size_t x2=REAL_ALIGNMENT; x2<dim2(); x2+=REAL_ALIGNMENT) {
+                    simd_vector<T> tmp = simdpp::load( row + x2 );
+                    simd_vector<T> _v = simdpp::load( v.begin() + x2 );
+                    cur_min = simdpp::min(cur_min, tmp + _v);
+                }
+                min[x1] = simdpp::reduce_min(cur_min) + w[x1];
+            }
+            return min;
+        }
+
+        // minimum along first dimension of matrix + v + w, i.e. min_x1 m(x1,x2) + v[x1] + w[x2]
+        // each strip of REAL_ALIGNMENT columns is reduced over all rows in a register before storing.
+        vector<T> min2(const vector<T>& v, const vector<T>& w) const
+        {
+            assert(v.size() == dim1() && w.size() == dim2());
+            static_assert(simd_padded<T>, "");
+            vector<T> min(dim2());
+            for(std::size_t x2=0; x2<dim2(); x2+=REAL_ALIGNMENT) {
+                const T* col = vec_.begin() + x2;
+                simd_vector<T> cur_min = simdpp::load( col );
+                cur_min = cur_min + simd_vector<T>(simdpp::load_splat(v.begin()));
+                for(std::size_t x1=1; x1<dim1(); ++x1) {
+                    simd_vector<T> tmp = simdpp::load( col + x1*padded_dim2() );
+                    simd_vector<T> _v = simdpp::load_splat(v.begin() + x1);
+                    cur_min = simdpp::min(cur_min, tmp + _v);
+                }
+                simd_vector<T> _w = simdpp::load( w.begin() + x2 );
+                simdpp::store( min.begin() + x2, cur_min + _w );
+            }
+            return min;
+        }
+
         T min() const
         {
             return vec_.min();
         }
 
+        // minimum of m(x1,x2) + v[x1] + w[x2]
+        T min(const vector<T>& v, const vector<T>& w) const
+        {
+            assert(v.size() == dim1() && w.size() == dim2());
+            static_assert(simd_padded<T>, "");
+            simd_vector<T> cur_min = simdpp::make_float(std::numeric_limits<T>::infinity());
+            for(std::size_t x1=0; x1<dim1(); ++x1) {
+                const T* row = vec_.begin() + x1*padded_dim2();
+                simd_vector<T> _v = simdpp::load_splat(v.begin() + x1);
+                for(std::size_t x2=0; x2<dim2(); x2+=REAL_ALIGNMENT) {
+                    simd_vector<T> tmp = simdpp::load( row + x2 );
+                    simd_vector<T> _w = simdpp::load( w.begin() + x2 );
+                    cur_min = simdpp::min(cur_min, tmp + _w + _v);
+                }
+            }
+            return simdpp::reduce_min(cur_min);
+        }
+
         T col_min(const std::size_t x1) const
         {
             assert(x1<dim1());
-            REAL_VECTOR cur_min = simdpp::load( vec_.begin() + x1*padded_dim2() );
+            simd_vector<T> cur_min = simdpp::load( vec_.begin() + x1*padded_dim2() );
             for(std::size_t x2=REAL_ALIGNMENT; x2<dim2(); x2+=REAL_ALIGNMENT) {
-                REAL_VECTOR tmp = simdpp::load( vec_.begin() + x1*padded_dim2() + x2 );
+                simd_vector<T> tmp = simdpp::load( vec_.begin() + x1*padded_dim2() + x2 );
                 cur_min = simdpp::min(cur_min, tmp); 
             }
             return simdpp::reduce_min(cur_min); 
@@ -1152,12 +1229,12 @@ class matrix : public matrix_expression<T,matrix<T>> {
         T col_min(const std::size_t x1, const vector<T>& v) const
         {
             assert(x1<dim1());
-            REAL_VECTOR cur_min = simdpp::load( vec_.begin() + x1*padded_dim2() );
-            REAL_VECTOR _v = simdpp::load(v.begin());
+            simd_vector<T> cur_min = simdpp::load( vec_.begin() + x1*padded_dim2() );
+            simd_vector<T> _v = simdpp::load(v.begin());
             cur_min = cur_min + _v;
             for(std::size_t x2=REAL_ALIGNMENT; x2<dim2(); x2+=REAL_ALIGNMENT) {
-                REAL_VECTOR tmp = simdpp::load( vec_.begin() + x1*padded_dim2() + x2 );
-                REAL_VECTOR _v = simdpp::load(v.begin() + x2);
+                simd_vector<T> tmp = simdpp::load( vec_.begin() + x1*padded_dim2() + x2 );
+                simd_vector<T> _v = simdpp::load(v.begin() + x2);
                 tmp = tmp + _v;
                 cur_min = simdpp::min(cur_min, tmp); 
             }
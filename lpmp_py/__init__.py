@@ -1,4 +1,4 @@
-from .raw_solvers import gm_solver, mgm_solver
+from .raw_solvers import gm_solver, GmWarmStartSolver, GmBatchSolver, mgm_solver
 
 try:
     import torch
@@ -28,9 +28,10 @@ def gm_solver(costs, quadratic_costs, edges_left, edges_right, solver_params, ve
             f"#quadratic terms: {quadratic_costs.size}"
         )
 
-    instance = gm.graph_matching_input(
-        costs, quadratic_costs, np.array(edges_left, dtype=np.intc), np.array(edges_right, dtype=np.intc)
-    )
+    # contiguous float32/float64 costs and int32/int64 edges are read by the solver without copies
+    edges_left = np.ascontiguousarray(edges_left)
+    edges_right = np.ascontiguousarray(edges_right)
+    instance = gm.graph_matching_input(costs, quadratic_costs, edges_left, edges_right)
 
     params = ["tmp", f"-v {int(verbose)}"] + [f"--{key} {val}" for key, val in solver_params.items()]
     solver = gm.graph_matching_message_passing_solver(params)
@@ -39,13 +40,93 @@ def gm_solver(costs, quadratic_costs, edges_left, edges_right, solver_params, ve
     solver.solve()
 
     result = solver.result()
-    costs_paid, quadratic_costs_paid = result.result_masks(
-        costs, quadratic_costs, np.array(edges_left), np.array(edges_right)
-    )
+    costs_paid, quadratic_costs_paid = result.result_masks(costs, quadratic_costs, edges_left, edges_right)
 
     return costs_paid, quadratic_costs_paid
 
 
+class GmWarmStartSolver:
+    """
+    Graph Matching solver for repeatedly solving instances on the same graphs G_1 = (V_1, E_1) and G_2 = (V_2, E_2)
+    with changing costs. The problem is constructed once, subsequent calls only update costs and continue optimization
+    from the dual variables of the previous call.
+
+    @param edges_left: np.array of shape (|E_1|, 2) with edges of G_1 (pairs of vertex indices)
+    @param edges_right: np.array of shape (|E_2|, 2) with edges of G_2 (pairs of vertex indices)
+    @param solver_params: dict of command line flags to pass to the solver (see solver documentation)
+    @param verbose: bool, if true print raw solver output
+    """
+    def __init__(self, edges_left, edges_right, solver_params, verbose=False):
+        self.edges_left = np.ascontiguousarray(edges_left)
+        self.edges_right = np.ascontiguousarray(edges_right)
+        self.params = ["tmp", f"-v {int(verbose)}"] + [f"--{key} {val}" for key, val in solver_params.items()]
+        self.solver = None
+
+    def solve(self, costs, quadratic_costs):
+        """
+        @param costs: np.array of shape (|V_1|, |V_2|) with unary matching costs
+        @param quadratic_costs: np.array of shape (|E_1|, |E_2|) with pairwise matching costs
+        @return: same as gm_solver
+        """
+        instance = gm.graph_matching_input(costs, quadratic_costs, self.edges_left, self.edges_right)
+
+        if self.solver is None:
+            self.solver = gm.graph_matching_message_passing_solver(self.params)
+            self.solver.construct(instance)
+        else:
+            self.solver.update_costs(instance)
+        self.solver.solve()
+
+        result = self.solver.result()
+        costs_paid, quadratic_costs_paid = result.result_masks(costs, quadratic_costs, self.edges_left, self.edges_right)
+
+        return costs_paid, quadratic_costs_paid
+
+
+class GmBatchSolver:
+    """
+    Graph Matching solver for a batch of k instances matching graphs G_i = (V_i, E_i) and H_i = (W_i, F_i), i=1..k.
+    All instances are solved by a single call into the solver, in parallel and without holding the GIL.
+    As for GmWarmStartSolver, subsequent calls only update costs and continue optimization from the previous duals.
+
+    @param edges_left_batch: list of k np.arrays of shape (|E_i|, 2) with edges of G_i
+    @param edges_right_batch: list of k np.arrays of shape (|F_i|, 2) with edges of H_i
+    @param num_vertices_left_batch: list of k integers |V_i|
+    @param num_vertices_right_batch: list of k integers |W_i|
+    @param solver_params: dict of command line flags to pass to the solver (see solver documentation)
+    @param nr_threads: number of threads instances are distributed on, all hardware threads if 0
+    @param verbose: bool, if true print raw solver output
+    """
+    def __init__(
+        self,
+        edges_left_batch,
+        edges_right_batch,
+        num_vertices_left_batch,
+        num_vertices_right_batch,
+        solver_params,
+        nr_threads=0,
+        verbose=False,
+    ):
+        params = ["tmp", f"-v {int(verbose)}"] + [f"--{key} {val}" for key, val in solver_params.items()]
+        self.solver = gm.graph_matching_message_passing_batch_solver(
+            params,
+            [np.ascontiguousarray(edges) for edges in edges_left_batch],
+            [np.ascontiguousarray(edges) for edges in edges_right_batch],
+            [int(n) for n in num_vertices_left_batch],
+            [int(n) for n in num_vertices_right_batch],
+            nr_threads,
+        )
+
+    def solve(self, costs_batch, quadratic_costs_batch):
+        """
+        @param costs_batch: np.array of shape (k, max |V_i|, max |W_i|) with zero padded unary matching costs
+        @param quadratic_costs_batch: np.array of shape (k, max |E_i|, max |F_i|) with zero padded pairwise matching costs
+        @return: np.arrays of the same shapes with 0/1 values capturing the min-cost matchings and the paid pairwise
+                 costs of all instances, zero padded
+        """
+        return self.solver.solve(costs_batch, quadratic_costs_batch)
+
+
 def mgm_solver(unary_costs, quadratic_costs, edges, solver_params, verbose=False):
     """
     A thin python wrapper of the solver Multigraph Matching solver. Computes min-cost matching of k directed graphs
@@ -1,5 +1,5 @@
 import torch
-from ..raw_solvers import gm_solver
+from ..raw_solvers import GmWarmStartSolver, GmBatchSolver
 
 
 class GraphMatchingSolver(torch.autograd.Function):
@@ -26,16 +26,20 @@ class GraphMatchingSolver(torch.autograd.Function):
                  the suggested matching
         """
         device = costs.device
-        costs_paid, quadratic_costs_paid = gm_solver(
-            costs=costs.cpu().detach().numpy(),
-            quadratic_costs=quadratic_costs.cpu().detach().numpy(),
+        # kept for the backward pass, which solves the same matching problem with perturbed costs
+        solver = GmWarmStartSolver(
             edges_left=params["edges_left"].cpu().detach().numpy(),
             edges_right=params["edges_right"].cpu().detach().numpy(),
             solver_params=params["solver_params"],
         )
+        costs_paid, quadratic_costs_paid = solver.solve(
+            costs=costs.cpu().detach().numpy(),
+            quadratic_costs=quadratic_costs.cpu().detach().numpy(),
+        )
         costs_paid = torch.from_numpy(costs_paid).to(torch.float32).to(device)
         quadratic_costs_paid = torch.from_numpy(quadratic_costs_paid).to(torch.float32).to(device)
         ctx.params = params
+        ctx.solver = solver
         ctx.save_for_backward(costs, costs_paid, quadratic_costs, quadratic_costs_paid)
         return costs_paid, quadratic_costs_paid
 
@@ -57,12 +61,81 @@ class GraphMatchingSolver(torch.autograd.Function):
 
         costs_prime = costs + lambda_val * grad_costs_paid
         quadratic_costs_prime = quadratic_costs + lambda_val * grad_quadratic_costs_paid
-        costs_paid_prime, quadratic_costs_paid_prime = gm_solver(
+        costs_paid_prime, quadratic_costs_paid_prime = ctx.solver.solve(
             costs=costs_prime.cpu().detach().numpy(),
             quadratic_costs=quadratic_costs_prime.cpu().detach().numpy(),
-            edges_left=ctx.params["edges_left"].cpu().detach().numpy(),
-            edges_right=ctx.params["edges_right"].cpu().detach().numpy(),
-            solver_params=ctx.params["solver_params"],
+        )
+        costs_paid_prime = torch.from_numpy(costs_paid_prime).to(torch.float32).to(device)
+        quadratic_costs_paid_prime = torch.from_numpy(quadratic_costs_paid_prime).to(torch.float32).to(device)
+
+        grad_costs = -(costs_paid - costs_paid_prime) / (lambda_val + epsilon_val)
+        grad_quadratic_costs = -(quadratic_costs_paid - quadratic_costs_paid_prime) / (lambda_val + epsilon_val)
+
+        return grad_costs, grad_quadratic_costs, None
+
+
+class GraphMatchingBatchSolver(torch.autograd.Function):
+    """
+    Graph Matching solver for a batch of instances as a torch.Function. Forward and backward pass each solve all
+    instances with a single call into the solver, which distributes them over a thread pool. Gradients as in [1].
+    """
+    @staticmethod
+    def forward(ctx, costs_batch, quadratic_costs_batch, params):
+        """
+        Forward pass for a batch of k graph matching instances matching G_i = (V_i, E_i) and H_i = (W_i, F_i)
+
+        @param ctx: context for backpropagation
+        @param costs_batch: torch.Tensor of shape (k, max |V_i|, max |W_i|) with zero padded unary costs
+        @param quadratic_costs_batch: torch.Tensor of shape (k, max |E_i|, max |F_i|) with zero padded pairwise costs
+        @param params: a dict of additional params. Must contain:
+                edges_left_batch: a list of k torch.Tensors of shape (|E_i|, 2) describing edges of G_i,
+                edges_right_batch: a list of k torch.Tensors of shape (|F_i|, 2) describing edges of H_i,
+                num_vertices_s_batch: a list of k integers |V_i|,
+                num_vertices_t_batch: a list of k integers |W_i|,
+                lambda_val: float/np.float32/torch.float32, the value of lambda for computing the gradient with [1]
+                solver_params: a dict of command line parameters to the solver (see solver documentation)
+                nr_threads: number of solver threads, all hardware threads if 0
+        @return: torch.Tensors of the shapes of costs_batch and quadratic_costs_batch with 0/1 values capturing the
+                 suggested min-cost matchings and which pairwise costs were paid in them, zero padded
+        """
+        device = costs_batch.device
+        # kept for the backward pass, which solves the same matching problems with perturbed costs
+        solver = GmBatchSolver(
+            edges_left_batch=[edges.cpu().detach().numpy() for edges in params["edges_left_batch"]],
+            edges_right_batch=[edges.cpu().detach().numpy() for edges in params["edges_right_batch"]],
+            num_vertices_left_batch=params["num_vertices_s_batch"],
+            num_vertices_right_batch=params["num_vertices_t_batch"],
+            solver_params=params["solver_params"],
+            nr_threads=params.get("nr_threads", 0),
+        )
+        costs_paid, quadratic_costs_paid = solver.solve(
+            costs_batch.cpu().detach().numpy(),
+            quadratic_costs_batch.cpu().detach().numpy(),
+        )
+        costs_paid = torch.from_numpy(costs_paid).to(torch.float32).to(device)
+        quadratic_costs_paid = torch.from_numpy(quadratic_costs_paid).to(torch.float32).to(device)
+        ctx.params = params
+        ctx.solver = solver
+        ctx.save_for_backward(costs_batch, costs_paid, quadratic_costs_batch, quadratic_costs_paid)
+        return costs_paid, quadratic_costs_paid
+
+    @staticmethod
+    def backward(ctx, grad_costs_paid, grad_quadratic_costs_paid):
+        """
+        Backward pass computation, see GraphMatchingSolver.backward
+        """
+        costs_batch, costs_paid, quadratic_costs_batch, quadratic_costs_paid = ctx.saved_tensors
+        device = costs_batch.device
+        lambda_val = ctx.params["lambda_val"]
+        epsilon_val = 1e-8
+        assert grad_costs_paid.shape == costs_batch.shape
+        assert grad_quadratic_costs_paid.shape == quadratic_costs_batch.shape
+
+        costs_prime = costs_batch + lambda_val * grad_costs_paid
+        quadratic_costs_prime = quadratic_costs_batch + lambda_val * grad_quadratic_costs_paid
+        costs_paid_prime, quadratic_costs_paid_prime = ctx.solver.solve(
+            costs_prime.cpu().detach().numpy(),
+            quadratic_costs_prime.cpu().detach().numpy(),
         )
         costs_paid_prime = torch.from_numpy(costs_paid_prime).to(torch.float32).to(device)
         quadratic_costs_paid_prime = torch.from_numpy(quadratic_costs_paid_prime).to(torch.float32).to(device)
@@ -85,6 +158,7 @@ class GraphMatchingModule(torch.nn.Module):
         num_vertices_t_batch,
         lambda_val,
         solver_params,
+        nr_threads=0,
     ):
         """
         Prepares a module for a batch of k graph matching instances, i.e. instances matching graphs G_i, H_i for i=1..k
@@ -95,14 +169,15 @@ class GraphMatchingModule(torch.nn.Module):
         @param num_vertices_t_batch: a list of k integers [num_vertices(H_i) for i=1..k]
         @param lambda_val: lambda value for backpropagation by [1]
         @param solver_params: a dict of command line parameters to the solver (see solver documentation)
+        @param nr_threads: number of threads the k instances are solved on, all hardware threads if 0
         """
         super().__init__()
-        self.solver = GraphMatchingSolver()
+        self.solver = GraphMatchingBatchSolver()
         self.edges_left_batch = edges_left_batch
         self.edges_right_batch = edges_right_batch
         self.num_vertices_s_batch = num_vertices_s_batch
         self.num_vertices_t_batch = num_vertices_t_batch
-        self.params = {"lambda_val": lambda_val, "solver_params": solver_params}
+        self.params = {"lambda_val": lambda_val, "solver_params": solver_params, "nr_threads": nr_threads}
 
     def forward(self, costs_batch, quadratic_costs_batch):
         """
@@ -114,37 +189,13 @@ class GraphMatchingModule(torch.nn.Module):
         @return: torch.Tensor of shape (k, max(num_vertices(G_i)), max(num_vertices(H_i))) with 0/1 values and
         zero padding. Captures the returned matching from the solver.
         """
-        def params_generator():
-            for edges_left, edges_right in zip(self.edges_left_batch, self.edges_right_batch):
-                yield {"edges_left": edges_left.T, "edges_right": edges_right.T, **self.params}
-
-        def costs_generator():
-            zipped = zip(
-                self.edges_left_batch,
-                self.edges_right_batch,
-                self.num_vertices_s_batch,
-                self.num_vertices_t_batch,
-                costs_batch,
-                quadratic_costs_batch,
-            )
-            for edges_left, edges_right, num_vertices_s, num_vertices_t, costs, quadratic_costs in zipped:
-                truncated_costs = costs[:num_vertices_s, :num_vertices_t]
-                assert quadratic_costs.shape[0] == edges_left.shape[1], (quadratic_costs.shape, edges_left.shape)
-                assert quadratic_costs.shape[1] == edges_right.shape[1], (quadratic_costs.shape, edges_right.shape)
-                truncated_quadratic_costs = quadratic_costs[: edges_left.shape[-1], : edges_right.shape[-1]]
-                leftover_costs = (truncated_costs.abs().sum() - costs.abs().sum()).abs()
-                assert leftover_costs < 1e-5, leftover_costs
-                leftover_quadratic_costs = (truncated_quadratic_costs.abs().sum() - quadratic_costs.abs().sum()).abs()
-                assert leftover_quadratic_costs < 1e-5, leftover_quadratic_costs
-                yield truncated_costs, truncated_quadratic_costs
-
-        batch_size = len(costs_batch)
-        max_dimension_x = max(x.shape[0] for x in costs_batch)
-        max_dimension_y = max(x.shape[1] for x in costs_batch)
-        result = torch.zeros(size=(batch_size, max_dimension_x, max_dimension_y)).to(costs_batch[0].device)
-        for i, (params, costs, num_vertices_s, num_vertices_t) in enumerate(
-            zip(params_generator(), costs_generator(), self.num_vertices_s_batch, self.num_vertices_t_batch)
-        ):
-            tmp = self.solver.apply(costs[0], costs[1], params)
-            result[i, :num_vertices_s, :num_vertices_t] = tmp[0]  # Only unary matching returned
-        return result
+        params = {
+            "edges_left_batch": [edges_left.T for edges_left in self.edges_left_batch],
+            "edges_right_batch": [edges_right.T for edges_right in self.edges_right_batch],
+            "num_vertices_s_batch": self.num_vertices_s_batch,
+            "num_vertices_t_batch": self.num_vertices_t_batch,
+            **self.params,
+        }
+        # padding beyond the vertices and edges of each instance is ignored by the solver and zero in the result
+        costs_paid, _ = self.solver.apply(costs_batch, quadratic_costs_batch, params)
+        return costs_paid  # Only unary matching returned
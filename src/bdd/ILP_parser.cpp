@@ -2,6 +2,13 @@
 #include "pegtl.hh"
 #include "pegtl_parse_rules.h"
 #include "bdd/ILP_input.h"
+#include "serialization.hxx"
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <string_view>
+#include <thread>
 
 namespace LPMP {
 
@@ -161,17 +168,414 @@ namespace LPMP {
                 }
         };
 
-        ILP_input parse_file(const std::string& filename)
+        ////////////////////////////////////////////////////
+        // memory-mapped reader
+        ////////////////////////////////////////////////////
+
+        // The hand-written scanner below duplicates the grammar above for speed.
+        // Changes to one must be made to the other; test_ILP_parser compares both readers to catch drift.
+
+        constexpr static char binary_magic[8] = {'L','P','M','P','I','L','P','1'};
+
+        static bool is_binary_file(const std::string& filename)
+        {
+            std::ifstream f(filename, std::ios::binary);
+            char header[sizeof(binary_magic)];
+            if(!f.read(header, sizeof(header)))
+                return false;
+            return std::memcmp(header, binary_magic, sizeof(binary_magic)) == 0;
+        }
+
+        static bool is_blank(const char c) { return c == ' ' || c == '\t'; }
+        static bool is_eol(const char c) { return c == '\n' || c == '\r'; }
+        static bool is_digit(const char c) { return c >= '0' && c <= '9'; }
+        static bool is_alpha(const char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+        static bool is_alnum(const char c) { return is_alpha(c) || is_digit(c); }
+        static bool is_inequality_char(const char c) { return c == '<' || c == '>' || c == '='; }
+        // same characters as variable_name above
+        static bool is_variable_char(const char c)
         {
+            return is_alnum(c) || c == '_' || c == '-' || c == '/' || c == '(' || c == ')' || c == '{' || c == '}' || c == ',';
+        }
+
+        struct lp_scanner {
+            const char* p;
+            const char* end;
+
+            bool at_end() const { return p == end; }
+            void skip_blanks() { while(p != end && is_blank(*p)) ++p; }
+            void skip_invisible() { while(p != end && (is_blank(*p) || is_eol(*p))) ++p; }
+            bool starts_with(const std::string_view s) const { return std::size_t(end - p) >= s.size() && std::string_view(p, s.size()) == s; }
+
+            [[noreturn]] void error(const std::string& what) const
+            {
+                throw std::runtime_error("LP reader: " + what + " at \"" + std::string(p, std::min(std::ptrdiff_t(40), end - p)) + "\"");
+            }
+
+            int sign()
+            {
+                if(p != end && (*p == '+' || *p == '-'))
+                    return *(p++) == '-' ? -1 : 1;
+                return 1;
+            }
+
+            int unsigned_integer()
+            {
+                if(p == end || !is_digit(*p))
+                    error("expected integer");
+                int x;
+                const auto [ptr, ec] = std::from_chars(p, end, x);
+                if(ec != std::errc())
+                    error("integer out of range");
+                p = ptr;
+                return x;
+            }
+
+            double real_number()
+            {
+                const char* b = p;
+                if(p != end && (*p == '+' || *p == '-')) ++p;
+                while(p != end && is_digit(*p)) ++p;
+                if(p != end && *p == '.') ++p;
+                while(p != end && is_digit(*p)) ++p;
+                if(p != end && (*p == 'e' || *p == 'E')) {
+                    ++p;
+                    if(p != end && (*p == '+' || *p == '-')) ++p;
+                    while(p != end && is_digit(*p)) ++p;
+                }
+                if(p == b)
+                    error("expected number");
+                return std::stod(std::string(b, p));
+            }
+
+            std::string_view variable_name()
+            {
+                if(p == end || !is_alpha(*p))
+                    error("expected variable name");
+                const char* b = p++;
+                while(p != end && is_variable_char(*p)) ++p;
+                return std::string_view(b, p - b);
+            }
+
+            LPMP::inequality_type inequality()
+            {
+                if(starts_with("<=")) { p += 2; return LPMP::inequality_type::smaller_equal; }
+                if(starts_with(">=")) { p += 2; return LPMP::inequality_type::greater_equal; }
+                if(starts_with("=")) { p += 1; return LPMP::inequality_type::equal; }
+                error("expected inequality type");
+            }
+        };
+
+        // constraints of a contiguous part of the "Subject To" section, with variables numbered in order of first occurrence within the chunk
+        struct constraint_chunk {
+            std::vector<std::string_view> variables;
+            std::vector<ILP_input::weighted_variable> terms;
+            std::vector<std::size_t> constraint_begin = {0};
+            std::vector<LPMP::inequality_type> ineqs;
+            std::vector<int> right_hand_sides;
+            std::exception_ptr error;
+
+            std::size_t nr_constraints() const { return ineqs.size(); }
+        };
+
+        static void parse_constraints(const char* begin, const char* end, constraint_chunk& chunk)
+        {
+            tsl::robin_map<std::string_view, std::size_t> variable_index;
+            lp_scanner s{begin, end};
+            for(s.skip_invisible(); !s.at_end(); s.skip_invisible()) {
+                // optional inequality identifier
+                if(is_alpha(*s.p)) {
+                    const char* q = s.p;
+                    while(q != end && is_alnum(*q)) ++q;
+                    while(q != end && is_blank(*q)) ++q;
+                    if(q != end && *q == ':')
+                        s.p = q+1;
+                }
+
+                for(s.skip_invisible(); s.at_end() || !is_inequality_char(*s.p); s.skip_invisible()) {
+                    if(s.at_end())
+                        s.error("incomplete inequality");
+                    int coefficient = s.sign();
+                    s.skip_blanks();
+                    if(!s.at_end() && is_digit(*s.p)) {
+                        coefficient *= s.unsigned_integer();
+                        s.skip_blanks();
+                        if(!s.at_end() && *s.p == '*') {
+                            ++s.p;
+                            s.skip_blanks();
+                        }
+                    }
+                    const std::string_view var = s.variable_name();
+                    auto it = variable_index.find(var);
+                    if(it == variable_index.end()) {
+                        it = variable_index.insert({var, chunk.variables.size()}).first;
+                        chunk.variables.push_back(var);
+                    }
+                    chunk.terms.push_back({coefficient, it->second});
+                }
+
+                chunk.ineqs.push_back(s.inequality());
+                s.skip_blanks();
+                const int rhs_sign = s.sign();
+                chunk.right_hand_sides.push_back(rhs_sign * s.unsigned_integer());
+                s.skip_blanks();
+                if(!s.at_end() && !is_eol(*s.p))
+                    s.error("expected end of line");
+                chunk.constraint_begin.push_back(chunk.terms.size());
+            }
+        }
+
+        // start of the line after the first line at or after pos that ends an inequality.
+        // Inequalities may span several lines, but only their last line contains an inequality sign.
+        static const char* next_inequality_boundary(const char* begin, const char* end, const char* pos)
+        {
+            if(pos == begin)
+                return begin;
+            const char* line_begin = pos;
+            while(line_begin != begin && line_begin[-1] != '\n') --line_begin;
+            while(line_begin != end) {
+                const char* line_end = static_cast<const char*>(std::memchr(line_begin, '\n', end - line_begin));
+                if(line_end == nullptr)
+                    line_end = end;
+                if(std::find_if(line_begin, line_end, is_inequality_char) != line_end)
+                    return line_end == end ? end : line_end+1;
+                line_begin = line_end == end ? end : line_end+1;
+            }
+            return end;
+        }
+
+        static ILP_input parse_text(const std::string_view text, const std::size_t nr_threads, const std::size_t min_chunk_size)
+        {
+            // variable names point into text until the ILP_input is assembled at the end, which allocates every name once
+            tsl::robin_map<std::string_view, std::size_t> variable_index;
+            std::vector<std::string_view> variables;
+            auto get_or_create_variable_index = [&](const std::string_view var) {
+                const auto it = variable_index.insert({var, variables.size()}).first;
+                if(it->second == variables.size())
+                    variables.push_back(var);
+                return it->second;
+            };
+
+            lp_scanner s{text.data(), text.data() + text.size()};
+
+            s.skip_invisible();
+            if(!s.starts_with("Minimize"))
+                s.error("expected Minimize");
+            s.p += std::strlen("Minimize");
+
+            // objective is read sequentially, its variables get the first indices
+            std::vector<std::pair<std::size_t, double>> objective;
+            for(s.skip_invisible(); !s.starts_with("Subject To"); s.skip_invisible()) {
+                if(s.at_end())
+                    s.error("expected Subject To");
+                double coefficient = s.sign();
+                s.skip_blanks();
+                if(!s.at_end() && (is_digit(*s.p) || *s.p == '.')) {
+                    coefficient *= s.real_number();
+                    s.skip_blanks();
+                    if(!s.at_end() && *s.p == '*') {
+                        ++s.p;
+                        s.skip_blanks();
+                    }
+                }
+                objective.push_back({get_or_create_variable_index(s.variable_name()), coefficient});
+            }
+            s.p += std::strlen("Subject To");
+
+            // constraints end with the last line containing an inequality sign, afterwards only Bounds, Binaries and End follow
+            const char* constraints_begin = s.p;
+            const char* constraints_end = s.end;
+            while(constraints_end != constraints_begin && !is_inequality_char(constraints_end[-1])) --constraints_end;
+            while(constraints_end != s.end && !is_eol(*constraints_end)) ++constraints_end;
+
+            lp_scanner tail{constraints_end, s.end};
+            for(tail.skip_invisible(); !tail.starts_with("End"); tail.skip_invisible()) {
+                if(tail.at_end())
+                    tail.error("expected End");
+                while(!tail.at_end() && !is_eol(*tail.p)) ++tail.p;
+            }
+
+            // split constraints into chunks at inequality boundaries and parse them in parallel
+            const std::size_t nr_chunks = std::max(std::size_t(1), std::min(4*nr_threads, std::size_t(constraints_end - constraints_begin) / std::max(std::size_t(1), min_chunk_size)));
+            std::vector<const char*> chunk_boundaries = {constraints_begin};
+            for(std::size_t c=1; c<nr_chunks; ++c) {
+                const char* pos = constraints_begin + c * (constraints_end - constraints_begin) / nr_chunks;
+                chunk_boundaries.push_back(std::max(chunk_boundaries.back(), next_inequality_boundary(constraints_begin, constraints_end, pos)));
+            }
+            chunk_boundaries.push_back(constraints_end);
+
+            std::vector<constraint_chunk> chunks(nr_chunks);
+#pragma omp parallel for schedule(dynamic) num_threads(nr_threads)
+            for(std::size_t c=0; c<nr_chunks; ++c) {
+                try {
+                    parse_constraints(chunk_boundaries[c], chunk_boundaries[c+1], chunks[c]);
+                } catch(...) {
+                    chunks[c].error = std::current_exception();
+                }
+            }
+            for(const auto& chunk : chunks)
+                if(chunk.error)
+                    std::rethrow_exception(chunk.error);
+
+            // number variables by first occurrence, as the sequential parser does, by merging the chunk-local tables in chunk order
+            std::size_t nr_chunk_variables = 0;
+            for(const auto& chunk : chunks)
+                nr_chunk_variables += chunk.variables.size();
+            variable_index.reserve(variables.size() + nr_chunk_variables);
+            std::vector<std::vector<std::size_t>> global_variables(nr_chunks);
+            for(std::size_t c=0; c<nr_chunks; ++c) {
+                global_variables[c].reserve(chunks[c].variables.size());
+                for(const std::string_view var : chunks[c].variables)
+                    global_variables[c].push_back(get_or_create_variable_index(var));
+            }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nr_threads)
+            for(std::size_t c=0; c<nr_chunks; ++c) {
+                auto& chunk = chunks[c];
+                for(auto& t : chunk.terms)
+                    t.var = global_variables[c][t.var];
+                for(std::size_t i=0; i<chunk.nr_constraints(); ++i)
+                    std::sort(chunk.terms.begin() + chunk.constraint_begin[i], chunk.terms.begin() + chunk.constraint_begin[i+1]);
+            }
+
             ILP_input input;
-            tmp_storage tmp;
-            pegtl::file_parser problem(filename);
-            const bool success = problem.parse< grammar, action >(input, tmp); 
-            if(!success)
-                throw std::runtime_error("could not read input file " + filename);
+            for(const std::string_view var : variables)
+                input.add_new_variable(std::string(var));
+            for(const auto [var, coefficient] : objective)
+                input.add_to_objective(coefficient, var);
+
+            for(const auto& chunk : chunks) {
+                for(std::size_t i=0; i<chunk.nr_constraints(); ++i) {
+                    input.begin_new_inequality();
+                    for(std::size_t j=chunk.constraint_begin[i]; j<chunk.constraint_begin[i+1]; ++j)
+                        input.add_to_constraint(chunk.terms[j].coefficient, chunk.terms[j].var);
+                    input.set_inequality_type(chunk.ineqs[i]);
+                    input.set_right_hand_side(chunk.right_hand_sides[i]);
+                }
+            }
+
+            return input;
+        }
+
+        ILP_input parse_file_mmap(const std::string& filename, const std::size_t nr_threads, const std::size_t min_chunk_size)
+        {
+            const memory_mapped_file file(filename);
+            const std::size_t t = nr_threads > 0 ? nr_threads : std::max(1u, std::thread::hardware_concurrency());
+            return parse_text(std::string_view(file.data(), file.size()), t, min_chunk_size);
+        }
+
+        ////////////////////////////////////////////////////
+        // binary cache
+        ////////////////////////////////////////////////////
+
+        // layout: magic, variable names, objective, constraints. Sizes are 64 bit.
+        void write_binary(const ILP_input& input, const std::string& filename)
+        {
+            std::size_t size_in_bytes = sizeof(binary_magic) + sizeof(std::uint64_t);
+            for(std::size_t i=0; i<input.nr_variables(); ++i)
+                size_in_bytes += sizeof(std::uint64_t) + input.get_var_name(i).size();
+            size_in_bytes += sizeof(std::uint64_t) + input.objective().size() * sizeof(double);
+            size_in_bytes += sizeof(std::uint64_t);
+            for(const auto& constr : input.constraints())
+                size_in_bytes += 2*sizeof(std::int32_t) + sizeof(std::uint64_t) + constr.variables.size() * (sizeof(std::int32_t) + sizeof(std::uint64_t));
+
+            memory_mapped_file file(filename, size_in_bytes);
+            char* cur = file.data();
+            auto write = [&](const void* data, const std::size_t bytes) { std::memcpy(cur, data, bytes); cur += bytes; };
+            auto write_value = [&](const auto x) { write(&x, sizeof(x)); };
+
+            write(binary_magic, sizeof(binary_magic));
+            write_value(std::uint64_t(input.nr_variables()));
+            for(std::size_t i=0; i<input.nr_variables(); ++i) {
+                const std::string name = input.get_var_name(i);
+                write_value(std::uint64_t(name.size()));
+                write(name.data(), name.size());
+            }
+            write_value(std::uint64_t(input.objective().size()));
+            write(input.objective().data(), input.objective().size() * sizeof(double));
+            write_value(std::uint64_t(input.nr_constraints()));
+            for(const auto& constr : input.constraints()) {
+                write_value(std::int32_t(constr.ineq));
+                write_value(std::int32_t(constr.right_hand_side));
+                write_value(std::uint64_t(constr.variables.size()));
+                for(const auto& v : constr.variables) {
+                    write_value(std::int32_t(v.coefficient));
+                    write_value(std::uint64_t(v.var));
+                }
+            }
+            assert(cur == file.data() + file.size());
+        }
+
+        ILP_input read_binary(const std::string& filename)
+        {
+            const memory_mapped_file file(filename);
+            const char* cur = file.data();
+            const char* end = file.data() + file.size();
+            auto read = [&](void* data, const std::size_t bytes) {
+                if(std::size_t(end - cur) < bytes)
+                    throw std::runtime_error("binary ILP file " + filename + " is truncated");
+                std::memcpy(data, cur, bytes);
+                cur += bytes;
+            };
+            auto read_value = [&](auto& x) { read(&x, sizeof(x)); };
+
+            char magic[sizeof(binary_magic)];
+            read(magic, sizeof(magic));
+            if(std::memcmp(magic, binary_magic, sizeof(binary_magic)) != 0)
+                throw std::runtime_error(filename + " is not a binary ILP file");
+
+            ILP_input input;
+            std::uint64_t nr_variables;
+            read_value(nr_variables);
+            std::string name;
+            for(std::size_t i=0; i<nr_variables; ++i) {
+                std::uint64_t length;
+                read_value(length);
+                name.resize(length);
+                read(name.data(), length);
+                input.add_new_variable(name);
+            }
+
+            std::uint64_t objective_size;
+            read_value(objective_size);
+            for(std::size_t i=0; i<objective_size; ++i) {
+                double c;
+                read_value(c);
+                input.add_to_objective(c, i);
+            }
+
+            std::uint64_t nr_constraints;
+            read_value(nr_constraints);
+            for(std::size_t c=0; c<nr_constraints; ++c) {
+                std::int32_t ineq, rhs;
+                std::uint64_t nr_terms;
+                read_value(ineq);
+                read_value(rhs);
+                read_value(nr_terms);
+                input.begin_new_inequality();
+                for(std::size_t j=0; j<nr_terms; ++j) {
+                    std::int32_t coefficient;
+                    std::uint64_t var;
+                    read_value(coefficient);
+                    read_value(var);
+                    if(var >= nr_variables)
+                        throw std::runtime_error("binary ILP file " + filename + " references unknown variable");
+                    input.add_to_constraint(coefficient, std::size_t(var));
+                }
+                input.set_inequality_type(static_cast<LPMP::inequality_type>(ineq));
+                input.set_right_hand_side(rhs);
+            }
+
             return input;
         }
 
+        ILP_input parse_file(const std::string& filename)
+        {
+            if(is_binary_file(filename))
+                return read_binary(filename);
+            return parse_file_mmap(filename);
+        }
+
         ILP_input parse_string(const std::string& input_string)
         {
             ILP_input input;
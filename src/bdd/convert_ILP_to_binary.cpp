@@ -0,0 +1,18 @@
+#include "bdd/ILP_parser.h"
+#include "tclap/CmdLine.h"
+#include <iostream>
+
+using namespace LPMP;
+
+// Writes the binary cache of an ILP in LP format. Solvers read such files with ILP_parser::parse_file in place of the text input.
+int main(int argc, char** argv)
+{
+    TCLAP::CmdLine cmd("convert 0/1 ILP in LP format to binary cache", ' ', "0.1");
+    TCLAP::ValueArg<std::string> input_file_arg("i","input","input file in LP format",true,"","",cmd);
+    TCLAP::ValueArg<std::string> output_file_arg("o","output","binary output file",true,"","",cmd);
+    cmd.parse(argc, argv);
+
+    const ILP_input input = ILP_parser::parse_file(input_file_arg.getValue());
+    ILP_parser::write_binary(input, output_file_arg.getValue());
+    std::cout << "wrote " << input.nr_variables() << " variables and " << input.nr_constraints() << " constraints to " << output_file_arg.getValue() << "\n";
+}
@@ -148,7 +148,7 @@ PYBIND11_MODULE(graph_matching_py, m) {
         //        if (i >= l.size()) throw py::index_error();
         //        return l[i];
         //        })
-        .def("result_masks", [](const LPMP::graph_matching_input::labeling& l, const py::array_t<double> assignments, const py::array_t<double> quadratic_terms, const py::array_t<std::size_t> left_edges, const py::array_t<std::size_t> right_edges) {
+        .def("result_masks", [](const LPMP::graph_matching_input::labeling& l, const py::object& assignments, const py::object& quadratic_terms, const py::object& left_edges, const py::object& right_edges) {
                 auto assignment_mask = LPMP::py_helper::get_assignment_mask(l, assignments);
                 auto quadratic_mask = LPMP::py_helper::get_quadratic_terms_mask(l, quadratic_terms, left_edges, right_edges);
                 return std::make_pair(assignment_mask, quadratic_mask);
@@ -163,7 +163,8 @@ PYBIND11_MODULE(graph_matching_py, m) {
 
     py::class_<LPMP::graph_matching_input, LPMP::linear_assignment_problem_input>(m, "graph_matching_input")
         .def(py::init<>())
-        .def(py::init([](const py::array_t<double> assignments, const py::array_t<double> quadratic_terms, const py::array_t<std::size_t> left_edges, const py::array_t<std::size_t> right_edges) {
+        // contiguous float32/float64 costs and int32/int64 edges are read without conversion
+        .def(py::init([](const py::object& assignments, const py::object& quadratic_terms, const py::object& left_edges, const py::object& right_edges) {
             LPMP::graph_matching_input instance;
             LPMP::py_helper::construct_from_arrays(instance, assignments, quadratic_terms, left_edges, right_edges);
             return instance;
@@ -190,14 +191,23 @@ PYBIND11_MODULE(graph_matching_py, m) {
     py::class_<gm_mp_solver>(m, "graph_matching_message_passing_solver")
         .def(py::init<std::vector<std::string>&>())
         .def("construct", [](gm_mp_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().construct(input); })
+        .def("update_costs", [](gm_mp_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().update_costs(input); })
         .def("solve", &gm_mp_solver::Solve)
         .def("export", [](gm_mp_solver& s){ return s.GetProblemConstructor().export_graph_matching_input(); })
         .def("result", [](gm_mp_solver& s){ return s.GetProblemConstructor().best_labeling(); });
 
+    using gm_mp_batch_solver = LPMP::py_helper::graph_matching_batch_solver<gm_mp_solver>;
+    py::class_<gm_mp_batch_solver>(m, "graph_matching_message_passing_batch_solver")
+        .def(py::init<const std::vector<std::string>&, const std::vector<py::object>&, const std::vector<py::object>&, const std::vector<std::size_t>&, const std::vector<std::size_t>&, const int>(),
+                py::arg("options"), py::arg("left_edges"), py::arg("right_edges"), py::arg("no_left_nodes"), py::arg("no_right_nodes"), py::arg("nr_threads") = 0)
+        .def("__len__", &gm_mp_batch_solver::size)
+        .def("solve", &gm_mp_batch_solver::solve);
+
     using gm_mp_q_solver = LPMP::ProblemConstructorRoundingSolver<LPMP::Solver<LPMP::LP<LPMP::FMC_MP_Q>,LPMP::StandardVisitor>>; 
     py::class_<gm_mp_q_solver>(m, "graph_matching_message_passing_interquadratic_message_solver")
         .def(py::init<std::vector<std::string>&>())
         .def("construct", [](gm_mp_q_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().construct(input); })
+        .def("update_costs", [](gm_mp_q_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().update_costs(input); })
         .def("solve", &gm_mp_q_solver::Solve)
         .def("export",  [](gm_mp_q_solver& s){ return s.GetProblemConstructor().export_graph_matching_input(); })
         .def("result",  [](gm_mp_q_solver& s){ return s.GetProblemConstructor().best_labeling(); });
@@ -206,6 +216,7 @@ PYBIND11_MODULE(graph_matching_py, m) {
     py::class_<gm_mp_t_solver>(m, "graph_matching_message_passing_tightening_solver")
         .def(py::init<std::vector<std::string>&>())
         .def("construct", [](gm_mp_t_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().construct(input); })
+        .def("update_costs", [](gm_mp_t_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().update_costs(input); })
         .def("solve", &gm_mp_t_solver::Solve)
         .def("export",  [](gm_mp_t_solver& s){ return s.GetProblemConstructor().export_graph_matching_input(); })
         .def("result",  [](gm_mp_t_solver& s){ return s.GetProblemConstructor().best_labeling(); });
@@ -214,6 +225,7 @@ PYBIND11_MODULE(graph_matching_py, m) {
     py::class_<gm_mp_q_t_solver>(m, "graph_matching_message_passing_interquadratic_message_tightening_solver")
         .def(py::init<std::vector<std::string>&>())
         .def("construct", [](gm_mp_q_t_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().construct(input); })
+        .def("update_costs", [](gm_mp_q_t_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().update_costs(input); })
         .def("solve", &gm_mp_q_t_solver::Solve)
         .def("export",  [](gm_mp_q_t_solver& s){ return s.GetProblemConstructor().export_graph_matching_input(); })
         .def("result",  [](gm_mp_q_t_solver& s){ return s.GetProblemConstructor().best_labeling(); });
@@ -222,6 +234,7 @@ PYBIND11_MODULE(graph_matching_py, m) {
     py::class_<gm_mrf_solver>(m, "graph_matching_mrf_solver")
         .def(py::init<std::vector<std::string>&>())
         .def("construct", [](gm_mrf_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().construct(input); })
+        .def("update_costs", [](gm_mrf_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().update_costs(input); })
         .def("solve", &gm_mrf_solver::Solve)
         .def("export",  [](gm_mrf_solver& s){ return s.GetProblemConstructor().export_graph_matching_input(); })
         .def("result",  [](gm_mrf_solver& s){ return s.GetProblemConstructor().best_labeling(); });
@@ -230,6 +243,7 @@ PYBIND11_MODULE(graph_matching_py, m) {
     py::class_<gm_mrf_t_solver>(m, "graph_matching_mrf_tightening_solver")
         .def(py::init<std::vector<std::string>&>())
         .def("construct", [](gm_mrf_t_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().construct(input); })
+        .def("update_costs", [](gm_mrf_t_solver& s, const LPMP::graph_matching_input& input){ return s.GetProblemConstructor().update_costs(input); })
         .def("solve", &gm_mrf_t_solver::Solve)
         .def("export",  [](gm_mrf_t_solver& s){ return s.GetProblemConstructor().export_graph_matching_input(); })
         .def("result",  [](gm_mrf_t_solver& s){ return s.GetProblemConstructor().best_labeling(); });
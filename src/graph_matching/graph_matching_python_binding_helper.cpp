@@ -1,134 +1,128 @@
 #include "graph_matching/graph_matching_python_binding_helper.h"
+#include <cstdint>
 
 namespace LPMP {
     namespace py_helper {
 
-    void add_assignments(LPMP::graph_matching_input& instance, const py::array_t<double> assignments)
+    template<typename INDEX>
+    static edge_list read_edges(const INDEX* e, const std::size_t no_edges, const std::size_t no_nodes)
     {
-        const auto _assignments = assignments.unchecked<2>();
-        const std::size_t dim1 = _assignments.shape(0);
-        const std::size_t dim2 = _assignments.shape(1);
-        for(std::size_t i=0; i<dim1; ++i) {
-            for(std::size_t j=0; j<dim2; ++j) {
-                //std::cout << "add assignment " << i*dim2+j << " = (" << i << "," << j << "), cost = " << _assignments(i,j) << "\n";
-                instance.add_assignment(i, j, _assignments(i,j));
-            }
+        edge_list output;
+        output.reserve(no_edges);
+        for(std::size_t i=0; i<no_edges; ++i) {
+            const INDEX i1 = e[2*i];
+            const INDEX i2 = e[2*i+1];
+            if(i1 < 0 || i2 < 0 || std::size_t(i1) >= no_nodes || std::size_t(i2) >= no_nodes)
+                throw std::runtime_error("graph matching python binding: edge endpoint out of bounds");
+            if(i1 == i2)
+                throw std::runtime_error("graph matching python binding: edge endpoints must be distinct");
+            output.push_back({std::size_t(i1), std::size_t(i2)});
         }
+        return output;
     }
 
-    void add_quadratic_terms(LPMP::graph_matching_input& instance, const py::array_t<double> quadratic_terms, const py::array_t<int> left_edges, const py::array_t<int> right_edges)
+    py::array as_array(const py::object& obj)
     {
-        const auto _left_edges = left_edges.unchecked<2>();
-        const auto _right_edges = right_edges.unchecked<2>();
-        const auto _quadratic_terms = quadratic_terms.unchecked<2>();
-
-        const std::size_t no_left_edges = quadratic_terms.shape(0);
-        const std::size_t no_right_edges = quadratic_terms.shape(1);
-        //std::cout << no_left_edges << ";" << left_edges.shape(0) << ", " << left_edges.shape(1)  << "\n";
-        if(left_edges.shape(1) != 2)
-            throw std::runtime_error("graph matching python binding: left_edges must have second dimension = 2");
-        if(left_edges.shape(0) != no_left_edges)
-            throw std::runtime_error("graph matching python binding: dimension incompatibility");
-        //std::cout << right_edges.shape(0) << ", " << right_edges.shape(1)  << "\n";
-        if(right_edges.shape(1) != 2)
-            throw std::runtime_error("graph matching python binding: right must have second dimension = 2");
-        if(right_edges.shape(0) != no_right_edges)
-            throw std::runtime_error("graph matching python binding: dimension incompatibility");
-
-        //std::cout << "nr left edges = " << no_left_edges << "\n";
-        //std::cout << "nr right edges = " << no_right_edges << "\n";
-
-        for(std::size_t i=0; i<no_left_edges; ++i) {
-            for(std::size_t j=0; j<no_right_edges; ++j) {
-                const std::size_t left_node_1 = _left_edges(i,0);//left_edges_ptr[i*2];
-                const std::size_t right_node_1 = _right_edges(j,0);//right_edges_ptr[j*2];
-                const std::size_t assignment_1 = left_node_1*instance.no_right_nodes + right_node_1;
-                if(left_node_1 >= instance.no_left_nodes)
-                    throw std::runtime_error("left node out of bounds");
-                if(right_node_1 >= instance.no_right_nodes) {
-                    throw std::runtime_error("right node out of bounds");
-                }
-
-                const std::size_t left_node_2 = _left_edges(i,1);//left_edges_ptr[i*2+1];
-                const std::size_t right_node_2 = _right_edges(j,1);//right_edges_ptr[j*2+1];
-                const std::size_t assignment_2 = left_node_2*instance.no_right_nodes + right_node_2;
-                if(left_node_2 >= instance.no_left_nodes)
-                    throw std::runtime_error("left node out of bounds");
-                if(right_node_2 >= instance.no_right_nodes) {
-                    throw std::runtime_error("right node out of bounds");
-                }
-
-                //std::cout << "left_edges[" << i << "] = (" << left_node_1 << "," << left_node_2 << ")\n";
-                //std::cout << "assignment 1 = " << assignment_1 << "\n";
-                //std::cout << "right_edges[" << j << "] = (" << right_node_1 << "," << right_node_2 << ")\n";
-                //std::cout << "assignment 2 = " << assignment_2 << "\n";
-                //std::cout << "quadratic term = " << _quadratic_terms(i,j) << "\n";
+        auto a = py::array::ensure(obj);
+        if(!a)
+            throw py::error_already_set();
+        return a;
+    }
 
-                assert(instance.assignments[assignment_1].left_node == left_node_1);
-                assert(instance.assignments[assignment_1].right_node == right_node_1);
+    edge_list read_edges(const py::object& edge_obj, const std::size_t no_nodes)
+    {
+        const py::array edges = as_array(edge_obj);
+        if(edges.ndim() != 2 || edges.shape(1) != 2)
+            throw std::runtime_error("graph matching python binding: edges must have second dimension = 2");
+        const std::size_t no_edges = edges.shape(0);
+
+        if(py::array_t<std::int32_t, py::array::c_style>::check_(edges))
+            return read_edges(static_cast<const std::int32_t*>(edges.data()), no_edges, no_nodes);
+        if(py::array_t<std::int64_t, py::array::c_style>::check_(edges))
+            return read_edges(static_cast<const std::int64_t*>(edges.data()), no_edges, no_nodes);
+
+        const auto converted = py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>::ensure(edges);
+        if(!converted)
+            throw py::error_already_set();
+        return read_edges(converted.data(), no_edges, no_nodes);
+    }
 
-                assert(instance.assignments[assignment_2].left_node == left_node_2);
-                assert(instance.assignments[assignment_2].right_node == right_node_2);
+    void add_assignments(LPMP::graph_matching_input& instance, const py::object& assignment_costs)
+    {
+        const py::array assignments = as_array(assignment_costs);
+        if(assignments.ndim() != 2)
+            throw std::runtime_error("graph matching python binding: assignments must be two dimensional");
+        const std::size_t dim1 = assignments.shape(0);
+        const std::size_t dim2 = assignments.shape(1);
+        visit_costs(assignments, [&](const auto* a) { add_assignment_costs(instance, a, dim1, dim2, dim2); });
+    }
 
-                if(left_node_1 == left_node_2) 
-                    throw std::runtime_error("left nodes must be distinct");
-                if(right_node_1 == right_node_2)
-                    throw std::runtime_error("right nodes must be distinct");
+    void add_quadratic_terms(LPMP::graph_matching_input& instance, const py::object& quadratic_costs, const py::object& left_edges, const py::object& right_edges)
+    {
+        const py::array quadratic_terms = as_array(quadratic_costs);
+        if(quadratic_terms.ndim() != 2)
+            throw std::runtime_error("graph matching python binding: quadratic terms must be two dimensional");
+        const edge_list l = read_edges(left_edges, instance.no_left_nodes);
+        const edge_list r = read_edges(right_edges, instance.no_right_nodes);
+        if(l.size() != quadratic_terms.shape(0) || r.size() != quadratic_terms.shape(1))
+            throw std::runtime_error("graph matching python binding: dimension incompatibility");
 
-                instance.add_quadratic_term(assignment_1, assignment_2, _quadratic_terms(i,j));
-            }
-        }
+        const std::size_t stride = quadratic_terms.shape(1);
+        visit_costs(quadratic_terms, [&](const auto* q) { add_quadratic_costs(instance, q, l, r, stride); });
     }
 
-    void construct_from_arrays(LPMP::graph_matching_input& instance, const py::array_t<double> assignments, const py::array_t<double> quadratic_terms, const py::array_t<int> left_edges, const py::array_t<int> right_edges)
+    void construct_from_arrays(LPMP::graph_matching_input& instance, const py::object& assignments, const py::object& quadratic_terms, const py::object& left_edges, const py::object& right_edges)
     {
         add_assignments(instance, assignments);
         add_quadratic_terms(instance, quadratic_terms, left_edges, right_edges);
     }
 
-
-    py::array_t<char> get_assignment_mask(LPMP::graph_matching_input::labeling labeling, const py::array_t<double> assignments)
+    py::array_t<char> get_assignment_mask(const LPMP::graph_matching_input::labeling& labeling, const py::object& assignment_costs)
     {
-
-        char* assignment_mask = new char[assignments.size()];
-        assert(assignments.size() == assignments.shape(0)*assignments.shape(1));
-        std::fill(assignment_mask, assignment_mask + assignments.size(), 0);
+        const py::array assignments = as_array(assignment_costs);
+        if(assignments.ndim() != 2)
+            throw std::runtime_error("graph matching python binding: assignments must be two dimensional");
         if(labeling.size() != assignments.shape(0))
             throw std::runtime_error("labeling must be of equal size as first dimension of assignment matrix");
+
+        py::array_t<char> assignment_mask({assignments.shape(0), assignments.shape(1)});
+        char* mask = assignment_mask.mutable_data();
+        std::fill(mask, mask + assignment_mask.size(), 0);
         for(std::size_t i=0; i<labeling.size(); ++i) {
             if(labeling[i] != LPMP::linear_assignment_problem_input::no_assignment) {
                 if(labeling[i] >= assignments.shape(1))
                     throw std::runtime_error("labeling entry not valid");
 
-                assert(i*assignments.shape(1) + labeling[i] < assignments.size());
-                assignment_mask[i*assignments.shape(1) + labeling[i]] = 1;
+                assert(i*assignments.shape(1) + labeling[i] < assignment_mask.size());
+                mask[i*assignments.shape(1) + labeling[i]] = 1;
             }
         }
-        return py::array({assignments.shape(0), assignments.shape(1)}, assignment_mask);
+        return assignment_mask;
     }
 
-    py::array_t<char> get_quadratic_terms_mask(LPMP::graph_matching_input::labeling labeling, const py::array_t<double> quadratic_terms, const py::array_t<int> left_edges, const py::array_t<int> right_edges)
+    py::array_t<char> get_quadratic_terms_mask(const LPMP::graph_matching_input::labeling& labeling, const py::object& quadratic_costs, const py::object& left_edges, const py::object& right_edges)
     {
-        const auto l = left_edges.unchecked<2>();
-        const auto r = right_edges.unchecked<2>();
-        char* quadratic_mask = new char[quadratic_terms.size()];
-        assert(quadratic_terms.size() == quadratic_terms.shape(0)*quadratic_terms.shape(1));
-        std::fill(quadratic_mask, quadratic_mask + quadratic_terms.size(), 0);
-        for(std::size_t i=0; i<quadratic_terms.shape(0); ++i) {
-            for(std::size_t j=0; j<quadratic_terms.shape(1); ++j) {
-                const std::size_t left_node_1 = l(i,0);
-                const std::size_t right_node_1 = r(j,0);
-                const std::size_t left_node_2 = l(i,1);
-                const std::size_t right_node_2 = r(j,1);
-
-                if(labeling[left_node_1] == right_node_1 && labeling[left_node_2] == right_node_2) {
-                    assert(i*quadratic_terms.shape(1) + j < quadratic_terms.size());
-                    quadratic_mask[i*quadratic_terms.shape(1) + j] = 1;
+        const py::array quadratic_terms = as_array(quadratic_costs);
+        if(quadratic_terms.ndim() != 2)
+            throw std::runtime_error("graph matching python binding: quadratic terms must be two dimensional");
+        const edge_list l = read_edges(left_edges, labeling.size());
+        const edge_list r = read_edges(right_edges);
+        if(l.size() != quadratic_terms.shape(0) || r.size() != quadratic_terms.shape(1))
+            throw std::runtime_error("graph matching python binding: dimension incompatibility");
+
+        py::array_t<char> quadratic_mask({quadratic_terms.shape(0), quadratic_terms.shape(1)});
+        char* mask = quadratic_mask.mutable_data();
+        std::fill(mask, mask + quadratic_mask.size(), 0);
+        for(std::size_t i=0; i<l.size(); ++i) {
+            for(std::size_t j=0; j<r.size(); ++j) {
+                if(labeling[l[i][0]] == r[j][0] && labeling[l[i][1]] == r[j][1]) {
+                    assert(i*r.size() + j < quadratic_mask.size());
+                    mask[i*r.size() + j] = 1;
                 }
             }
-        } 
+        }
 
-        return py::array({quadratic_terms.shape(0), quadratic_terms.shape(1)}, quadratic_mask);
+        return quadratic_mask;
     }
 
     }
@@ -1,9 +1,22 @@
 #include "mrf/pairwise_simplex_factor.h"
 #include <array>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 namespace LPMP {
 
+#ifndef NDEBUG
+namespace {
+   // simd kernels add potentials and messages in REAL, the debug checks below in double.
+   // With single precision both differ by rounding errors relative to the summands, not to the result.
+   double rounding_tolerance(const double pairwise, const double msg1, const double msg2)
+   {
+      return eps * std::max(1.0, std::abs(pairwise) + std::abs(msg1) + std::abs(msg2));
+   }
+}
+#endif
+
 PairwiseSimplexFactor::PairwiseSimplexFactor(const std::size_t _dim1, const std::size_t _dim2) 
    : pairwise_(_dim1, _dim2),
    left_msg_(_dim1),
@@ -44,27 +57,32 @@ double PairwiseSimplexFactor::operator()(const std::size_t x1, const std::size_t
    return pairwise_(x1,x2) + left_msg_[x1] + right_msg_[x2];
 }
 
-double& PairwiseSimplexFactor::cost(const std::size_t x1, const std::size_t x2) 
+REAL& PairwiseSimplexFactor::cost(const std::size_t x1, const std::size_t x2) 
 {
    assert(x1 < dim1() && x2 < dim2());
    return pairwise_(x1,x2);
 }
 
-double& PairwiseSimplexFactor::cost(const std::size_t idx) 
+REAL& PairwiseSimplexFactor::cost(const std::size_t idx) 
 {
    const auto [x,y] = get_indices(idx);
    return pairwise_(x,y);
 }
 
-// TODO: make more efficient based on SIMD instructions
 double PairwiseSimplexFactor::LowerBound() const
 {
-   double lb = std::numeric_limits<double>::infinity();
+   const double lb = pairwise_.min(left_msg_, right_msg_);
+#ifndef NDEBUG
+   double lb_test = std::numeric_limits<double>::infinity();
+   double tolerance = 0.0;
    for(std::size_t x1=0; x1<dim1(); ++x1) {
       for(std::size_t x2=0; x2<dim2(); ++x2) {
-         lb = std::min(lb, (*this)(x1,x2));
+         lb_test = std::min(lb_test, (*this)(x1,x2));
+         tolerance = std::max(tolerance, rounding_tolerance(pairwise_(x1,x2), left_msg_[x1], right_msg_[x2]));
       }
    }
+   assert(std::abs(lb - lb_test) <= tolerance);
+#endif
    assert(std::isfinite(lb));
    return lb;
 }
@@ -144,33 +162,37 @@ PairwiseSimplexFactor::MaximizePotentialAndComputePrimal()
    }
 }
 
-vector<double> 
+vector<REAL> 
 PairwiseSimplexFactor::min_marginal_1() const
 {
-   auto min = pairwise_.min1(right_msg_);
-   min += left_msg_;
+   auto min = pairwise_.min1(right_msg_, left_msg_);
 #ifndef NDEBUG
    for(std::size_t x1=0; x1<dim1(); ++x1) {
        double msg_test = std::numeric_limits<double>::infinity();
-       for(std::size_t x2=0; x2<dim2(); ++x2)
+       double tolerance = 0.0;
+       for(std::size_t x2=0; x2<dim2(); ++x2) {
            msg_test = std::min(msg_test, (*this)(x1,x2));
-       assert(std::abs(msg_test - min[x1]) <= eps);
+           tolerance = std::max(tolerance, rounding_tolerance(pairwise_(x1,x2), left_msg_[x1], right_msg_[x2]));
+       }
+       assert(std::abs(msg_test - min[x1]) <= tolerance);
    } 
 #endif
    return min;
 }
 
-vector<double> 
+vector<REAL> 
 PairwiseSimplexFactor::min_marginal_2() const
 {
-   auto min = pairwise_.min2(left_msg_);
-   min += right_msg_;
+   auto min = pairwise_.min2(left_msg_, right_msg_);
 #ifndef NDEBUG
    for(std::size_t x2=0; x2<dim2(); ++x2) {
        double msg_test = std::numeric_limits<double>::infinity();
-       for(std::size_t x1=0; x1<dim1(); ++x1)
+       double tolerance = 0.0;
+       for(std::size_t x1=0; x1<dim1(); ++x1) {
            msg_test = std::min(msg_test, (*this)(x1,x2));
-       assert(std::abs(msg_test - min[x2]) <= eps);
+           tolerance = std::max(tolerance, rounding_tolerance(pairwise_(x1,x2), left_msg_[x1], right_msg_[x2]));
+       }
+       assert(std::abs(msg_test - min[x2]) <= tolerance);
    } 
 #endif 
    return min; 
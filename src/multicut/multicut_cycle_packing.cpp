@@ -8,7 +8,10 @@
 #include <chrono>
 #include <unordered_map>
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <omp.h>
+#include "atomic_helper.h"
 
 namespace LPMP {
 
@@ -16,6 +19,35 @@ constexpr static double tolerance = 1e-8;
 
 struct weighted_edge : public std::array<std::size_t,2> { double cost; };
 
+using capacity_graph = graph<CopyableAtomic<double>>;
+
+// atomically take cap from the remaining capacity of all edges of the cycle. Either all edges are reserved or none.
+// The edge with smaller first endpoint holds the authoritative capacity, its sister is updated afterwards and hence may transiently be larger.
+static bool reserve_cycle_capacity(capacity_graph& g, const std::vector<std::size_t>& cycle, const double cap)
+{
+   auto reserve_edge = [&](const std::size_t i, const std::size_t j) {
+      auto& c = g.edge(std::min(i,j), std::max(i,j));
+      double cur = c.load();
+      do {
+         if(cur < cap) return false;
+      } while(!c.compare_exchange_weak(cur, cur - cap));
+      return true;
+   };
+
+   for(std::size_t c=1; c<cycle.size(); ++c) {
+      if(!reserve_edge(cycle[c-1], cycle[c])) {
+         for(std::size_t c_r=1; c_r<c; ++c_r) {
+            atomic_addition(g.edge(std::min(cycle[c_r-1], cycle[c_r]), std::max(cycle[c_r-1], cycle[c_r])), cap);
+         }
+         return false;
+      }
+   }
+   for(std::size_t c=1; c<cycle.size(); ++c) {
+      atomic_addition(g.edge(std::max(cycle[c-1], cycle[c]), std::min(cycle[c-1], cycle[c])), -cap);
+   }
+   return true;
+}
+
 cycle_packing multicut_cycle_packing_impl(const multicut_instance& input, const bool record_cycles)
 {
    const auto begin_time = std::chrono::steady_clock::now();
@@ -36,13 +68,15 @@ cycle_packing multicut_cycle_packing_impl(const multicut_instance& input, const
    std::cout << "#repulsive edges = " << repulsive_edges.size() << "\n";
    std::cout << "#attractive edges = " << positive_edges.size() << "\n";
 
-   graph<double> pos_edges_graph(positive_edges.begin(), positive_edges.end(), [](const weighted_edge& e) { return e.cost; });
+   capacity_graph pos_edges_graph;
+   pos_edges_graph.construct(positive_edges.begin(), positive_edges.end(), [](const weighted_edge& e) { return e.cost; });
    cycle_packing cp;
+   std::vector<cycle_packing> cp_thread(omp_get_max_threads());
 
    const auto initialization_end_time = std::chrono::steady_clock::now();
    std::cout << "initialization took " <<  std::chrono::duration_cast<std::chrono::milliseconds>(initialization_end_time - begin_time).count() << " milliseconds\n";
 
-   // build up connectivity w.r.t. current positive edges
+   // connectivity w.r.t. current positive edges. Capacities only decrease while packing, hence nodes disconnected at the beginning of a round stay so.
    union_find uf(input.no_nodes());
    auto compute_connectivity = [&]() {
         uf.reset();
@@ -50,99 +84,89 @@ cycle_packing multicut_cycle_packing_impl(const multicut_instance& input, const
               if(cost >= tolerance) uf.merge(i,j);
         });
    };
-   auto connected = [&](const std::size_t i, const std::size_t j) -> bool { return uf.connected(i,j); };
 
    // iteratively pack cycles of given length
    const std::array<std::size_t,11> cycle_lengths = {1,2,3,4,5,6,7,8,9,10,std::numeric_limits<std::size_t>::max()};
    for(const std::size_t cycle_length : cycle_lengths) {
       std::cout << "find cycles of length " << cycle_length << ", with #repulsive edges = " << repulsive_edges.size() << " remaining, lower bound = " << lower_bound << "\n";
-      //compute_connectivity();
+      compute_connectivity();
 
       // shuffling can give great speed-up if edges with similar indices are spatially close in the graph
       std::random_shuffle(repulsive_edges.begin(), repulsive_edges.end());
 
-      std::size_t progress = 0;
-
-      bfs_data<graph<double>> bfs(pos_edges_graph);
-
-      for(std::size_t i=0; i<repulsive_edges.size(); ++i) {
-         auto& re = repulsive_edges[i];
-
-         // periodically update component labeling for speed-up
-         progress++;
-         if (progress > 0.05 * repulsive_edges.size()) {
-            compute_connectivity();
-            progress = 0;
-         }
-
-         // check if conflicted cycle exists and repulsive edge has positive weight
-         if(-re.cost <= tolerance || !connected(re[0], re[1]) || std::max(re[0], re[1]) >= pos_edges_graph.no_nodes()) {
-            const std::size_t imax = repulsive_edges.size() - 1;
-            repulsive_edges[i] = repulsive_edges[imax];
-            repulsive_edges.resize(imax);
-            i--;
-            continue;
-         }
-
-         // balance short cycles as long as available and positive weight left
-         auto mask_small_edges = [cycle_length](const std::size_t i, const std::size_t j, const double cost, const std::size_t distance) {
-            if(cost <= tolerance) return false;
-            if(distance >= cycle_length) return false;
-            return true;
-         };
+      // balance short cycles as long as available and positive weight left
+      auto mask_small_edges = [cycle_length](const std::size_t i, const std::size_t j, const double cost, const std::size_t distance) {
+         if(cost <= tolerance) return false;
+         if(distance >= cycle_length) return false;
+         return true;
+      };
+
+      // bounded bfs from many repulsive edges concurrently, capacities of found cycles are reserved atomically on the positive edge graph
+#pragma omp parallel reduction(+:lower_bound)
+      {
+         bfs_data<capacity_graph> bfs(pos_edges_graph);
          std::vector<std::size_t> cycle;
+         cycle_packing& cp_local = cp_thread[omp_get_thread_num()];
+
+#pragma omp for schedule(dynamic,64)
+         for(std::size_t i=0; i<repulsive_edges.size(); ++i) {
+            auto& re = repulsive_edges[i];
+
+            // check if conflicted cycle exists and repulsive edge has positive weight
+            if(-re.cost <= tolerance || std::max(re[0], re[1]) >= pos_edges_graph.no_nodes() || !uf.thread_safe_connected(re[0], re[1]))
+               continue;
+
+            // reservation fails if other threads have used up capacity of the cycle in the meantime, then search again
+            constexpr std::size_t max_reservation_failures = 8;
+            std::size_t reservation_failures = 0;
+            while(-re.cost > tolerance && reservation_failures < max_reservation_failures) {
+               double cycle_cap = std::numeric_limits<double>::infinity();
+               auto cycle_capacity = [&cycle_cap](const std::size_t i, const std::size_t j, const double cost) { cycle_cap = std::min(cycle_cap, cost); };
+               bfs.find_path(re[0], re[1], mask_small_edges, cycle_capacity, cycle);
+               cycle_cap = std::min(cycle_cap, -re.cost);
+               if(cycle.size() == 0 || cycle_cap < tolerance)
+                  break;
 
-         while(-re.cost > tolerance) {
-            double cycle_cap = std::numeric_limits<double>::infinity();
-            auto cycle_capacity = [&cycle_cap](const std::size_t i, const std::size_t j, const double cost) { cycle_cap = std::min(cycle_cap, cost); };
-            std::vector<std::size_t> cycle = bfs.find_path(re[0], re[1], mask_small_edges, cycle_capacity); // possibly do not reallocate for every search but give as argument to find_path
-            cycle_cap = std::min(cycle_cap, -re.cost);
-            if(cycle.size() > 0 && cycle_cap >= tolerance) {
+               if(!reserve_cycle_capacity(pos_edges_graph, cycle, cycle_cap)) {
+                  ++reservation_failures;
+                  continue;
+               }
 
                if(record_cycles)
-                  cp.add_cycle(cycle.begin(), cycle.end(), cycle_cap);
+                  cp_local.add_cycle(cycle.begin(), cycle.end(), cycle_cap);
 
-               // subtract minimum weight and remove edges of negligible weight
                assert(-re.cost >= cycle_cap && re.cost <= 0.0);
                re.cost += cycle_cap;
                assert(re.cost <= 0.0);
-               for(std::size_t c=1; c<cycle.size(); ++c) {
-                  pos_edges_graph.edge(cycle[c-1], cycle[c]) -= cycle_cap;
-                  pos_edges_graph.edge(cycle[c], cycle[c-1]) -= cycle_cap;
-
-                  assert(pos_edges_graph.edge(cycle[c-1], cycle[c]) >= 0.0);
-                  assert(pos_edges_graph.edge(cycle[c], cycle[c-1]) >= 0.0);
-                  assert(pos_edges_graph.edge(cycle[c-1], cycle[c]) == pos_edges_graph.edge(cycle[c], cycle[c-1]));
-               }
-
                lower_bound += cycle_cap;
-
-               // remove repulsive edge if weight is negligible
-               if (-re.cost <= tolerance) {
-                  auto imax = repulsive_edges.size() - 1;
-                  repulsive_edges[i] = repulsive_edges[imax];
-                  repulsive_edges.resize(imax);
-                  i--;
-                  break;
-               }
-            } else {
-               break;
             }
          }
-         }
+      }
+
+      // remove repulsive edges of negligible weight or without conflicted cycle
+      repulsive_edges.erase(std::remove_if(repulsive_edges.begin(), repulsive_edges.end(), [&](const weighted_edge& re) {
+               return -re.cost <= tolerance || std::max(re[0], re[1]) >= pos_edges_graph.no_nodes() || !uf.connected(re[0], re[1]);
+               }), repulsive_edges.end());
 
-         // terminate if no conflicted cycle remains
-         if (repulsive_edges.empty())
-            break;
+      // terminate if no conflicted cycle remains
+      if (repulsive_edges.empty())
+         break;
+   }
+
+   for(const auto& cp_local : cp_thread) {
+      for(std::size_t c=0; c<cp_local.no_cycles(); ++c) {
+         const auto [cycle_begin, cycle_end] = cp_local.get_cycle(c);
+         cp.add_cycle(cycle_begin, cycle_end, cp_local.get_cycle_weight(c));
       }
+   }
 
-      const auto end_time = std::chrono::steady_clock::now();
-      std::cout << "Optimization took " <<  std::chrono::duration_cast<std::chrono::milliseconds>(end_time - begin_time).count() << " milliseconds\n";
+   const auto end_time = std::chrono::steady_clock::now();
+   std::cout << "Optimization took " <<  std::chrono::duration_cast<std::chrono::milliseconds>(end_time - begin_time).count() << " milliseconds\n";
 
-      std::cout << "final lower bound = " << lower_bound << "\n";
-      std::cout << "#repulsive edges = " << repulsive_edges.size() << "\n";
+   std::cout << "final lower bound = " << lower_bound << "\n";
+   std::cout << "#repulsive edges = " << repulsive_edges.size() << "\n";
 
-      return cp;
+   return cp;
 }
 
 void multicut_cycle_packing(const multicut_instance& input)
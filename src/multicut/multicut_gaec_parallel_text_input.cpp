@@ -2,6 +2,7 @@
 #include "multicut/multicut_greedy_additive_edge_contraction_parallel.h"
 #include "multicut/multicut_greedy_additive_edge_contraction.h"
 #include "multicut/multicut_cycle_packing_parallel.h"
+#include "multicut/multicut_kernighan_lin_parallel.h"
 #include "multicut/multicut_text_input.h"
 #include <iostream>
 #include <chrono>
@@ -21,15 +22,18 @@ int main(int argc, char** argv)
 		allowed.push_back("round_robin_sorted");
 		allowed.push_back("chunk_not_sorted");
         allowed.push_back("non-blocking");
+        allowed.push_back("concurrent");
 		TCLAP::ValuesConstraint<std::string> allowedVals(allowed);
 
         TCLAP::ValueArg<std::string> nameArg("i","inputFile","Path to the input file.",true,"","string");
         TCLAP::ValueArg<std::string> threadArg("t","numThreads","Number of threads.",true,"1","int");
         TCLAP::ValueArg<std::string> optArg("x","edgeDistribution","Methods to distribute edges.",true,"round_robin_sorted", &allowedVals);
+        TCLAP::SwitchArg klArg("k","kernighanLin","Improve solution with parallel Kernighan&Lin local search.",false);
 
         cmd.add(nameArg);
         cmd.add(threadArg);
         cmd.add(optArg);
+        cmd.add(klArg);
         cmd.parse(argc, argv);
 
         const std::string filename = nameArg.getValue();
@@ -52,6 +56,14 @@ int main(int argc, char** argv)
             const auto end_time = std::chrono::steady_clock::now();
             std::cout << "Parallel gaec energy = " << input.evaluate(sol) << "\n";
             std::cout << "Parallel optimization took " <<  std::chrono::duration_cast<std::chrono::milliseconds>(end_time - begin_time).count() << " milliseconds\n";
+
+            if(klArg.getValue()) {
+                const auto kl_begin_time = std::chrono::steady_clock::now();
+                const multicut_edge_labeling kl = compute_multicut_kernighan_lin_parallel(input, sol, nr_of_threads);
+                const auto kl_end_time = std::chrono::steady_clock::now();
+                std::cout << "Parallel K&L energy = " << input.evaluate(kl) << "\n";
+                std::cout << "Parallel K&L took " <<  std::chrono::duration_cast<std::chrono::milliseconds>(kl_end_time - kl_begin_time).count() << " milliseconds\n";
+            }
         }
 
     } catch (TCLAP::ArgException &e) { std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl; }
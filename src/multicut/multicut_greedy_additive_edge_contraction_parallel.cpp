@@ -3,6 +3,8 @@
 #include <cassert>
 #include <functional>
 #include <chrono>
+#include <thread>
+#include <limits>
 #include "union_find.hxx"
 #include "dynamic_graph_thread_safe.hxx"
 #include "multicut/multicut_greedy_additive_edge_contraction_parallel.h"
@@ -264,8 +266,109 @@ namespace LPMP {
         //std::chrono::duration_cast<std::chrono::milliseconds>(end_time - begin_time).count() << " milliseconds\n";
     }
 
+    // Edges are contracted concurrently by all threads. Before contracting, a thread locks both endpoints and their neighbors in the graph.
+    // Edges whose neighborhood is locked by another thread are deferred and retried once the own queue runs empty.
+    // After max_conflict_rounds such retries the still conflicting edges are left in Q for a serial phase, so that threads do not spin on each other's locks.
+    void gaec_concurrent(dynamic_graph_thread_safe<edge_type>& g, pq_t& Q, concurrent_union_find& partition, const std::size_t max_conflict_rounds)
+    {
+        std::vector<edge_type_q> conflicted;
+        std::vector<std::size_t> locked_nodes;
+        std::size_t conflict_rounds = 0;
+
+        auto merge_edges = [](edge_type& stable_edge, const edge_type& removed_edge) {
+            stable_edge.cost += removed_edge.cost;
+            stable_edge.stamp++;
+        };
+
+        while(!Q.empty() || !conflicted.empty()) {
+            if(Q.empty()) {
+                for(const auto& c : conflicted)
+                    Q.push(c);
+                conflicted.clear();
+                if(conflict_rounds++ == max_conflict_rounds)
+                    return;
+                std::this_thread::yield();
+            }
+
+            const edge_type_q e_q = Q.top();
+            Q.pop();
+            const std::size_t i = e_q[0];
+            const std::size_t j = e_q[1];
+
+            if(!g.try_lock_node(i)) {
+                conflicted.push_back(e_q);
+                continue;
+            }
+            if(!g.try_lock_node(j)) {
+                g.unlock_node(i);
+                conflicted.push_back(e_q);
+                continue;
+            }
+            locked_nodes.clear();
+            locked_nodes.push_back(i);
+            locked_nodes.push_back(j);
+
+            // outdated queue entry
+            if(!g.edge_present(i,j) || e_q.stamp < g.edge(i,j).stamp || g.edge(i,j).cost <= 0.0) {
+                g.unlock_nodes(locked_nodes);
+                continue;
+            }
+
+            if(!g.try_lock_neighborhood(i, j, locked_nodes)) {
+                g.unlock_nodes(locked_nodes);
+                conflicted.push_back(e_q);
+                continue;
+            }
+
+            partition.merge(i,j);
+            g.contract_edge(i, j, merge_edges, [&](const std::size_t stable_node, const std::size_t head, const edge_type& e) {
+                    if(e.cost > 0.0)
+                        Q.push(edge_type_q{stable_node, head, e.cost, e.stamp, g.no_edges(stable_node) + g.no_edges(head)});
+                    });
+
+            g.unlock_nodes(locked_nodes);
+        }
+    }
+
+    multicut_edge_labeling greedy_additive_edge_contraction_concurrent(const multicut_instance& instance, const int nr_threads, const std::size_t max_conflict_rounds)
+    {
+        dynamic_graph_thread_safe<edge_type> g(instance.edges().begin(), instance.edges().end(), [](const auto& e) -> edge_type { return {e.cost, 0}; });
+        concurrent_union_find partition(instance.no_nodes());
+
+        // positive edges go to the thread owning their first endpoint, so that neighboring contractions of one thread rarely conflict with other threads
+        std::vector<pq_t> queues(nr_threads, pq_t(pq_cmp));
+        const std::size_t nodes_batch_size = instance.no_nodes()/nr_threads + 1;
+        for(const auto& e : instance.edges())
+            if(e.cost > 0.0)
+                queues[std::min(e[0],e[1])/nodes_batch_size].push(edge_type_q{e[0], e[1], e.cost, 0, g.no_edges(e[0]) + g.no_edges(e[1])});
+
+        tf::Executor executor(nr_threads);
+        tf::Taskflow taskflow;
+        taskflow.for_each_index(0, nr_threads, 1, [&](const std::size_t thread_no) {
+                gaec_concurrent(g, queues[thread_no], partition, max_conflict_rounds);
+                });
+        executor.run(taskflow).wait();
+
+        // serial phase for edges that kept conflicting. No other thread holds locks anymore, hence no conflicts occur.
+        pq_t remaining_edges(pq_cmp);
+        for(auto& Q : queues) {
+            for(; !Q.empty(); Q.pop())
+                remaining_edges.push(Q.top());
+        }
+        gaec_concurrent(g, remaining_edges, partition, std::numeric_limits<std::size_t>::max());
+        assert(remaining_edges.empty());
+
+        multicut_node_labeling node_labeling(instance.no_nodes());
+        for(std::size_t i=0; i<instance.no_nodes(); ++i)
+            node_labeling[i] = partition.find(i);
+        return multicut_edge_labeling(instance, node_labeling);
+    }
+
     multicut_edge_labeling greedy_additive_edge_contraction_parallel(const multicut_instance& instance, const int nr_threads, const std::string option)
     {
+        if(option == "concurrent")
+            return greedy_additive_edge_contraction_concurrent(instance, nr_threads);
+
         const auto begin_time = std::chrono::steady_clock::now();
 
         union_find partition(instance.no_nodes());
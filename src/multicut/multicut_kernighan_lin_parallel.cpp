@@ -0,0 +1,275 @@
+#include "multicut/multicut_kernighan_lin_parallel.h"
+#include "multicut/multicut_greedy_additive_edge_contraction_parallel.h"
+#include <queue>
+#include <tuple>
+#include <numeric>
+#include <algorithm>
+#include <cassert>
+#include <tsl/robin_map.h>
+#include <omp.h>
+
+namespace LPMP {
+
+    constexpr static double kernighan_lin_eps = 1e-9;
+
+    multicut_kernighan_lin_parallel::multicut_kernighan_lin_parallel(const multicut_instance& instance)
+        : instance_(instance)
+    {
+        g_.construct(instance.edges().begin(), instance.edges().end(),
+                [](const auto& e) { return e.cost[0]; }
+                );
+    }
+
+    multicut_edge_labeling multicut_kernighan_lin_parallel::optimize(const multicut_edge_labeling& labeling, const int nr_threads, const std::size_t max_outer_iterations) const
+    {
+        multicut_node_labeling node_labeling;
+        if(labeling.size() == instance_.no_edges()) {
+            node_labeling = labeling.transform_to_node_labeling(instance_);
+        } else { // start from singleton clusters
+            node_labeling.resize(instance_.no_nodes());
+            std::iota(node_labeling.begin(), node_labeling.end(), 0);
+        }
+
+        return optimize(node_labeling, nr_threads, max_outer_iterations).transform_to_edge_labeling(instance_);
+    }
+
+    multicut_node_labeling multicut_kernighan_lin_parallel::optimize(multicut_node_labeling labeling, const int nr_threads, const std::size_t max_outer_iterations) const
+    {
+        assert(labeling.size() == instance_.no_nodes());
+        if(labeling.size() == 0)
+            return labeling;
+
+        // make cluster labels consecutive
+        std::size_t no_clusters = 0;
+        {
+            std::vector<std::size_t> label_map(*std::max_element(labeling.begin(), labeling.end()) + 1, new_cluster);
+            for(auto& l : labeling) {
+                if(label_map[l] == new_cluster)
+                    label_map[l] = no_clusters++;
+                l = label_map[l];
+            }
+        }
+
+        std::vector<char> changed(no_clusters, 1);
+        std::vector<std::size_t> cluster_offsets;
+        std::vector<std::size_t> cluster_nodes(labeling.size());
+        std::vector<two_cluster_moves> moves;
+
+        for(std::size_t iter=0; iter<max_outer_iterations; ++iter) {
+            const auto rounds = cluster_pair_rounds(labeling, no_clusters, changed);
+            std::vector<char> changed_next(no_clusters, 0);
+            double improvement = 0.0;
+
+            for(const auto& round : rounds) {
+                // group nodes by cluster
+                cluster_offsets.assign(no_clusters+1, 0);
+                for(const std::size_t l : labeling)
+                    cluster_offsets[l+1]++;
+                std::partial_sum(cluster_offsets.begin(), cluster_offsets.end(), cluster_offsets.begin());
+                {
+                    std::vector<std::size_t> fill_pos(cluster_offsets.begin(), cluster_offsets.end()-1);
+                    for(std::size_t i=0; i<labeling.size(); ++i)
+                        cluster_nodes[fill_pos[labeling[i]]++] = i;
+                }
+
+                // pairs of one round share no cluster, hence their moves can be computed independently
+                moves.clear();
+                moves.resize(round.size());
+#pragma omp parallel for schedule(dynamic) num_threads(nr_threads)
+                for(std::size_t p=0; p<round.size(); ++p)
+                    moves[p] = optimize_cluster_pair(cluster_offsets, cluster_nodes, round[p][0], round[p][1]);
+
+                for(std::size_t p=0; p<round.size(); ++p) {
+                    if(moves[p].gain <= kernighan_lin_eps)
+                        continue;
+                    const std::size_t first = round[p][0];
+                    std::size_t second = round[p][1];
+                    if(second == new_cluster) {
+                        second = no_clusters++;
+                        changed_next.push_back(0);
+                    }
+                    for(const std::size_t i : moves[p].to_first)
+                        labeling[i] = first;
+                    for(const std::size_t i : moves[p].to_second)
+                        labeling[i] = second;
+                    changed_next[first] = 1;
+                    changed_next[second] = 1;
+                    improvement += moves[p].gain;
+                }
+            }
+
+            if(improvement <= kernighan_lin_eps)
+                break;
+            std::swap(changed, changed_next);
+        }
+
+        return labeling;
+    }
+
+    // Pairs of adjacent clusters of which at least one has changed in the previous iteration, and pairs of changed clusters with a new one.
+    // Rounds are built as successive maximal sets of cluster-disjoint pairs.
+    std::vector<std::vector<std::array<std::size_t,2>>> multicut_kernighan_lin_parallel::cluster_pair_rounds(const multicut_node_labeling& labeling, const std::size_t no_clusters, const std::vector<char>& changed) const
+    {
+        assert(changed.size() == no_clusters);
+        std::vector<std::array<std::size_t,2>> pairs;
+        for(const auto& e : instance_.edges()) {
+            const std::size_t c1 = labeling[e[0]];
+            const std::size_t c2 = labeling[e[1]];
+            if(c1 != c2 && (changed[c1] || changed[c2]))
+                pairs.push_back({std::min(c1,c2), std::max(c1,c2)});
+        }
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+        std::vector<std::size_t> cluster_size(no_clusters, 0);
+        for(const std::size_t l : labeling)
+            cluster_size[l]++;
+        for(std::size_t c=0; c<no_clusters; ++c)
+            if(changed[c] && cluster_size[c] > 1)
+                pairs.push_back({c, new_cluster});
+
+        std::vector<std::vector<std::array<std::size_t,2>>> rounds;
+        std::vector<std::size_t> last_round(no_clusters, std::numeric_limits<std::size_t>::max());
+        std::vector<std::array<std::size_t,2>> remaining;
+        while(!pairs.empty()) {
+            const std::size_t r = rounds.size();
+            rounds.push_back({});
+            remaining.clear();
+            for(const auto& p : pairs) {
+                const bool second_free = p[1] == new_cluster || last_round[p[1]] != r;
+                if(last_round[p[0]] != r && second_free) {
+                    last_round[p[0]] = r;
+                    if(p[1] != new_cluster)
+                        last_round[p[1]] = r;
+                    rounds.back().push_back(p);
+                } else {
+                    remaining.push_back(p);
+                }
+            }
+            std::swap(pairs, remaining);
+        }
+
+        return rounds;
+    }
+
+    // Greedily move nodes between the two clusters, each node at most once, and keep the best prefix of the move sequence.
+    // Moving a node only changes the cut status of edges inside the two clusters, hence pairs of disjoint clusters do not interact.
+    multicut_kernighan_lin_parallel::two_cluster_moves multicut_kernighan_lin_parallel::optimize_cluster_pair(
+            const std::vector<std::size_t>& cluster_offsets, const std::vector<std::size_t>& cluster_nodes, const std::size_t first, const std::size_t second) const
+    {
+        two_cluster_moves result;
+
+        std::vector<std::size_t> nodes;
+        std::vector<char> side;
+        for(std::size_t k=cluster_offsets[first]; k<cluster_offsets[first+1]; ++k) {
+            nodes.push_back(cluster_nodes[k]);
+            side.push_back(0);
+        }
+        if(second != new_cluster) {
+            for(std::size_t k=cluster_offsets[second]; k<cluster_offsets[second+1]; ++k) {
+                nodes.push_back(cluster_nodes[k]);
+                side.push_back(1);
+            }
+        }
+        if(nodes.size() < 2)
+            return result;
+
+        tsl::robin_map<std::size_t, std::size_t> local_index;
+        local_index.reserve(nodes.size());
+        for(std::size_t k=0; k<nodes.size(); ++k)
+            local_index.insert({nodes[k], k});
+
+        // gain of moving a node to the other side: weight to other side minus weight to own side
+        std::vector<double> gain(nodes.size(), 0.0);
+        std::vector<char> boundary(nodes.size(), 0);
+        double cross_weight = 0.0;
+        for(std::size_t k=0; k<nodes.size(); ++k) {
+            assert(nodes[k] < g_.no_nodes());
+            for(auto edge_it=g_.begin(nodes[k]); edge_it!=g_.end(nodes[k]); ++edge_it) {
+                const auto it = local_index.find(edge_it->head());
+                if(it == local_index.end())
+                    continue;
+                if(side[it->second] == side[k]) {
+                    gain[k] -= edge_it->edge();
+                } else {
+                    gain[k] += edge_it->edge();
+                    cross_weight += edge_it->edge();
+                    boundary[k] = 1;
+                }
+            }
+        }
+        cross_weight /= 2.0;
+
+        using queue_item = std::tuple<double, std::size_t, std::size_t>; // gain, local node index, version
+        std::priority_queue<queue_item> queue;
+        std::vector<std::size_t> version(nodes.size(), 0);
+        std::vector<char> locked(nodes.size(), 0);
+        for(std::size_t k=0; k<nodes.size(); ++k)
+            if(second == new_cluster || boundary[k])
+                queue.push({gain[k], k, 0});
+
+        std::vector<std::size_t> sequence;
+        double cumulative_gain = 0.0;
+        double best_gain = 0.0;
+        std::size_t best_length = 0;
+        while(!queue.empty()) {
+            const auto [g, k, v] = queue.top();
+            queue.pop();
+            if(locked[k] || v != version[k])
+                continue;
+
+            locked[k] = 1;
+            const char prev_side = side[k];
+            side[k] = 1 - prev_side;
+            sequence.push_back(k);
+            cumulative_gain += g;
+            if(cumulative_gain > best_gain + kernighan_lin_eps) {
+                best_gain = cumulative_gain;
+                best_length = sequence.size();
+            }
+
+            for(auto edge_it=g_.begin(nodes[k]); edge_it!=g_.end(nodes[k]); ++edge_it) {
+                const auto it = local_index.find(edge_it->head());
+                if(it == local_index.end() || locked[it->second])
+                    continue;
+                const std::size_t l = it->second;
+                gain[l] += side[l] == prev_side ? 2.0*edge_it->edge() : -2.0*edge_it->edge();
+                queue.push({gain[l], l, ++version[l]});
+            }
+        }
+
+        // joining both clusters
+        if(second != new_cluster && cross_weight > best_gain + kernighan_lin_eps) {
+            result.gain = cross_weight;
+            result.to_first.assign(cluster_nodes.begin() + cluster_offsets[second], cluster_nodes.begin() + cluster_offsets[second+1]);
+            return result;
+        }
+
+        result.gain = best_gain;
+        for(std::size_t s=0; s<best_length; ++s) {
+            const std::size_t k = sequence[s];
+            // each node is moved at most once, hence side[k] is the side it is moved to
+            if(side[k] == 1)
+                result.to_second.push_back(nodes[k]);
+            else
+                result.to_first.push_back(nodes[k]);
+        }
+
+        return result;
+    }
+
+    multicut_edge_labeling compute_multicut_kernighan_lin_parallel(const multicut_instance& instance, const multicut_edge_labeling& labeling, const int nr_threads)
+    {
+        if(instance.no_edges() == 0)
+            return labeling;
+        multicut_kernighan_lin_parallel kl(instance);
+        return kl.optimize(labeling, nr_threads);
+    }
+
+    multicut_edge_labeling compute_multicut_gaec_kernighan_lin_parallel(const multicut_instance& instance, const int nr_threads)
+    {
+        const multicut_edge_labeling gaec_labeling = greedy_additive_edge_contraction_parallel(instance, nr_threads, "non-blocking");
+        return compute_multicut_kernighan_lin_parallel(instance, gaec_labeling, nr_threads);
+    }
+
+} // namespace LPMP
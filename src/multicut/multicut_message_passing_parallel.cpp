@@ -10,6 +10,7 @@
 #include <atomic>
 #include <unordered_map>
 #include <algorithm>
+#include <memory>
 #include <cassert>
 #include <taskflow/taskflow.hpp>
 #include "multicut/multicut_cycle_packing_parallel.h"
@@ -19,44 +20,100 @@
 
 namespace LPMP {
 
-    void send_weights_to_triplets(edge_item& e, std::vector<triangle_item>& triangle_to_edge) {
-        assert(e.nodes[0] < e.nodes[1]);
-        auto tmp_cost = e.cost; 
-        e.cost.store(0.0);
-        auto nr_triangles = e.triangle_indices.size();
-        assert(nr_triangles > 0);
-        for (auto t: e.triangle_indices){
-            std::array<std::pair<size_t, int>,3> sorted_nodes = {std::make_pair(e.nodes[0],0),std::make_pair(e.nodes[1],1),std::make_pair(t[0],2)};
-            std::sort(sorted_nodes.begin(), sorted_nodes.end(), [](std::pair<size_t, double> n1, std::pair<size_t, double> n2) {return n1.first < n2.first;});
-            std::size_t i=sorted_nodes[0].first, j=sorted_nodes[1].first, k=sorted_nodes[2].first;
-            if (sorted_nodes[0].second == 2){
-                atomic_addition(triangle_to_edge[t[1]].weights[1], tmp_cost/nr_triangles);
-            } else if (sorted_nodes[1].second == 2){
-                atomic_addition(triangle_to_edge[t[1]].weights[2], tmp_cost/nr_triangles);
-            } else {
-                atomic_addition(triangle_to_edge[t[1]].weights[0], tmp_cost/nr_triangles);
+    // Edges and triangles are split into contiguous blocks, many more than threads, so that taskflow's work stealing balances skewed triangle degrees.
+    // Each message passing phase only writes to edges or triangles of its own block, hence no atomics are needed within a phase.
+    // Phases are separated by task dependencies.
+    struct message_passing_schedule {
+        std::vector<std::size_t> edge_blocks; // edges edge_blocks[b], ..., edge_blocks[b+1]-1 belong to block b
+        std::vector<std::size_t> triangle_blocks;
+        std::vector<double> edge_shares; // edge cost divided by number of triangles containing the edge
+        std::vector<std::array<double,3>> triangle_messages; // messages from triangle to edges ij, jk, ik
+    };
+
+    constexpr static std::size_t blocks_per_thread = 8;
+    constexpr static std::size_t min_block_work = 1024;
+
+    template<typename WORK_FUNC>
+    std::vector<std::size_t> balanced_blocks(const std::size_t n, const std::size_t nr_blocks, WORK_FUNC work)
+    {
+        std::size_t total_work = 0;
+        for(std::size_t i=0; i<n; ++i)
+            total_work += work(i);
+        const std::size_t block_work = std::max(total_work/std::max(nr_blocks, std::size_t(1)) + 1, min_block_work);
+
+        std::vector<std::size_t> offsets = {0};
+        std::size_t current_work = 0;
+        for(std::size_t i=0; i<n; ++i) {
+            current_work += work(i);
+            if(current_work >= block_work) {
+                offsets.push_back(i+1);
+                current_work = 0;
             }
         }
+        if(offsets.back() != n)
+            offsets.push_back(n);
+        return offsets;
+    }
+
+    std::shared_ptr<message_passing_schedule> construct_message_passing_schedule(std::vector<edge_item>& edge_to_triangle, const std::vector<triangle_item>& triangle_to_edge, const int nr_threads)
+    {
+        // the triangulation records a triangle for an edge each time a cycle passes through it. Messages are sent once per distinct triangle.
+        for(auto& e : edge_to_triangle) {
+            std::sort(e.triangle_indices.begin(), e.triangle_indices.end());
+            e.triangle_indices.erase(std::unique(e.triangle_indices.begin(), e.triangle_indices.end()), e.triangle_indices.end());
+        }
+
+        auto schedule = std::make_shared<message_passing_schedule>();
+        const std::size_t nr_blocks = blocks_per_thread * std::max(nr_threads, 1);
+        schedule->edge_blocks = balanced_blocks(edge_to_triangle.size(), nr_blocks, [&](const std::size_t e) { return edge_to_triangle[e].triangle_indices.size() + 1; });
+        schedule->triangle_blocks = balanced_blocks(triangle_to_edge.size(), nr_blocks, [](const std::size_t t) { return std::size_t(3); });
+        schedule->edge_shares.resize(edge_to_triangle.size(), 0.0);
+        schedule->triangle_messages.resize(triangle_to_edge.size(), {0.0, 0.0, 0.0});
+        return schedule;
     }
 
-    void marginalize(CopyableAtomic<double>& edge_cost, std::array<CopyableAtomic<double>,3>& cost, const int option, const double omega){
-        auto marginal = std::min({cost[option]+cost[(option+1)%3], cost[option]+cost[(option+2)%3], cost[0]+cost[1]+cost[2]}) 
-                      - std::min(0.0, cost[(option+1)%3]+cost[(option+2)%3]);
-        atomic_addition(edge_cost, omega*marginal);
-        cost[option] = cost[option] - omega*marginal;
+    template<typename FUNC>
+    tf::Task for_each_block(tf::Taskflow& taskflow, const std::vector<std::size_t>& blocks, FUNC f)
+    {
+        assert(blocks.size() > 0);
+        return taskflow.for_each_index(std::size_t(0), blocks.size()-1, std::size_t(1), [&blocks, f](const std::size_t b) {
+            for(std::size_t i=blocks[b]; i<blocks[b+1]; ++i)
+                f(i);
+        });
+    }
+
+    // position of edge e in triangle t, i.e. 0 for ij, 1 for jk and 2 for ik
+    std::size_t triangle_edge_slot(const triangle_item& t, const std::size_t e)
+    {
+        for(std::size_t s=0; s<3; ++s)
+            if(t.edge_indices[s] == e)
+                return s;
+        assert(false);
+        return 3;
     }
 
-    void send_triplets_to_edge(triangle_item& t, std::vector<edge_item>& edge_to_triangle){
+    double marginalize(std::array<double,3>& cost, const int option, const double omega){
+        const double marginal = std::min({cost[option]+cost[(option+1)%3], cost[option]+cost[(option+2)%3], cost[0]+cost[1]+cost[2]}) 
+                              - std::min(0.0, cost[(option+1)%3]+cost[(option+2)%3]);
+        cost[option] -= omega*marginal;
+        return omega*marginal;
+    }
+
+    void send_triplets_to_edge(triangle_item& t, std::array<double,3>& messages){
         // ij: 0 jk: 1 ik:2
-        marginalize(edge_to_triangle[t.edge_indices[0]].cost, t.weights, 0, 1.0/3.0);
-        marginalize(edge_to_triangle[t.edge_indices[2]].cost, t.weights, 2, 1.0/2.0);
-        marginalize(edge_to_triangle[t.edge_indices[1]].cost, t.weights, 1, 1.0/1.0);
-        marginalize(edge_to_triangle[t.edge_indices[0]].cost, t.weights, 0, 1.0/2.0);
-        marginalize(edge_to_triangle[t.edge_indices[2]].cost, t.weights, 2, 1.0/1.0);
-        marginalize(edge_to_triangle[t.edge_indices[0]].cost, t.weights, 0, 1.0/1.0);
-        auto marginal = std::min({t.weights[0]+t.weights[1], t.weights[0]+t.weights[2], t.weights[0]+t.weights[1]+t.weights[2]}) 
-                      - std::min(0.0, t.weights[1]+t.weights[2]);
+        std::array<double,3> weights = {t.weights[0].load(std::memory_order_relaxed), t.weights[1].load(std::memory_order_relaxed), t.weights[2].load(std::memory_order_relaxed)};
+        messages = {0.0, 0.0, 0.0};
+        messages[0] += marginalize(weights, 0, 1.0/3.0);
+        messages[2] += marginalize(weights, 2, 1.0/2.0);
+        messages[1] += marginalize(weights, 1, 1.0/1.0);
+        messages[0] += marginalize(weights, 0, 1.0/2.0);
+        messages[2] += marginalize(weights, 2, 1.0/1.0);
+        messages[0] += marginalize(weights, 0, 1.0/1.0);
+        auto marginal = std::min({weights[0]+weights[1], weights[0]+weights[2], weights[0]+weights[1]+weights[2]}) 
+                      - std::min(0.0, weights[1]+weights[2]);
         if (marginal > 1e-8) std::cout << "Incorrect marginal.\n";       
+        for(std::size_t s=0; s<3; ++s)
+            t.weights[s].store(weights[s], std::memory_order_relaxed);
     }
 
     double compute_lower_bound(std::vector<edge_t>& other_edges, std::vector<edge_item>& edge_to_triangle, 
@@ -72,28 +129,50 @@ namespace LPMP {
         return lb;
     }
 
-    void send_weights_to_triplets_parallel(tf::Taskflow& taskflow, std::vector<edge_item>& edge_to_triangle, std::vector<triangle_item>& triangle_to_edge, 
-        const int nr_threads){
-        auto send = taskflow.for_each_index(0, nr_threads, 1, [&](const std::size_t thread_no){
-            const std::size_t batch_size = edge_to_triangle.size()/nr_threads + 1;
-            int first_edge = thread_no*batch_size;
-            int last_edge = std::min((thread_no+1)*batch_size, edge_to_triangle.size());
-            for(auto i = first_edge; i != last_edge; ++i){
-                send_weights_to_triplets(edge_to_triangle[i], triangle_to_edge);
-            }
+    // edges distribute their cost evenly to their triangles. Triangles pull their share so that every block only writes to the triangles it owns.
+    tf::Task send_weights_to_triplets_parallel(tf::Taskflow& taskflow, std::vector<edge_item>& edge_to_triangle, std::vector<triangle_item>& triangle_to_edge, 
+        std::shared_ptr<message_passing_schedule> schedule){
+        auto compute_shares = for_each_block(taskflow, schedule->edge_blocks, [&edge_to_triangle, schedule](const std::size_t i) {
+            edge_item& e = edge_to_triangle[i];
+            assert(e.nodes[0] < e.nodes[1]);
+            assert(e.triangle_indices.size() > 0);
+            schedule->edge_shares[i] = e.cost.load(std::memory_order_relaxed) / e.triangle_indices.size();
+            e.cost.store(0.0, std::memory_order_relaxed);
         });
+        auto receive_shares = for_each_block(taskflow, schedule->triangle_blocks, [&triangle_to_edge, schedule](const std::size_t i) {
+            triangle_item& t = triangle_to_edge[i];
+            for(std::size_t s=0; s<3; ++s)
+                t.weights[s].store(t.weights[s].load(std::memory_order_relaxed) + schedule->edge_shares[t.edge_indices[s]], std::memory_order_relaxed);
+        });
+        compute_shares.precede(receive_shares);
+        return receive_shares;
     }
 
-    void send_triplets_to_edge_parallel(tf::Taskflow& taskflow, std::vector<edge_item>& edge_to_triangle, std::vector<triangle_item>& triangle_to_edge, 
+    tf::Task send_weights_to_triplets_parallel(tf::Taskflow& taskflow, std::vector<edge_item>& edge_to_triangle, std::vector<triangle_item>& triangle_to_edge, 
         const int nr_threads){
-         auto send = taskflow.for_each_index(0, nr_threads, 1, [&](const std::size_t thread_no){
-            const std::size_t batch_size = triangle_to_edge.size()/nr_threads + 1;
-            int first_triangle = thread_no*batch_size;
-            int last_triangle = std::min((thread_no+1)*batch_size, triangle_to_edge.size());
-            for(auto i = first_triangle; i != last_triangle; ++i){
-                send_triplets_to_edge(triangle_to_edge[i], edge_to_triangle);
-            }
+        return send_weights_to_triplets_parallel(taskflow, edge_to_triangle, triangle_to_edge, construct_message_passing_schedule(edge_to_triangle, triangle_to_edge, nr_threads));
+    }
+
+    // triangles compute their messages, afterwards edges collect the messages of their triangles.
+    tf::Task send_triplets_to_edge_parallel(tf::Taskflow& taskflow, std::vector<edge_item>& edge_to_triangle, std::vector<triangle_item>& triangle_to_edge, 
+        std::shared_ptr<message_passing_schedule> schedule){
+        auto compute_messages = for_each_block(taskflow, schedule->triangle_blocks, [&triangle_to_edge, schedule](const std::size_t i) {
+            send_triplets_to_edge(triangle_to_edge[i], schedule->triangle_messages[i]);
+        });
+        auto collect_messages = for_each_block(taskflow, schedule->edge_blocks, [&edge_to_triangle, &triangle_to_edge, schedule](const std::size_t i) {
+            edge_item& e = edge_to_triangle[i];
+            double cost = e.cost.load(std::memory_order_relaxed);
+            for(const auto& t : e.triangle_indices)
+                cost += schedule->triangle_messages[t[1]][triangle_edge_slot(triangle_to_edge[t[1]], i)];
+            e.cost.store(cost, std::memory_order_relaxed);
         });
+        compute_messages.precede(collect_messages);
+        return collect_messages;
+    }
+
+    tf::Task send_triplets_to_edge_parallel(tf::Taskflow& taskflow, std::vector<edge_item>& edge_to_triangle, std::vector<triangle_item>& triangle_to_edge, 
+        const int nr_threads){
+        return send_triplets_to_edge_parallel(taskflow, edge_to_triangle, triangle_to_edge, construct_message_passing_schedule(edge_to_triangle, triangle_to_edge, nr_threads));
     }
     
 
@@ -116,12 +195,13 @@ namespace LPMP {
         double lower_bound;
 
         std::cout << "#Edges in triangle: " << edge_to_triangle.size() << std::endl;
+        auto schedule = construct_message_passing_schedule(edge_to_triangle, triangle_to_edge, nr_threads);
 
         // Message Passing
         for (int i=0; i < ITERATION; ++i){
             taskflow.clear();
 
-            send_weights_to_triplets_parallel(taskflow, edge_to_triangle, triangle_to_edge, nr_threads);
+            send_weights_to_triplets_parallel(taskflow, edge_to_triangle, triangle_to_edge, schedule);
             executor.run(taskflow);
             executor.wait_for_all();
 
@@ -129,7 +209,7 @@ namespace LPMP {
             lower_bound = compute_lower_bound(other_edges, edge_to_triangle, triangle_to_edge);
             std::cout << "Lower bound after MP step 1: " << lower_bound << std::endl;
 
-            send_triplets_to_edge_parallel(taskflow, edge_to_triangle, triangle_to_edge, nr_threads);
+            send_triplets_to_edge_parallel(taskflow, edge_to_triangle, triangle_to_edge, schedule);
             executor.run(taskflow);
             executor.wait_for_all();
             lower_bound = compute_lower_bound(other_edges, edge_to_triangle, triangle_to_edge);
@@ -0,0 +1,233 @@
+#include "multicut/multicut_preprocessing.h"
+#include "union_find.hxx"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+
+namespace LPMP {
+
+    // edges of zero cost are irrelevant for the objective and can be dropped
+    static std::size_t remove_zero_edges(multicut_instance& instance)
+    {
+        auto& edges = instance.edges();
+        const std::size_t no_edges = edges.size();
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [](const auto& e) { return e.cost[0] == 0.0; }), edges.end());
+        return no_edges - edges.size();
+    }
+
+    multicut_reduction::multicut_reduction(const multicut_instance& original_instance)
+    {
+        multicut_instance instance = original_instance;
+        instance.normalize();
+        remove_zero_edges(instance);
+        const std::size_t no_original_edges = instance.no_edges();
+
+        std::size_t no_nodes = original_instance.no_nodes();
+        contracted_node_.resize(no_nodes);
+        std::iota(contracted_node_.begin(), contracted_node_.end(), 0);
+        while(reduce(instance, no_nodes)) {}
+
+        // only contracted nodes that still have edges are part of the reduced instance
+        reduced_node_.assign(no_nodes, no_node);
+        std::size_t no_reduced_nodes = 0;
+        for(const auto& e : instance.edges())
+            for(const std::size_t i : {e[0], e[1]})
+                if(reduced_node_[i] == no_node)
+                    reduced_node_[i] = no_reduced_nodes++;
+
+        for(const auto& e : instance.edges())
+            reduced_instance_.add_edge(reduced_node_[e[0]], reduced_node_[e[1]], e.cost);
+        reduced_instance_.add_to_constant(original_instance.constant() + decided_cost_);
+        no_decided_edges_ = no_original_edges - reduced_instance_.no_edges();
+
+        compute_components();
+    }
+
+    bool multicut_reduction::reduce(multicut_instance& instance, std::size_t& no_nodes)
+    {
+        const auto& edges = instance.edges();
+        bool changed = false;
+
+        std::vector<std::size_t> incident_offsets(no_nodes+1, 0);
+        for(const auto& e : edges) {
+            incident_offsets[e[0]+1]++;
+            incident_offsets[e[1]+1]++;
+        }
+        std::partial_sum(incident_offsets.begin(), incident_offsets.end(), incident_offsets.begin());
+        std::vector<std::size_t> incident_edges(incident_offsets.back());
+        {
+            std::vector<std::size_t> fill_pos(incident_offsets.begin(), incident_offsets.end()-1);
+            for(std::size_t e=0; e<edges.size(); ++e) {
+                incident_edges[fill_pos[edges[e][0]]++] = e;
+                incident_edges[fill_pos[edges[e][1]]++] = e;
+            }
+        }
+        std::vector<std::size_t> degree(no_nodes);
+        for(std::size_t i=0; i<no_nodes; ++i)
+            degree[i] = incident_offsets[i+1] - incident_offsets[i];
+
+        std::vector<char> removed(edges.size(), 0);
+        union_find uf(no_nodes);
+
+        // the edge of a leaf is a bridge: contract it if its cost is positive, cut it otherwise. The neighbour may become a leaf in turn.
+        std::vector<std::size_t> leaves;
+        for(std::size_t i=0; i<no_nodes; ++i)
+            if(degree[i] == 1)
+                leaves.push_back(i);
+        while(!leaves.empty()) {
+            const std::size_t i = leaves.back();
+            leaves.pop_back();
+            if(degree[i] != 1)
+                continue;
+            const auto e_it = std::find_if(incident_edges.begin() + incident_offsets[i], incident_edges.begin() + incident_offsets[i+1], [&](const std::size_t e) { return !removed[e]; });
+            assert(e_it != incident_edges.begin() + incident_offsets[i+1]);
+            const auto& e = edges[*e_it];
+            const std::size_t k = e[0] == i ? e[1] : e[0];
+            if(e.cost[0] > 0.0)
+                uf.merge(i,k);
+            else
+                decided_cost_ += e.cost[0];
+            removed[*e_it] = 1;
+            degree[i] = 0;
+            if(--degree[k] == 1)
+                leaves.push_back(k);
+            changed = true;
+        }
+
+        std::vector<double> abs_cost(no_nodes, 0.0);
+        std::vector<char> positive_edge(no_nodes, 0);
+        for(std::size_t e=0; e<edges.size(); ++e) {
+            if(removed[e])
+                continue;
+            for(const std::size_t i : {edges[e][0], edges[e][1]}) {
+                abs_cost[i] += std::abs(edges[e].cost[0]);
+                positive_edge[i] |= edges[e].cost[0] > 0.0;
+            }
+        }
+
+        // moving one endpoint of a dominating edge into the cluster of the other one does not increase the cost.
+        // Dominating edges that share no endpoint can be contracted simultaneously, since such moves do not affect each other's edge.
+        std::vector<char> matched(no_nodes, 0);
+        for(std::size_t e=0; e<edges.size(); ++e) {
+            const std::size_t i = edges[e][0];
+            const std::size_t j = edges[e][1];
+            const double c = edges[e].cost[0];
+            if(removed[e] || c <= 0.0 || matched[i] || matched[j])
+                continue;
+            if(c >= abs_cost[i] - c || c >= abs_cost[j] - c) {
+                uf.merge(i,j);
+                matched[i] = 1;
+                matched[j] = 1;
+                removed[e] = 1;
+                changed = true;
+            }
+        }
+
+        // separating a node without positive edges from its cluster does not increase the cost
+        for(std::size_t e=0; e<edges.size(); ++e) {
+            if(removed[e])
+                continue;
+            if(!positive_edge[edges[e][0]] || !positive_edge[edges[e][1]]) {
+                decided_cost_ += edges[e].cost[0];
+                removed[e] = 1;
+                changed = true;
+            }
+        }
+
+        if(!changed)
+            return false;
+
+        std::vector<std::size_t> contracted_id(no_nodes, no_node);
+        std::size_t no_contracted_nodes = 0;
+        for(std::size_t i=0; i<no_nodes; ++i) {
+            const std::size_t r = uf.find(i);
+            if(contracted_id[r] == no_node)
+                contracted_id[r] = no_contracted_nodes++;
+        }
+
+        multicut_instance contracted_instance;
+        for(std::size_t e=0; e<edges.size(); ++e) {
+            if(removed[e])
+                continue;
+            const std::size_t i = contracted_id[uf.find(edges[e][0])];
+            const std::size_t j = contracted_id[uf.find(edges[e][1])];
+            assert(i != j);
+            contracted_instance.add_edge(i, j, edges[e].cost);
+        }
+        contracted_instance.normalize();
+        remove_zero_edges(contracted_instance);
+
+        for(auto& i : contracted_node_)
+            i = contracted_id[uf.find(i)];
+        no_nodes = no_contracted_nodes;
+        instance = std::move(contracted_instance);
+        return true;
+    }
+
+    void multicut_reduction::compute_components()
+    {
+        const std::size_t no_reduced_nodes = reduced_instance_.no_nodes();
+        union_find uf(no_reduced_nodes);
+        for(const auto& e : reduced_instance_.edges())
+            uf.merge(e[0], e[1]);
+
+        component_.assign(no_reduced_nodes, no_node);
+        component_node_.resize(no_reduced_nodes);
+        std::vector<std::size_t> component_of_root(no_reduced_nodes, no_node);
+        std::vector<std::size_t> component_size;
+        for(std::size_t i=0; i<no_reduced_nodes; ++i) {
+            const std::size_t r = uf.find(i);
+            if(component_of_root[r] == no_node) {
+                component_of_root[r] = component_size.size();
+                component_size.push_back(0);
+            }
+            component_[i] = component_of_root[r];
+            component_node_[i] = component_size[component_[i]]++;
+        }
+
+        components_.resize(component_size.size());
+        for(const auto& e : reduced_instance_.edges()) {
+            const std::size_t c = component_[e[0]];
+            assert(c == component_[e[1]]);
+            components_[c].add_edge(component_node_[e[0]], component_node_[e[1]], e.cost);
+        }
+    }
+
+    multicut_node_labeling multicut_reduction::lift(const multicut_node_labeling& reduced_labeling) const
+    {
+        assert(reduced_labeling.size() == reduced_instance_.no_nodes());
+        // contracted nodes without edges form clusters of their own, labeled after all clusters of the reduced instance
+        const std::size_t label_offset = reduced_labeling.size() > 0 ? *std::max_element(reduced_labeling.begin(), reduced_labeling.end()) + 1 : 0;
+        multicut_node_labeling output(contracted_node_.size());
+        for(std::size_t i=0; i<contracted_node_.size(); ++i) {
+            const std::size_t c = contracted_node_[i];
+            const std::size_t r = reduced_node_[c];
+            output[i] = r != no_node ? reduced_labeling[r] : label_offset + c;
+        }
+        return output;
+    }
+
+    multicut_edge_labeling multicut_reduction::lift(const multicut_instance& original_instance, const multicut_edge_labeling& reduced_labeling) const
+    {
+        assert(original_instance.no_nodes() == contracted_node_.size());
+        const multicut_node_labeling node_labeling = lift(reduced_labeling.transform_to_node_labeling(reduced_instance_));
+        return node_labeling.transform_to_edge_labeling(original_instance);
+    }
+
+    multicut_node_labeling multicut_reduction::lift(const std::vector<multicut_node_labeling>& component_labelings) const
+    {
+        assert(component_labelings.size() == no_components());
+        std::vector<std::size_t> label_offset(no_components()+1, 0);
+        for(std::size_t c=0; c<no_components(); ++c) {
+            assert(component_labelings[c].size() == components_[c].no_nodes());
+            label_offset[c+1] = label_offset[c] + *std::max_element(component_labelings[c].begin(), component_labelings[c].end()) + 1;
+        }
+
+        multicut_node_labeling reduced_labeling(reduced_instance_.no_nodes());
+        for(std::size_t i=0; i<reduced_labeling.size(); ++i)
+            reduced_labeling[i] = label_offset[component_[i]] + component_labelings[component_[i]][component_node_[i]];
+        return lift(reduced_labeling);
+    }
+
+} // namespace LPMP
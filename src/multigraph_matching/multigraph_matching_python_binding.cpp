@@ -15,9 +15,10 @@
 namespace py = pybind11;
 
 // there are two versions of the python binding: One with varying edges and with constant edge set per graph
+// costs and edges are passed as numpy arrays or nested lists, contiguous float32/float64 costs and int32/int64 edges are read without conversion
 
 // varying edges
-void construct_from_arrays(LPMP::multigraph_matching_input& instance, const std::vector<py::array_t<double>> assignments, const std::vector<py::array_t<double>> quadratic_terms, const std::vector<py::array_t<int>> left_edges, const std::vector<py::array_t<int>> right_edges)
+void construct_from_arrays(LPMP::multigraph_matching_input& instance, const std::vector<py::object> assignments, const std::vector<py::object> quadratic_terms, const std::vector<py::object> left_edges, const std::vector<py::object> right_edges)
 {
     const std::size_t nr_problems = assignments.size();
 
@@ -43,7 +44,7 @@ void construct_from_arrays(LPMP::multigraph_matching_input& instance, const std:
     }
 }
 
-std::vector<py::array_t<char>> get_assignment_masks(LPMP::multigraph_matching_input::labeling labeling, const std::vector<py::array_t<double>> assignments)
+std::vector<py::array_t<char>> get_assignment_masks(LPMP::multigraph_matching_input::labeling labeling, const std::vector<py::object> assignments)
 {
     const std::size_t nr_problems = assignments.size();
     if(labeling.size() != assignments.size())
@@ -56,7 +57,7 @@ std::vector<py::array_t<char>> get_assignment_masks(LPMP::multigraph_matching_in
     return masks; 
 }
 
-std::vector<py::array_t<char>> get_quadratic_terms_masks(LPMP::multigraph_matching_input::labeling labeling, const std::vector<py::array_t<double>> quadratic_terms, const std::vector<py::array_t<int>> left_edges, const std::vector<py::array_t<int>> right_edges)
+std::vector<py::array_t<char>> get_quadratic_terms_masks(LPMP::multigraph_matching_input::labeling labeling, const std::vector<py::object> quadratic_terms, const std::vector<py::object> left_edges, const std::vector<py::object> right_edges)
 {
     const std::size_t nr_problems = quadratic_terms.size();
     if(left_edges.size() != nr_problems)
@@ -72,7 +73,7 @@ std::vector<py::array_t<char>> get_quadratic_terms_masks(LPMP::multigraph_matchi
 }
 
 // constant edge set
-void construct_from_arrays(LPMP::multigraph_matching_input& instance, const std::vector<py::array_t<double>> assignments, const std::vector<py::array_t<double>> quadratic_terms, const std::vector<py::array_t<int>> edges)
+void construct_from_arrays(LPMP::multigraph_matching_input& instance, const std::vector<py::object> assignments, const std::vector<py::object> quadratic_terms, const std::vector<py::object> edges)
 {
     const std::size_t nr_problems = assignments.size();
 
@@ -97,7 +98,7 @@ void construct_from_arrays(LPMP::multigraph_matching_input& instance, const std:
     }
 }
 
-std::vector<py::array_t<char>> get_quadratic_terms_mask(LPMP::multigraph_matching_input::labeling labeling, const std::vector<py::array_t<double>> quadratic_terms, const std::vector<py::array_t<int>> edges)
+std::vector<py::array_t<char>> get_quadratic_terms_mask(LPMP::multigraph_matching_input::labeling labeling, const std::vector<py::object> quadratic_terms, const std::vector<py::object> edges)
 {
     const std::size_t nr_problems = quadratic_terms.size();
     if(labeling.size() != quadratic_terms.size())
@@ -130,12 +131,12 @@ PYBIND11_MODULE(multigraph_matching_py, m) {
 
     py::class_<LPMP::multigraph_matching_input::labeling>(m, "multigraph_matching_labeling")
         .def(py::init<>())
-        .def("result_masks", [](const LPMP::multigraph_matching_input::labeling& l, const std::vector<py::array_t<double>> assignments, const std::vector<py::array_t<double>> quadratic_terms, const std::vector<py::array_t<int>> left_edges, const std::vector<py::array_t<int>> right_edges) {
+        .def("result_masks", [](const LPMP::multigraph_matching_input::labeling& l, const std::vector<py::object> assignments, const std::vector<py::object> quadratic_terms, const std::vector<py::object> left_edges, const std::vector<py::object> right_edges) {
                 auto assignment_masks = get_assignment_masks(l, assignments);
                 auto quadratic_masks = get_quadratic_terms_masks(l, quadratic_terms, left_edges, right_edges);
                 return std::make_pair(assignment_masks, quadratic_masks);
                 })
-        .def("result_masks", [](const LPMP::multigraph_matching_input::labeling& l, const std::vector<py::array_t<double>> assignments, const std::vector<py::array_t<double>> quadratic_terms, const std::vector<py::array_t<int>> edges) {
+        .def("result_masks", [](const LPMP::multigraph_matching_input::labeling& l, const std::vector<py::object> assignments, const std::vector<py::object> quadratic_terms, const std::vector<py::object> edges) {
                 auto assignment_masks = get_assignment_masks(l, assignments);
                 auto quadratic_masks = get_quadratic_terms_mask(l, quadratic_terms, edges);
                 return std::make_pair(assignment_masks, quadratic_masks);
@@ -145,12 +146,12 @@ PYBIND11_MODULE(multigraph_matching_py, m) {
 
     py::class_<LPMP::multigraph_matching_input>(m, "multigraph_matching_input")
         .def(py::init<>())
-        .def(py::init([](const std::vector<py::array_t<double>> assignments, const std::vector<py::array_t<double>> quadratic_terms, const std::vector<py::array_t<int>> left_edges, const std::vector<py::array_t<int>> right_edges) {
+        .def(py::init([](const std::vector<py::object> assignments, const std::vector<py::object> quadratic_terms, const std::vector<py::object> left_edges, const std::vector<py::object> right_edges) {
                 LPMP::multigraph_matching_input instance;
                 construct_from_arrays(instance, assignments, quadratic_terms, left_edges, right_edges); 
                 return instance;
                 }))
-        .def(py::init([](const std::vector<py::array_t<double>> assignments, const std::vector<py::array_t<double>> quadratic_terms, const std::vector<py::array_t<int>> edges) {
+        .def(py::init([](const std::vector<py::object> assignments, const std::vector<py::object> quadratic_terms, const std::vector<py::object> edges) {
                 LPMP::multigraph_matching_input instance;
                 construct_from_arrays(instance, assignments, quadratic_terms, edges); 
                 return instance;
@@ -2,6 +2,8 @@
 #include <string>
 #include "test.h"
 #include <iostream>
+#include <fstream>
+#include <cstdio>
 
 using namespace LPMP;
 
@@ -12,6 +14,58 @@ Subject To
 x1 + 2*x2 + 3 * x3 - 5*x4 - x5 >= 1
 End)";
 
+const std::string ILP_example_multiple_constraints =
+R"(Minimize
+x1 + 2*x2 + 1.5 * x3 - 0.5*x4 - x5
+Subject To
+x1 + 2*x2 + 3 * x3 - 5*x4 - x5 >= 1
+c2: y1 - x1
+  + 3 y2 <= -2
+x5 + y2 = 1
+Bounds
+Binaries
+x1
+x2
+End
+)";
+
+// constraints spanning several lines, some with identifiers
+std::string multi_line_ILP(const std::size_t nr_constraints)
+{
+    std::string s = "Minimize\n";
+    for(std::size_t i=0; i<20; ++i)
+        s += (i % 2 == 0 ? "+ " : "- ") + std::to_string(i) + " x" + std::to_string(i) + "\n";
+    s += "Subject To\n";
+    for(std::size_t c=0; c<nr_constraints; ++c) {
+        if(c % 3 == 0)
+            s += "c" + std::to_string(c) + ": ";
+        s += "x" + std::to_string(c % 20) + " + 2 x" + std::to_string((c+7) % 20) + "\n";
+        s += "  - 3*y" + std::to_string(c % 50) + "\n";
+        s += std::string(c % 2 == 0 ? "  <= " : "  >= ") + std::to_string(int(c % 5) - 2) + "\n";
+    }
+    s += "End\n";
+    return s;
+}
+
+bool equal(const ILP_input& a, const ILP_input& b)
+{
+    if(a.nr_variables() != b.nr_variables() || a.nr_constraints() != b.nr_constraints() || a.objective() != b.objective())
+        return false;
+    for(std::size_t i=0; i<a.nr_variables(); ++i)
+        if(a.get_var_name(i) != b.get_var_name(i))
+            return false;
+    for(std::size_t c=0; c<a.nr_constraints(); ++c) {
+        const auto& ca = a.constraints()[c];
+        const auto& cb = b.constraints()[c];
+        if(ca.ineq != cb.ineq || ca.right_hand_side != cb.right_hand_side || ca.variables.size() != cb.variables.size())
+            return false;
+        for(std::size_t j=0; j<ca.variables.size(); ++j)
+            if(ca.variables[j].var != cb.variables[j].var || ca.variables[j].coefficient != cb.variables[j].coefficient)
+                return false;
+    }
+    return true;
+}
+
 int main(int argc, char** argv)
 {
     const ILP_input input = ILP_parser::parse_string(ILP_example);
@@ -30,4 +84,33 @@ int main(int argc, char** argv)
 
     input.write(std::cout);
     test(input.nr_constraints() == 1);
+
+    // memory-mapped reader and binary cache must give the same input as the grammar based parser
+    const std::string filename = "test_ILP_parser.lp";
+    const std::string binary_filename = "test_ILP_parser.bin";
+    std::ofstream(filename) << ILP_example_multiple_constraints;
+    const ILP_input reference = ILP_parser::parse_string(ILP_example_multiple_constraints);
+    test(reference.nr_variables() == 7);
+    test(reference.nr_constraints() == 3);
+    test(equal(reference, ILP_parser::parse_file(filename)));
+    for(const std::size_t nr_threads : {1, 2, 4})
+        for(const std::size_t min_chunk_size : {1, 16, 1 << 16})
+            test(equal(reference, ILP_parser::parse_file_mmap(filename, nr_threads, min_chunk_size)));
+
+    // many chunks, split between lines of multi-line constraints
+    const std::string multi_line_filename = "test_ILP_parser_multi_line.lp";
+    const std::string multi_line_text = multi_line_ILP(500);
+    std::ofstream(multi_line_filename) << multi_line_text;
+    const ILP_input multi_line_reference = ILP_parser::parse_string(multi_line_text);
+    test(multi_line_reference.nr_constraints() == 500);
+    for(const std::size_t nr_threads : {1, 3, 8})
+        for(const std::size_t min_chunk_size : {1, 100, 1 << 16})
+            test(equal(multi_line_reference, ILP_parser::parse_file_mmap(multi_line_filename, nr_threads, min_chunk_size)));
+    std::remove(multi_line_filename.c_str());
+
+    ILP_parser::write_binary(reference, binary_filename);
+    test(equal(reference, ILP_parser::read_binary(binary_filename)));
+    test(equal(reference, ILP_parser::parse_file(binary_filename)));
+    std::remove(filename.c_str());
+    std::remove(binary_filename.c_str());
 }
@@ -0,0 +1,44 @@
+#include "bdd/bdd_min_marginal_averaging.h"
+#include "tclap/CmdLine.h"
+#include "test.h"
+#include "test_chain_ILP.hxx"
+#include <fstream>
+#include <cstdio>
+
+using namespace LPMP;
+
+// exposes batched and per bdd min-marginal computation
+class bdd_min_marginal_averaging_test : public bdd_min_marginal_averaging {
+    public:
+        bdd_min_marginal_averaging_test(TCLAP::CmdLine& cmd) : bdd_min_marginal_averaging(cmd) {}
+        using bdd_min_marginal_averaging::compute_min_marginals;
+        using bdd_min_marginal_averaging::min_marginal;
+};
+
+int main()
+{
+    const std::string filename = "test_bdd_batched_min_marginals.lp";
+    std::ofstream(filename) << chain_ILP(60);
+
+    TCLAP::CmdLine cmd("batched min-marginals");
+    bdd_min_marginal_averaging_test solver(cmd);
+    std::vector<std::string> args = {"test", "-i", filename};
+    cmd.parse(args);
+    solver.init();
+
+    // compare in a forward sweep, where min-marginals of each variable are valid after its forward steps
+    std::vector<std::array<double,2>> min_marginals;
+    for(std::size_t iter=0; iter<5; ++iter) {
+        for(std::size_t var=0; var<solver.nr_variables(); ++var) {
+            solver.forward_step(var);
+            solver.compute_min_marginals(var, min_marginals);
+            test(min_marginals.size() == solver.nr_bdds(var));
+            for(std::size_t bdd_index=0; bdd_index<solver.nr_bdds(var); ++bdd_index)
+                test(min_marginals[bdd_index] == solver.min_marginal(var, bdd_index), "batched min-marginals must equal per bdd ones");
+        }
+        solver.backward_run();
+        solver.iteration();
+    }
+
+    std::remove(filename.c_str());
+}
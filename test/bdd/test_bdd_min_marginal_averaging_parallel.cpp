@@ -0,0 +1,61 @@
+#include "bdd/bdd_min_marginal_averaging.h"
+#include "bdd/bdd_min_marginal_averaging_parallel.h"
+#include "tclap/CmdLine.h"
+#include "test.h"
+#include "test_chain_ILP.hxx"
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+
+using namespace LPMP;
+
+int main()
+{
+    const std::string filename = "test_bdd_min_marginal_averaging_parallel.lp";
+    std::ofstream(filename) << chain_ILP(60);
+
+    const std::size_t nr_iterations = 100;
+
+    TCLAP::CmdLine cmd_seq("sequential min-marginal averaging");
+    bdd_min_marginal_averaging seq(cmd_seq);
+    std::vector<std::string> args_seq = {"test", "-i", filename};
+    cmd_seq.parse(args_seq);
+    seq.init();
+    const double initial_lb = seq.compute_lower_bound();
+    std::vector<double> seq_lbs;
+    for(std::size_t iter=0; iter<nr_iterations; ++iter) {
+        seq.iteration();
+        seq_lbs.push_back(seq.lower_bound());
+    }
+
+    // with one interval no messages are delayed, hence the parallel solver follows the sequential one
+    {
+        TCLAP::CmdLine cmd("parallel min-marginal averaging, one interval");
+        bdd_min_marginal_averaging_parallel par(cmd);
+        std::vector<std::string> args = {"test", "-i", filename, "--threads", "1", "--intervals", "1"};
+        cmd.parse(args);
+        par.init();
+        test(par.nr_intervals() == 1);
+        test(std::abs(par.lower_bound() - initial_lb) <= 1e-8);
+        for(std::size_t iter=0; iter<nr_iterations; ++iter) {
+            par.iteration();
+            test(std::abs(par.lower_bound() - seq_lbs[iter]) <= 1e-8, "parallel solver with one interval must give the sequential lower bound");
+        }
+    }
+
+    // messages across intervals are delayed by one iteration, hence only the converged lower bounds agree approximately
+    for(const std::string nr_intervals : {"2", "4"}) {
+        TCLAP::CmdLine cmd("parallel min-marginal averaging, several intervals");
+        bdd_min_marginal_averaging_parallel par(cmd);
+        std::vector<std::string> args = {"test", "-i", filename, "--threads", nr_intervals, "--intervals", nr_intervals};
+        cmd.parse(args);
+        par.init();
+        test(par.nr_intervals() == std::stoul(nr_intervals));
+        test(std::abs(par.lower_bound() - initial_lb) <= 1e-8, "initial lower bound is computed exactly");
+        for(std::size_t iter=0; iter<nr_iterations; ++iter)
+            par.iteration();
+        test(std::abs(par.lower_bound() - seq_lbs.back()) <= 1e-2*std::max(1.0, std::abs(seq_lbs.back())));
+    }
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,70 @@
+#include "bdd/bdd_min_marginal_averaging.h"
+#include "bdd/bdd_branch_node_vector.h"
+#include "tclap/CmdLine.h"
+#include "test.h"
+#include "test_chain_ILP.hxx"
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+
+using namespace LPMP;
+
+int main()
+{
+    const std::string filename = "test_bdd_mma_vec.lp";
+    const std::string unconstrained_filename = "test_bdd_mma_vec_unconstrained.lp";
+    std::ofstream(filename) << chain_ILP(60);
+    std::ofstream(unconstrained_filename) << chain_ILP(60, -1.0);
+
+    TCLAP::CmdLine cmd_ref("min-marginal averaging");
+    bdd_min_marginal_averaging ref(cmd_ref);
+    std::vector<std::string> args_ref = {"test", "-i", filename};
+    cmd_ref.parse(args_ref);
+    ref.init();
+
+    TCLAP::CmdLine cmd_vec("min-marginal averaging on compact layout");
+    bdd_mma_vec vec(cmd_vec);
+    std::vector<std::string> args_vec = {"test", "-i", filename};
+    cmd_vec.parse(args_vec);
+    vec.init();
+
+    // variable z is in no bdd and is set to one in the lower bound
+    TCLAP::CmdLine cmd_unconstrained("min-marginal averaging on compact layout, unconstrained variable");
+    bdd_mma_vec vec_unconstrained(cmd_unconstrained);
+    std::vector<std::string> args_unconstrained = {"test", "-i", unconstrained_filename};
+    cmd_unconstrained.parse(args_unconstrained);
+    vec_unconstrained.init();
+    test(vec_unconstrained.nr_variables() == vec.nr_variables() + 1);
+    test(vec_unconstrained.nr_bdds(1) == 0);
+
+    test(vec.nr_bdds() == ref.nr_bdds());
+    test(std::abs(vec.compute_lower_bound() - ref.compute_lower_bound()) <= 1e-8);
+    test(std::abs(vec_unconstrained.compute_lower_bound() - (ref.compute_lower_bound() - 1.0)) <= 1e-8);
+    for(std::size_t iter=0; iter<50; ++iter) {
+        ref.iteration();
+        vec.iteration();
+        vec_unconstrained.iteration();
+        test(std::abs(vec.lower_bound() - ref.lower_bound()) <= 1e-8, "compact layout must give the same lower bound as bdd_min_marginal_averaging");
+        test(std::abs(vec_unconstrained.lower_bound() - (ref.lower_bound() - 1.0)) <= 1e-8);
+    }
+
+    std::vector<char> zero(vec.nr_variables(), 0);
+    test(vec.evaluate(zero.begin(), zero.end()) == ref.evaluate(zero.begin(), zero.end()));
+
+    // SRMP averaging is not implemented on the compact layout and must be rejected before any work is done
+    TCLAP::CmdLine cmd_srmp("min-marginal averaging on compact layout, SRMP");
+    bdd_mma_vec vec_srmp(cmd_srmp);
+    std::vector<std::string> args_srmp = {"test", "-i", filename, "-a", "SRMP"};
+    cmd_srmp.parse(args_srmp);
+    bool srmp_rejected = false;
+    try {
+        vec_srmp.init();
+    } catch(const std::runtime_error&) {
+        srmp_rejected = true;
+    }
+    test(srmp_rejected, "compact layout must reject SRMP averaging in init");
+    test(vec_srmp.nr_bdds() == 0);
+
+    std::remove(filename.c_str());
+    std::remove(unconstrained_filename.c_str());
+}
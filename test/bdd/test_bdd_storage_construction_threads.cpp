@@ -0,0 +1,52 @@
+#include "bdd/bdd_storage.h"
+#include "bdd/ILP_parser.h"
+#include "tclap/CmdLine.h"
+#include "test.h"
+#include "test_chain_ILP.hxx"
+
+using namespace LPMP;
+
+std::tuple<std::vector<bdd_storage::bdd_node>, std::vector<std::size_t>> construct_bdds(const ILP_input& input, const std::size_t nr_threads, const std::vector<std::string>& extra_args = {})
+{
+    TCLAP::CmdLine cmd("bdd construction");
+    bdd_storage storage(cmd);
+    std::vector<std::string> args = {"test", "--bdd_construction_threads", std::to_string(nr_threads)};
+    args.insert(args.end(), extra_args.begin(), extra_args.end());
+    cmd.parse(args);
+    storage.init(input);
+    return {storage.bdd_nodes(), storage.bdd_delimiters()};
+}
+
+int main()
+{
+    const ILP_input input = ILP_parser::parse_string(chain_ILP(60));
+    test(input.nr_constraints() > 8);
+
+    const auto [nodes, delimiters] = construct_bdds(input, 1);
+    test(delimiters.size() == input.nr_constraints() + 1);
+
+    for(const std::size_t nr_threads : {2, 3, 8}) {
+        const auto [nodes_parallel, delimiters_parallel] = construct_bdds(input, nr_threads);
+        test(delimiters_parallel == delimiters, "bdds must not depend on the number of construction threads");
+        test(nodes_parallel.size() == nodes.size());
+        for(std::size_t i=0; i<nodes.size(); ++i) {
+            test(nodes_parallel[i].low == nodes[i].low);
+            test(nodes_parallel[i].high == nodes[i].high);
+            test(nodes_parallel[i].variable == nodes[i].variable);
+        }
+    }
+
+    // with preprocessing, bdds of several per-thread managers are passed to one preprocessor.
+    // The two constraints of every window have the same variables, hence subsumption merges them.
+    const std::vector<std::string> subsumption = {"--bdd_preprocessing", "subsumption"};
+    const auto [nodes_subsumption, delimiters_subsumption] = construct_bdds(input, 1, subsumption);
+    test(delimiters_subsumption.size() > 1 && delimiters_subsumption.size() < delimiters.size());
+    const auto [nodes_subsumption_parallel, delimiters_subsumption_parallel] = construct_bdds(input, 4, subsumption);
+    test(delimiters_subsumption_parallel == delimiters_subsumption, "preprocessed bdds must not depend on the number of construction threads");
+    test(nodes_subsumption_parallel.size() == nodes_subsumption.size());
+    for(std::size_t i=0; i<nodes_subsumption.size(); ++i) {
+        test(nodes_subsumption_parallel[i].low == nodes_subsumption[i].low);
+        test(nodes_subsumption_parallel[i].high == nodes_subsumption[i].high);
+        test(nodes_subsumption_parallel[i].variable == nodes_subsumption[i].variable);
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <sstream>
+#include <random>
+#include <cmath>
+
+namespace LPMP {
+
+// chain of overlapping windows x_i + x_{i+1} + x_{i+2} in {1,2} with random costs.
+// If unconstrained_cost is given, variable z with this cost occurs in the objective after x0, but in no constraint.
+inline std::string chain_ILP(const std::size_t nr_variables, const double unconstrained_cost = 0.0)
+{
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> dist(-5,5);
+    std::stringstream s;
+    s << "Minimize\n";
+    for(std::size_t i=0; i<nr_variables; ++i) {
+        const double cost = dist(gen) + 0.1*i;
+        s << (cost < 0.0 ? " - " : " + ") << std::abs(cost) << " x" << i;
+        if(i == 0 && unconstrained_cost != 0.0)
+            s << (unconstrained_cost < 0.0 ? " - " : " + ") << std::abs(unconstrained_cost) << " z";
+    }
+    s << "\nSubject To\n";
+    for(std::size_t i=0; i+2<nr_variables; ++i) {
+        s << "x" << i << " + x" << i+1 << " + x" << i+2 << " >= 1\n";
+        s << "x" << i << " + x" << i+1 << " + x" << i+2 << " <= 2\n";
+    }
+    s << "End\n";
+    return s.str();
+}
+
+}
@@ -0,0 +1,47 @@
+#include "test.h"
+#include "compensated_sum.hxx"
+#include "config.hxx"
+#include <vector>
+#include <random>
+#include <iostream>
+
+using namespace LPMP;
+
+int main()
+{
+   // summands of very different magnitude, stored with REAL precision, as lower bounds of factors are
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<> dist(-1.0, 1.0);
+   std::vector<REAL> summands;
+   summands.push_back(1e8);
+   for(std::size_t i=0; i<1000000; ++i) {
+      summands.push_back(REAL(dist(gen) * 1e-3));
+   }
+   summands.push_back(-1e8);
+
+   long double exact = 0.0;
+   double naive = 0.0;
+   compensated_sum<double> compensated;
+   for(const REAL x : summands) {
+      exact += x;
+      naive += x;
+      compensated += x;
+   }
+
+   const double naive_error = std::abs(naive - double(exact));
+   const double compensated_error = std::abs(compensated.value() - double(exact));
+   std::cout << "naive summation error = " << naive_error << ", compensated summation error = " << compensated_error << "\n";
+   test(compensated_error <= naive_error, "compensated summation must not be less accurate than naive one");
+   test(compensated_error <= 1e-8);
+
+   // infinite summands must not turn the sum into nan
+   compensated_sum<double> infinite_sum(1.0);
+   infinite_sum += std::numeric_limits<double>::infinity();
+   infinite_sum += 1.0;
+   test(infinite_sum.value() == std::numeric_limits<double>::infinity());
+
+   compensated_sum<double> s1(1e16), s2(1.0);
+   s1 += s2;
+   s1 += 1.0;
+   test(s1.value() == 1e16 + 2.0);
+}
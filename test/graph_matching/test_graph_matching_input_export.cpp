@@ -30,6 +30,33 @@ void test_instance_export(const std::size_t no_nodes, const double density, std:
     test(std::abs(instance.evaluate(l) - solved_instance.evaluate(l)) <= 1e-8); 
 }
 
+// after a cost update the reparametrized problem must be equivalent to the new instance, also when optimization continues from it
+void test_warm_start(const std::size_t no_nodes, const double density, std::random_device& rd, int argc, char** argv)
+{
+    const graph_matching_input instance = generate_random_graph_matching_problem(no_nodes, density, rd);
+    ProblemConstructorRoundingSolver<Solver<LP<FMC_MP>,StandardVisitor>>solver(argc,argv);
+    solver.GetProblemConstructor().construct(instance);
+    solver.Solve();
+    const graph_matching_input::labeling l = solver.GetProblemConstructor().write_out_labeling();
+
+    std::mt19937 gen{rd()};
+    std::normal_distribution nd(0.0, 1.0);
+    graph_matching_input perturbed_instance = instance;
+    for(auto& a : perturbed_instance.assignments) { a.cost += nd(gen); }
+    for(auto& q : perturbed_instance.quadratic_terms) { q.cost += nd(gen); }
+
+    solver.GetProblemConstructor().update_costs(perturbed_instance);
+    const graph_matching_input updated_instance = solver.GetProblemConstructor().export_graph_matching_input();
+    test(std::abs(perturbed_instance.evaluate(l) - updated_instance.evaluate(l)) <= 1e-8);
+
+    solver.Solve();
+    const graph_matching_input::labeling l_sol = solver.GetProblemConstructor().write_out_labeling();
+    const graph_matching_input solved_instance = solver.GetProblemConstructor().export_graph_matching_input();
+    test(std::abs(perturbed_instance.evaluate(l_sol) - solved_instance.evaluate(l_sol)) <= 1e-8);
+    test(std::abs(perturbed_instance.evaluate(l) - solved_instance.evaluate(l)) <= 1e-8);
+    test(solver.lower_bound() <= perturbed_instance.evaluate(l_sol) + 1e-8);
+}
+
 int main(int argc, char** argv)
 {
     std::random_device rd{};
@@ -42,4 +69,7 @@ int main(int argc, char** argv)
 
     for(std::size_t i=10; i<20; ++i)
         test_instance_export(i,2.0, rd, argc, argv);
+
+    for(std::size_t i=10; i<15; ++i)
+        test_warm_start(i,0.5, rd, argc, argv);
 }
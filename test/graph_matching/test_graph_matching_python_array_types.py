@@ -0,0 +1,75 @@
+import graph_matching_py as gm
+import numpy as np
+
+# costs and edges of different dtypes, memory layouts and list inputs must give the same instance as element-wise construction
+
+
+def build_graph(edges_left, edges_right, costs_unary, costs_binary):
+    instance = gm.graph_matching_input()
+    n2 = costs_unary.shape[1]
+    for i in range(costs_unary.shape[0]):
+        for j in range(n2):
+            instance.add_assignment(i, j, float(costs_unary[i, j]))
+    for lei, le in enumerate(edges_left):
+        for rei, re in enumerate(edges_right):
+            instance.add_quadratic_term(int(le[0]) * n2 + int(re[0]), int(le[1]) * n2 + int(re[1]), float(costs_binary[lei, rei]))
+    return instance
+
+
+edges_left = np.array([[0, 1], [1, 2], [0, 2]], dtype=np.int64)
+edges_right = np.array([[0, 1], [1, 2], [2, 3], [0, 3]], dtype=np.int64)
+# values exactly representable in float32
+assignments = np.array([[-5.0, -13.0, -17.0, 2.0],
+                        [-9.0, -13.0, -15.0, 1.5],
+                        [4.0, -0.5, -3.25, -8.0]], dtype=np.float64)
+quadratic_terms = np.array([[-31.0, -17.0, 2.0, -4.5],
+                            [-1.0, -7.25, 3.0, 0.0],
+                            [5.0, -2.0, -11.0, -6.5]], dtype=np.float64)
+
+reference = build_graph(edges_left, edges_right, assignments, quadratic_terms)
+labelings = [gm.graph_matching_labeling(l) for l in ([0, 1, 2], [3, 2, 1], [1, 0, 3])]
+
+
+def check(name, a, q, l, r):
+    instance = gm.graph_matching_input(a, q, l, r)
+    for labeling in labelings:
+        cost = instance.evaluate(labeling)
+        if cost != reference.evaluate(labeling):
+            raise AssertionError(name + ": wrong instance cost " + str(cost) + " != " + str(reference.evaluate(labeling)))
+        [assignment_mask, quadratic_mask] = labeling.result_masks(a, q, l, r)
+        mask_cost = np.sum(assignment_mask * assignments) + np.sum(quadratic_mask * quadratic_terms)
+        if mask_cost != cost:
+            raise AssertionError(name + ": masks do not match labeling")
+
+
+for cost_dtype in (np.float32, np.float64):
+    for edge_dtype in (np.int32, np.int64):
+        check("dtypes " + np.dtype(cost_dtype).name + "/" + np.dtype(edge_dtype).name,
+              assignments.astype(cost_dtype), quadratic_terms.astype(cost_dtype),
+              edges_left.astype(edge_dtype), edges_right.astype(edge_dtype))
+
+# non-contiguous views: transposed copies transposed back, and every second row/column of larger arrays
+check("transposed",
+      np.ascontiguousarray(assignments.T).T, np.ascontiguousarray(quadratic_terms.T).T,
+      np.ascontiguousarray(edges_left.T).T, np.ascontiguousarray(edges_right.T).T)
+assignments_strided = np.zeros((2 * assignments.shape[0], 2 * assignments.shape[1]), dtype=np.float32)
+assignments_strided[::2, ::2] = assignments
+quadratic_strided = np.zeros((2 * quadratic_terms.shape[0], 2 * quadratic_terms.shape[1]))
+quadratic_strided[::2, ::2] = quadratic_terms
+edges_left_strided = np.zeros((2 * edges_left.shape[0], 2), dtype=np.int32)
+edges_left_strided[::2] = edges_left
+check("strided", assignments_strided[::2, ::2], quadratic_strided[::2, ::2], edges_left_strided[::2], edges_right)
+
+# python lists and objects implementing __array__
+check("lists", assignments.tolist(), quadratic_terms.tolist(), edges_left.tolist(), [tuple(e) for e in edges_right.tolist()])
+
+
+class array_like:
+    def __init__(self, a):
+        self.a = a
+
+    def __array__(self, dtype=None, copy=None):
+        return self.a if dtype is None else self.a.astype(dtype)
+
+
+check("__array__", array_like(assignments), array_like(quadratic_terms), array_like(edges_left), array_like(edges_right))
@@ -0,0 +1,74 @@
+import sys
+import types
+import numpy as np
+import graph_matching_py
+import multigraph_matching_py
+
+# lpmp_py imports the extension modules from the package it is installed with, point it to the modules of the build directory instead
+bindings = types.ModuleType("bindings")
+bindings.graph_matching_py = graph_matching_py
+bindings.multigraph_matching_py = multigraph_matching_py
+sys.modules["bindings"] = bindings
+sys.modules["bindings.graph_matching_py"] = graph_matching_py
+sys.modules["bindings.multigraph_matching_py"] = multigraph_matching_py
+
+from lpmp_py.raw_solvers import gm_solver, GmBatchSolver
+
+# batch of instances of different sizes, compared against solving every instance on its own.
+# Unary costs strongly prefer one matching, so that each instance has a unique optimum found by every solve.
+
+rng = np.random.default_rng(0)
+solver_params = {"maxIter": 50}
+
+sizes = [(3, 3), (4, 3), (2, 4)]
+edges_left = [np.array([[i, i + 1] for i in range(n1 - 1)] + [[n1 - 1, 0]], dtype=np.int32) for n1, _ in sizes]
+edges_right = [np.array([[j, j + 1] for j in range(n2 - 1)] + [[0, n2 - 1]], dtype=np.int64) for _, n2 in sizes]
+max_nodes = (max(n1 for n1, _ in sizes), max(n2 for _, n2 in sizes))
+max_edges = (max(len(e) for e in edges_left), max(len(e) for e in edges_right))
+
+
+def random_costs():
+    costs, quadratic_costs = [], []
+    for k, (n1, n2) in enumerate(sizes):
+        c = rng.uniform(0.0, 1.0, size=(n1, n2))
+        perm = rng.permutation(max(n1, n2))
+        for i in range(n1):
+            if perm[i] < n2:
+                c[i, perm[i]] -= 10.0
+        costs.append(c)
+        quadratic_costs.append(rng.uniform(-0.5, 0.5, size=(len(edges_left[k]), len(edges_right[k]))))
+    return costs, quadratic_costs
+
+
+def pad(arrays, shape):
+    padded = np.zeros((len(arrays),) + shape)
+    for k, a in enumerate(arrays):
+        padded[k, : a.shape[0], : a.shape[1]] = a
+    return padded
+
+
+def check(costs, quadratic_costs, costs_paid, quadratic_costs_paid):
+    for k in range(len(sizes)):
+        n1, n2 = sizes[k]
+        m1, m2 = len(edges_left[k]), len(edges_right[k])
+        expected_costs_paid, expected_quadratic_costs_paid = gm_solver(costs[k], quadratic_costs[k], edges_left[k], edges_right[k], solver_params)
+        if not np.array_equal(costs_paid[k, :n1, :n2], expected_costs_paid):
+            raise AssertionError("batch matching of instance " + str(k) + " differs from single solve")
+        if not np.array_equal(quadratic_costs_paid[k, :m1, :m2], expected_quadratic_costs_paid):
+            raise AssertionError("batch quadratic mask of instance " + str(k) + " differs from single solve")
+        if costs_paid[k].sum() != costs_paid[k, :n1, :n2].sum():
+            raise AssertionError("batch matching of instance " + str(k) + " is not zero padded")
+        if quadratic_costs_paid[k].sum() != quadratic_costs_paid[k, :m1, :m2].sum():
+            raise AssertionError("batch quadratic mask of instance " + str(k) + " is not zero padded")
+
+
+solver = GmBatchSolver(edges_left, edges_right, [n1 for n1, _ in sizes], [n2 for _, n2 in sizes], solver_params, nr_threads=2)
+
+costs, quadratic_costs = random_costs()
+costs_paid, quadratic_costs_paid = solver.solve(pad(costs, max_nodes), pad(quadratic_costs, max_edges))
+check(costs, quadratic_costs, costs_paid, quadratic_costs_paid)
+
+# warm start: changed costs, continuing from the previous duals must give the same result as a fresh solve
+costs, quadratic_costs = random_costs()
+costs_paid, quadratic_costs_paid = solver.solve(pad(costs, max_nodes).astype(np.float32), pad(quadratic_costs, max_edges))
+check([c.astype(np.float32).astype(np.float64) for c in costs], quadratic_costs, costs_paid, quadratic_costs_paid)
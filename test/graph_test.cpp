@@ -60,6 +60,34 @@ void test_maximal_clique_enumeration()
     test(std::count(clique_visited.begin(), clique_visited.end(), false) == 0);
 }
 
+void test_concurrent_contraction()
+{
+    dynamic_graph_thread_safe<double> g(edges.begin(), edges.end(), [](const auto&) { return 1.0; });
+
+    test(g.try_lock_node(0));
+    test(g.try_lock_node(2));
+    test(!g.try_lock_node(2));
+    std::vector<std::size_t> locked_nodes = {0,2};
+    test(g.try_lock_neighborhood(0, 2, locked_nodes));
+    test(locked_nodes.size() == 4);
+    test(!g.try_lock_node(1) && !g.try_lock_node(3));
+
+    std::size_t no_changed_edges = 0;
+    const std::size_t stable_node = g.contract_edge(0, 2, [](double& e1, const double e2) { e1 += e2; }, [&](const std::size_t i, const std::size_t j, const double e) {
+            test(e == 2.0);
+            no_changed_edges++;
+            });
+    g.unlock_nodes(locked_nodes);
+
+    test(stable_node == 0);
+    test(no_changed_edges == 2);
+    test(g.no_edges(0) == 2 && g.no_edges(2) == 0);
+    test(g.edge(0,1) == 2.0 && g.edge(1,0) == 2.0);
+    test(g.edge(0,3) == 2.0 && g.edge(3,0) == 2.0);
+    test(!g.edge_present(1,2) && !g.edge_present(2,3));
+    test(g.try_lock_node(1));
+}
+
 int main(int argc, char** argv)
 {
 	std::sort(edges.begin(), edges.end(), [](const auto& e1, const auto& e2) { return std::lexicographical_compare(e1.begin(), e1.end(), e2.begin(), e2.end()); });
@@ -69,6 +97,7 @@ int main(int argc, char** argv)
     auto g = construct_and_test_graph<graph<empty>>();
 
     test_maximal_clique_enumeration();
+    test_concurrent_contraction();
 
 	std::vector<std::array<std::size_t,2>> edges_check;
 	g.for_each_edge([&](const std::size_t i, const std::size_t j, const empty&) { edges_check.push_back({i,j}); });
@@ -4,6 +4,8 @@
 #include "solver.hxx"
 #include "visitors/standard_visitor.hxx"
 #include "mrf/cycle_inequalities.hxx"
+#include <random>
+#include <omp.h>
 
 using namespace LPMP;
 
@@ -240,5 +242,56 @@ int main()
       }
       test(s.GetLP().LowerBound() > 1.0-eps);
    }
+
+   // separation must return the same candidates for any number of threads
+   {
+     Solver<LP<FMC_SRMP_T>,StandardVisitor> s(i);
+     auto& mrf = s.GetProblemConstructor();
+
+     std::mt19937 gen(0);
+     std::uniform_real_distribution<> dist(-1.0, 1.0);
+     const std::size_t dim = 10;
+     for(std::size_t n=0; n<dim*dim; ++n) {
+        mrf.add_unary_factor({dist(gen), dist(gen), dist(gen)});
+     }
+     auto add_random_pairwise_factor = [&](const std::size_t n1, const std::size_t n2) {
+        matrix<REAL> pot(3,3);
+        for(std::size_t x1=0; x1<3; ++x1) {
+           for(std::size_t x2=0; x2<3; ++x2) {
+              pot(x1,x2) = dist(gen);
+           }
+        }
+        mrf.add_pairwise_factor(n1,n2,pot);
+     };
+     for(std::size_t x=0; x<dim; ++x) {
+        for(std::size_t y=0; y<dim; ++y) {
+           if(x+1 < dim) { add_random_pairwise_factor(x*dim+y, (x+1)*dim+y); }
+           if(y+1 < dim) { add_random_pairwise_factor(x*dim+y, x*dim+y+1); }
+           if(x+1 < dim && y+1 < dim) { add_random_pairwise_factor(x*dim+y, (x+1)*dim+y+1); }
+        }
+     }
+
+     using mrf_type = typename std::remove_reference<decltype(mrf)>::type;
+     auto search_with_threads = [&](const int no_threads) {
+        omp_set_num_threads(no_threads);
+        triplet_search<mrf_type> triplets(mrf, 0.0);
+        auto candidates = triplets.search();
+        k_ary_cycle_inequalities_search<mrf_type,false> cycle_search(mrf);
+        auto cycle_candidates = cycle_search.search();
+        candidates.insert(candidates.end(), cycle_candidates.begin(), cycle_candidates.end());
+        k_ary_cycle_inequalities_search<mrf_type,true> cycle_search_extended(mrf);
+        cycle_candidates = cycle_search_extended.search();
+        candidates.insert(candidates.end(), cycle_candidates.begin(), cycle_candidates.end());
+        return candidates;
+     };
+
+     const auto candidates_serial = search_with_threads(1);
+     const auto candidates_parallel = search_with_threads(4);
+     test(candidates_serial.size() > 0);
+     test(candidates_serial.size() == candidates_parallel.size());
+     for(std::size_t c=0; c<candidates_serial.size(); ++c) {
+        test(candidates_serial[c] == candidates_parallel[c] && candidates_serial[c].cost == candidates_parallel[c].cost);
+     }
+   }
 }
 
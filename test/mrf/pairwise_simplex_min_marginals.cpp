@@ -0,0 +1,50 @@
+#include "test.h"
+#include "mrf/simplex_factor.hxx"
+#include <random>
+
+using namespace LPMP;
+
+// compare SIMD min-marginals and lower bound of pairwise simplex factor with straightforward scalar computation for varying label counts. Timings are in benchmark/pairwise_simplex_min_marginals.cpp
+int main()
+{
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<> dist(-1.0, 1.0);
+
+   for(const std::size_t dim : {16, 17, 32, 63, 64, 128, 256}) {
+      PairwiseSimplexFactor f(dim, dim+3);
+      for(std::size_t x1=0; x1<f.dim1(); ++x1) {
+         f.msg1(x1) = dist(gen);
+         for(std::size_t x2=0; x2<f.dim2(); ++x2) {
+            f.cost(x1,x2) = dist(gen);
+         }
+      }
+      for(std::size_t x2=0; x2<f.dim2(); ++x2) {
+         f.msg2(x2) = dist(gen);
+      }
+
+      std::vector<double> min_marg_1(f.dim1(), std::numeric_limits<double>::infinity());
+      std::vector<double> min_marg_2(f.dim2(), std::numeric_limits<double>::infinity());
+      double lb = std::numeric_limits<double>::infinity();
+      for(std::size_t x1=0; x1<f.dim1(); ++x1) {
+         for(std::size_t x2=0; x2<f.dim2(); ++x2) {
+            const double val = f(x1,x2);
+            min_marg_1[x1] = std::min(min_marg_1[x1], val);
+            min_marg_2[x2] = std::min(min_marg_2[x2], val);
+            lb = std::min(lb, val);
+         }
+      }
+
+      const auto simd_min_marg_1 = f.min_marginal_1();
+      const auto simd_min_marg_2 = f.min_marginal_2();
+      const double simd_lb = f.LowerBound();
+
+      test(simd_min_marg_1.size() == f.dim1() && simd_min_marg_2.size() == f.dim2());
+      for(std::size_t x1=0; x1<f.dim1(); ++x1) {
+         test(std::abs(simd_min_marg_1[x1] - min_marg_1[x1]) <= eps, "first min-marginal differs from scalar computation");
+      }
+      for(std::size_t x2=0; x2<f.dim2(); ++x2) {
+         test(std::abs(simd_min_marg_2[x2] - min_marg_2[x2]) <= eps, "second min-marginal differs from scalar computation");
+      }
+      test(std::abs(simd_lb - lb) <= eps, "lower bound differs from scalar computation");
+   }
+}
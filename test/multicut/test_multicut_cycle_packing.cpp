@@ -1,20 +1,77 @@
 #include "multicut/multicut_cycle_packing.h"
 #include "test.h"
+#include <random>
+#include <map>
+#include <array>
+#include <cmath>
+#include <omp.h>
 
 using namespace LPMP;
 
+// cycles of a packing must not use more than the available weight of any edge
+void test_packing_feasibility(const multicut_instance& instance, const cycle_packing& cp)
+{
+   std::map<std::array<std::size_t,2>, double> edge_usage;
+   double packed_weight = 0.0;
+   for(std::size_t c=0; c<cp.no_cycles(); ++c) {
+      const auto [cycle_begin, cycle_end] = cp.get_cycle(c);
+      const std::size_t cycle_length = std::distance(cycle_begin, cycle_end);
+      for(std::size_t i=0; i<cycle_length; ++i) {
+         const std::size_t n1 = *(cycle_begin + i);
+         const std::size_t n2 = *(cycle_begin + (i+1)%cycle_length);
+         edge_usage[{std::min(n1,n2), std::max(n1,n2)}] += cp.get_cycle_weight(c);
+      }
+      packed_weight += cp.get_cycle_weight(c);
+   }
+
+   for(const auto& e : instance.edges()) {
+      const auto it = edge_usage.find({std::min(e[0],e[1]), std::max(e[0],e[1])});
+      if(it != edge_usage.end()) {
+         test(it->second <= std::abs(e.cost[0]) + 1e-6, "cycle packing uses more weight than available on an edge");
+      }
+   }
+
+   auto triplet_instance = pack_multicut_instance(instance, cp);
+   test(triplet_instance.lower_bound() >= instance.lower_bound() - 1e-6);
+   test(packed_weight >= 0.0);
+}
+
 int main()
 {
-   multicut_instance test_instance;
-   test_instance.add_edge(0,1,-1);
-   test_instance.add_edge(0,2,+1);
-   test_instance.add_edge(1,2,+1);
-
-   test(test_instance.no_edges() == 3);
-   test(std::abs(test_instance.lower_bound() - -1.0) <= 1e-8);
-   auto cp = compute_multicut_cycle_packing(test_instance);
-   auto triplet_instance = pack_multicut_instance(test_instance, cp);
-   test(triplet_instance.edges().size() == 3);
-   test(triplet_instance.triplets().size() == 1);
-   test(std::abs(triplet_instance.lower_bound()) <= 1e-8);
-} 
+   {
+      multicut_instance test_instance;
+      test_instance.add_edge(0,1,-1);
+      test_instance.add_edge(0,2,+1);
+      test_instance.add_edge(1,2,+1);
+
+      test(test_instance.no_edges() == 3);
+      test(std::abs(test_instance.lower_bound() - -1.0) <= 1e-8);
+      auto cp = compute_multicut_cycle_packing(test_instance);
+      auto triplet_instance = pack_multicut_instance(test_instance, cp);
+      test(triplet_instance.edges().size() == 3);
+      test(triplet_instance.triplets().size() == 1);
+      test(std::abs(triplet_instance.lower_bound()) <= 1e-8);
+   }
+
+   // grid with diagonals and random costs, packed concurrently from many repulsive edges
+   {
+      std::mt19937 gen(0);
+      std::uniform_real_distribution<> dist(-1.0, 1.0);
+      multicut_instance grid_instance;
+      const std::size_t dim = 30;
+      for(std::size_t x=0; x<dim; ++x) {
+         for(std::size_t y=0; y<dim; ++y) {
+            if(x+1 < dim) { grid_instance.add_edge(x*dim+y, (x+1)*dim+y, dist(gen)); }
+            if(y+1 < dim) { grid_instance.add_edge(x*dim+y, x*dim+y+1, dist(gen)); }
+            if(x+1 < dim && y+1 < dim) { grid_instance.add_edge(x*dim+y, (x+1)*dim+y+1, dist(gen)); }
+         }
+      }
+
+      for(const int no_threads : {1, 4}) {
+         omp_set_num_threads(no_threads);
+         const auto cp = compute_multicut_cycle_packing(grid_instance);
+         test(cp.no_cycles() > 0);
+         test_packing_feasibility(grid_instance, cp);
+      }
+   }
+}
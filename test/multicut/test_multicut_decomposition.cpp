@@ -0,0 +1,66 @@
+#include "multicut/multicut.h"
+#include "cut_base/cut_base_decomposition.hxx"
+#include "visitors/standard_visitor.hxx"
+#include "test.h"
+#include <random>
+
+using namespace LPMP;
+
+int main()
+{
+    const std::vector<std::string> options = {
+        {""},
+        {"--maxIter"}, {"20"}
+    };
+
+    // small components are solved exactly by enumeration
+    {
+        multicut_instance instance;
+        instance.add_edge(0,1,1);
+        instance.add_edge(0,2,1);
+        instance.add_edge(1,2,-1.5);
+        instance.add_edge(1,3,1);
+        instance.add_edge(2,3,1);
+
+        instance.add_edge(4,5,-1);
+        instance.add_edge(5,6,2);
+
+        const cut_base_decomposition<multicut_instance> decomposition(instance);
+        test(decomposition.no_components() == 2);
+
+        const auto sol = solve_decomposed<Solver<LP<FMC_MULTICUT>,StandardVisitor>>(instance, options, 2, instance.no_nodes());
+        test(instance.feasible(multicut_edge_labeling(sol.labeling.begin(), sol.labeling.end())));
+        test(sol.cost == -1.0);
+        test(sol.lower_bound == -1.0);
+    }
+
+    // several disjoint grids with random costs, each one solved by its own solver
+    {
+        std::mt19937 gen(0);
+        std::uniform_real_distribution<> dist(-1.0, 1.0);
+        multicut_instance instance;
+        const std::size_t dim = 10;
+        const std::size_t no_grids = 4;
+        for(std::size_t g=0; g<no_grids; ++g) {
+            const std::size_t offset = g*dim*dim;
+            for(std::size_t i=0; i<dim; ++i) {
+                for(std::size_t j=0; j<dim; ++j) {
+                    if(i+1 < dim)
+                        instance.add_edge(offset + i*dim + j, offset + (i+1)*dim + j, dist(gen));
+                    if(j+1 < dim)
+                        instance.add_edge(offset + i*dim + j, offset + i*dim + j+1, dist(gen));
+                }
+            }
+        }
+
+        const cut_base_decomposition<multicut_instance> decomposition(instance);
+        test(decomposition.no_components() == no_grids);
+        for(std::size_t c=0; c<decomposition.no_components(); ++c)
+            test(decomposition.component(c).no_nodes() == dim*dim);
+
+        const auto sol = solve_decomposed<Solver<LP<FMC_MULTICUT>,StandardVisitor>>(instance, options, 2, instance.no_nodes());
+        test(sol.labeling.size() == instance.no_edges());
+        test(instance.feasible(multicut_edge_labeling(sol.labeling.begin(), sol.labeling.end())));
+        test(sol.lower_bound <= sol.cost + 1e-8);
+    }
+}
@@ -0,0 +1,50 @@
+#include "multicut/multicut_instance.h"
+#include "multicut/multicut_greedy_additive_edge_contraction_parallel.h"
+#include "test.h"
+#include <random>
+#include <map>
+
+using namespace LPMP;
+
+void test_gaec_solution(const multicut_instance& instance, const multicut_edge_labeling& sol)
+{
+    multicut_edge_labeling all_cut;
+    all_cut.resize(instance.no_edges(), 1);
+
+    test(instance.feasible(sol));
+    test(instance.evaluate(sol) < instance.evaluate(all_cut));
+
+    // no two clusters are connected by edges with positive total weight anymore
+    const multicut_node_labeling node_labeling = sol.transform_to_node_labeling(instance);
+    std::map<std::array<std::size_t,2>, double> cluster_pair_cost;
+    for(const auto& e : instance.edges()) {
+        const std::size_t c1 = node_labeling[e[0]];
+        const std::size_t c2 = node_labeling[e[1]];
+        if(c1 != c2)
+            cluster_pair_cost[{std::min(c1,c2), std::max(c1,c2)}] += e.cost[0];
+    }
+    for(const auto& [clusters, cost] : cluster_pair_cost)
+        test(cost <= 1e-8, "concurrent contraction stopped before all positive edges were contracted");
+}
+
+// Concurrent greedy additive edge contraction on a random grid. Timings for up to 64 threads are in benchmark/multicut_gaec_concurrent_scaling.cpp
+int main()
+{
+    const std::size_t dim = 100;
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<> dist(-1.0, 1.0);
+    multicut_instance instance;
+    for(std::size_t x=0; x<dim; ++x) {
+        for(std::size_t y=0; y<dim; ++y) {
+            if(x+1 < dim) { instance.add_edge(x*dim+y, (x+1)*dim+y, dist(gen)); }
+            if(y+1 < dim) { instance.add_edge(x*dim+y, x*dim+y+1, dist(gen)); }
+        }
+    }
+
+    for(int nr_threads=1; nr_threads<=4; nr_threads*=2) {
+        test_gaec_solution(instance, greedy_additive_edge_contraction_parallel(instance, nr_threads, "concurrent"));
+        // all conflicting edges are left to the serial phase
+        test_gaec_solution(instance, greedy_additive_edge_contraction_concurrent(instance, nr_threads, 0));
+    }
+}
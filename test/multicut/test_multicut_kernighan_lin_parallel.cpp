@@ -0,0 +1,54 @@
+#include "multicut/multicut_instance.h"
+#include "multicut/multicut_kernighan_lin_parallel.h"
+#include "multicut/multicut_greedy_additive_edge_contraction_parallel.h"
+#include "test.h"
+#include <random>
+
+using namespace LPMP;
+
+int main()
+{
+    {
+        multicut_instance test_instance;
+        test_instance.add_edge(0,1,1);
+        test_instance.add_edge(0,2,1);
+        test_instance.add_edge(1,2,-1.5);
+        test_instance.add_edge(1,3,1);
+        test_instance.add_edge(2,3,1);
+
+        // starting from singletons, all clusters are joined
+        const multicut_edge_labeling sol = compute_multicut_kernighan_lin_parallel(test_instance, multicut_edge_labeling(), 2);
+        test(test_instance.feasible(sol));
+        test(test_instance.evaluate(sol) == 0.0);
+    }
+
+    // grid with random costs
+    {
+        std::mt19937 gen(0);
+        std::uniform_real_distribution<> dist(-1.0, 1.0);
+        multicut_instance grid_instance;
+        const std::size_t dim = 40;
+        for(std::size_t x=0; x<dim; ++x) {
+            for(std::size_t y=0; y<dim; ++y) {
+                if(x+1 < dim) { grid_instance.add_edge(x*dim+y, (x+1)*dim+y, dist(gen)); }
+                if(y+1 < dim) { grid_instance.add_edge(x*dim+y, x*dim+y+1, dist(gen)); }
+            }
+        }
+
+        const multicut_kernighan_lin_parallel kl(grid_instance);
+        multicut_edge_labeling singletons;
+        singletons.resize(grid_instance.no_edges(), 1);
+
+        const multicut_edge_labeling sol_1 = kl.optimize(singletons, 1);
+        const multicut_edge_labeling sol_4 = kl.optimize(singletons, 4);
+        test(grid_instance.feasible(sol_1));
+        test(grid_instance.evaluate(sol_1) < grid_instance.evaluate(singletons));
+        test(sol_1 == sol_4, "result must not depend on number of threads");
+
+        const multicut_edge_labeling gaec = greedy_additive_edge_contraction_parallel(grid_instance, 2, "non-blocking");
+        const multicut_edge_labeling gaec_kl = compute_multicut_kernighan_lin_parallel(grid_instance, gaec, 2);
+        test(grid_instance.feasible(gaec_kl));
+        test(grid_instance.evaluate(gaec_kl) <= grid_instance.evaluate(gaec) + 1e-8);
+        test(grid_instance.feasible(compute_multicut_gaec_kernighan_lin_parallel(grid_instance, 2)));
+    }
+}
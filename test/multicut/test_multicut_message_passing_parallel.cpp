@@ -109,4 +109,40 @@ int main()
       auto lb2 = compute_lower_bound(other_edges, edge_to_triangle, triangle_to_edge);
       std::cout << "Lower bound after MP step 2:" << lb2 << std::endl;
    }
+   {
+      // one edge contained in many triangles. The block schedule must give the same result for any number of threads.
+      auto hub_instance = [](std::vector<edge_item>& edge_to_triangle, std::vector<triangle_item>& triangle_to_edge) {
+         const std::size_t no_triangles = 5000;
+         edge_to_triangle.push_back(edge_item{{0,1},-1.0*no_triangles,{}});
+         for(std::size_t t=0; t<no_triangles; ++t) {
+            const std::size_t k = t+2;
+            edge_to_triangle[0].triangle_indices.push_back({k,t});
+            edge_to_triangle.push_back(edge_item{{0,k},1.0+t%3,{{1,t}}});
+            edge_to_triangle.push_back(edge_item{{1,k},1.0+t%5,{{0,t}}});
+            triangle_to_edge.push_back(triangle_item{{0,1,k},{0,0,0},{0,edge_to_triangle.size()-1,edge_to_triangle.size()-2}});
+         }
+      };
+      auto run = [&](const int nr_threads) {
+         std::vector<edge_item> edge_to_triangle;
+         std::vector<triangle_item> triangle_to_edge;
+         hub_instance(edge_to_triangle, triangle_to_edge);
+         tf::Taskflow taskflow;
+         tf::Executor executor(nr_threads);
+         LPMP::send_weights_to_triplets_parallel(taskflow, edge_to_triangle, triangle_to_edge, nr_threads);
+         executor.run(taskflow).wait();
+         taskflow.clear();
+         LPMP::send_triplets_to_edge_parallel(taskflow, edge_to_triangle, triangle_to_edge, nr_threads);
+         executor.run(taskflow).wait();
+         std::vector<edge_t> other_edges = {};
+         std::vector<double> costs;
+         for(const auto& e : edge_to_triangle)
+            costs.push_back(e.cost);
+         return std::make_pair(costs, compute_lower_bound(other_edges, edge_to_triangle, triangle_to_edge));
+      };
+      const auto [costs_1, lb_1] = run(1);
+      const auto [costs_4, lb_4] = run(4);
+      test(costs_1 == costs_4);
+      test(lb_1 == lb_4);
+      test(lb_1 >= -5000.0 - 1e-6);
+   }
 } 
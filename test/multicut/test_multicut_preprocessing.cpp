@@ -0,0 +1,111 @@
+#include "multicut/multicut_instance.h"
+#include "multicut/multicut_preprocessing.h"
+#include "test.h"
+#include <random>
+#include <cmath>
+#include <limits>
+
+using namespace LPMP;
+
+// optimal multicut by enumerating all partitions of the nodes
+template<typename FUNC>
+void enumerate_partitions(multicut_node_labeling& labeling, const std::size_t i, const std::size_t no_labels, FUNC f)
+{
+    if(i == labeling.size()) {
+        f(labeling);
+        return;
+    }
+    for(std::size_t l=0; l<=no_labels; ++l) {
+        labeling[i] = l;
+        enumerate_partitions(labeling, i+1, std::max(no_labels, l+1), f);
+    }
+}
+
+multicut_node_labeling optimal_labeling(const multicut_instance& instance)
+{
+    multicut_node_labeling labeling(instance.no_nodes());
+    multicut_node_labeling best_labeling = labeling;
+    double best_cost = std::numeric_limits<double>::infinity();
+    enumerate_partitions(labeling, 0, 0, [&](const multicut_node_labeling& l) {
+        const double cost = instance.evaluate(l);
+        if(cost < best_cost) {
+            best_cost = cost;
+            best_labeling = l;
+        }
+    });
+    return best_labeling;
+}
+
+int main()
+{
+    // dangling trees and dominating edges decide everything
+    {
+        multicut_instance instance;
+        instance.add_edge(0,1,5);
+        instance.add_edge(1,2,-1);
+        instance.add_edge(2,3,2);
+        instance.add_edge(2,4,-3);
+        instance.add_edge(0,2,1);
+
+        multicut_reduction reduction(instance);
+        test(reduction.reduced_instance().no_edges() == 0);
+        test(reduction.no_decided_edges() == instance.no_edges());
+        test(reduction.no_components() == 0);
+
+        const multicut_node_labeling labeling = reduction.lift(multicut_node_labeling{});
+        test(std::abs(instance.evaluate(labeling) - (-3.0)) <= 1e-8);
+        test(std::abs(reduction.decided_cost() - (-3.0)) <= 1e-8);
+    }
+
+    // two complete graphs on four nodes in which no edge is dominating, joined by an edge of zero cost
+    {
+        multicut_instance instance;
+        for(const std::size_t o : {0, 4}) {
+            instance.add_edge(o+0,o+1,1);
+            instance.add_edge(o+0,o+2,1);
+            instance.add_edge(o+0,o+3,-1);
+            instance.add_edge(o+1,o+2,-1);
+            instance.add_edge(o+1,o+3,1);
+            instance.add_edge(o+2,o+3,1);
+        }
+        instance.add_edge(3,4,0);
+
+        multicut_reduction reduction(instance);
+        test(reduction.no_components() == 2);
+        test(reduction.reduced_instance().no_edges() == 12);
+
+        std::vector<multicut_node_labeling> component_labelings;
+        for(std::size_t c=0; c<reduction.no_components(); ++c)
+            component_labelings.push_back(optimal_labeling(reduction.component(c)));
+        const multicut_node_labeling labeling = reduction.lift(component_labelings);
+        test(std::abs(instance.evaluate(labeling) - instance.evaluate(optimal_labeling(instance))) <= 1e-8);
+    }
+
+    // random sparse instances: solving the reduced instance gives an optimal solution of the original one
+    {
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<int> cost_dist(-4, 4);
+        std::bernoulli_distribution edge_dist(0.4);
+        for(std::size_t iter=0; iter<200; ++iter) {
+            multicut_instance instance;
+            const std::size_t no_nodes = 3 + iter%6;
+            instance.add_edge(0, no_nodes-1, cost_dist(gen) + 0.5);
+            for(std::size_t i=0; i<no_nodes; ++i)
+                for(std::size_t j=i+1; j<no_nodes; ++j)
+                    if(edge_dist(gen))
+                        instance.add_edge(i, j, cost_dist(gen));
+
+            multicut_reduction reduction(instance);
+            const double optimal_cost = instance.evaluate(optimal_labeling(instance));
+
+            const multicut_node_labeling reduced_labeling = optimal_labeling(reduction.reduced_instance());
+            test(std::abs(reduction.reduced_instance().evaluate(reduced_labeling) - optimal_cost) <= 1e-8);
+            test(std::abs(instance.evaluate(reduction.lift(reduced_labeling)) - optimal_cost) <= 1e-8);
+
+            const multicut_edge_labeling reduced_edge_labeling = reduced_labeling.transform_to_edge_labeling(reduction.reduced_instance());
+            const multicut_edge_labeling edge_labeling = reduction.lift(instance, reduced_edge_labeling);
+            test(instance.feasible(edge_labeling));
+            test(std::abs(instance.evaluate(edge_labeling) - optimal_cost) <= 1e-8);
+        }
+    }
+}
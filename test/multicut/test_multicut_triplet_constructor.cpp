@@ -0,0 +1,58 @@
+#include "multicut/multicut.h"
+#include "visitors/standard_visitor.hxx"
+#include "test.h"
+#include <random>
+#include <algorithm>
+#include <string>
+
+using namespace LPMP;
+
+// Adds many triplet factors to the multicut constructor and checks that edges and triplets can be looked up.
+// Timings for large numbers of triplets: benchmark/multicut_triplet_constructor.cpp
+int main(int argc, char** argv)
+{
+    const std::size_t no_triplets = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const std::size_t no_nodes = std::max(std::size_t(100), no_triplets/10);
+
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> node_dist(0, no_nodes-1);
+    std::vector<std::array<std::size_t,3>> triplets;
+    triplets.reserve(no_triplets);
+    while(triplets.size() < no_triplets) {
+        std::array<std::size_t,3> t{node_dist(gen), node_dist(gen), node_dist(gen)};
+        std::sort(t.begin(), t.end());
+        if(t[0] != t[1] && t[1] != t[2]) {
+            triplets.push_back(t);
+        }
+    }
+    std::sort(triplets.begin(), triplets.end());
+    triplets.erase(std::unique(triplets.begin(), triplets.end()), triplets.end());
+    std::shuffle(triplets.begin(), triplets.end(), gen);
+
+    Solver<LP<FMC_MULTICUT>,StandardVisitor> s;
+    auto& mc = s.GetProblemConstructor();
+    mc.add_edge_factor(0, no_nodes-1, 1.0);
+    mc.reserve_triplet_factors(triplets.size());
+
+    for(const auto& t : triplets) {
+        if(mc.find_triplet_factor(t[0], t[1], t[2]) == nullptr) {
+            mc.add_triplet_factor(t[0], t[1], t[2]);
+        }
+    }
+
+    std::size_t no_found = 0;
+    for(const auto& t : triplets) {
+        auto* f = mc.find_triplet_factor(t[0], t[1], t[2]);
+        no_found += f != nullptr;
+        test(f == mc.get_triplet_factor(t[0], t[1], t[2]));
+        test(mc.find_edge_factor(t[0], t[1]) != nullptr && mc.find_edge_factor(t[0], t[2]) != nullptr && mc.find_edge_factor(t[1], t[2]) != nullptr);
+    }
+
+    test(no_found == triplets.size());
+    test(mc.number_of_triplets() == triplets.size());
+    test(mc.get_edge_cost(0, no_nodes-1) == 1.0);
+    for(std::size_t i=0; i<mc.triplet_factors().size(); ++i) {
+        const auto& t = mc.triplet_factors()[i];
+        test(mc.get_triplet_factor(t.first[0], t.first[1], t.first[2]) == t.second);
+    }
+}
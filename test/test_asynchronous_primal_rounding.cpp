@@ -0,0 +1,120 @@
+#include "test.h"
+#include "solver.hxx"
+#include "visitors/standard_visitor.hxx"
+#include "test_model.hxx"
+#include <cmath>
+#include <functional>
+
+using namespace LPMP;
+
+// rounds all factors of a chain to the label of the first factor's reparametrized cost
+template<typename FMC>
+struct chain_rounding_problem_constructor {
+   template<typename SOLVER>
+   chain_rounding_problem_constructor(SOLVER& s) : lp_(&s.GetLP()) {}
+
+   void ComputePrimal()
+   {
+      read_in_primal_rounding(export_primal_rounding_task()());
+   }
+
+   std::function<std::vector<INDEX>()> export_primal_rounding_task()
+   {
+      const auto& cost = factors.front()->get_factor()->cost;
+      const std::array<REAL,2> first_cost = {cost[0], cost[1]};
+      const std::size_t nr_factors = factors.size();
+      return [first_cost, nr_factors]() {
+         const INDEX label = first_cost[0] <= first_cost[1] ? 0 : 1;
+         return std::vector<INDEX>(nr_factors, label);
+      };
+   }
+
+   void read_in_primal_rounding(const std::vector<INDEX>& labeling)
+   {
+      assert(labeling.size() == factors.size());
+      for(std::size_t i=0; i<factors.size(); ++i)
+         factors[i]->get_factor()->primal = labeling[i];
+      rounded_costs.push_back(lp_->EvaluatePrimal());
+   }
+
+   std::vector<FactorContainer<test_factor, FMC, 0>*> factors;
+   std::vector<double> rounded_costs;
+   LP<FMC>* lp_;
+};
+
+struct rounding_test_FMC {
+  constexpr static const char* name = "test model with problem constructor rounding";
+  using factor = FactorContainer<test_factor, rounding_test_FMC, 0>;
+  using message = MessageContainer<test_message, 0, 0, message_passing_schedule::left, variableMessageNumber, variableMessageNumber, rounding_test_FMC, 0>;
+  using FactorList = meta::list<factor>;
+  using MessageList = meta::list<message>;
+  using problem_constructor = chain_rounding_problem_constructor<rounding_test_FMC>;
+};
+
+using base_solver = Solver<LP<rounding_test_FMC>, StandardVisitor>;
+using asynchronous_solver = ProblemConstructorRoundingSolver<base_solver>;
+static_assert(asynchronous_solver::can_round_asynchronously());
+
+// reference: rounds in the main thread
+struct synchronous_solver : public asynchronous_solver {
+   using asynchronous_solver::asynchronous_solver;
+   void PostIterate(LpControl c) override
+   {
+      if(c.computePrimal) {
+         this->ComputePrimal();
+         this->RegisterPrimal();
+      }
+      base_solver::PostIterate(c);
+   }
+};
+
+// rounds in the background, but waits for the rounding in the same iteration
+struct joined_solver : public asynchronous_solver {
+   using asynchronous_solver::asynchronous_solver;
+   void PostIterate(LpControl c) override
+   {
+      asynchronous_solver::PostIterate(c);
+      this->join_primal_rounding();
+   }
+};
+
+template<typename SOLVER>
+void build_model(SOLVER& s)
+{
+   auto& lp = s.GetLP();
+   auto& factors = s.GetProblemConstructor().factors;
+   for(std::size_t i=0; i<20; ++i) {
+      factors.push_back( lp.template add_factor<typename rounding_test_FMC::factor>(double(i%3), double((i+1)%2)) );
+   }
+   for(std::size_t i=0; i+1<factors.size(); ++i) {
+      lp.template add_message<typename rounding_test_FMC::message>(factors[i], factors[i+1]);
+      lp.add_factor_relation(factors[i], factors[i+1]);
+   }
+}
+
+int main()
+{
+   const std::vector<std::string> options = {"rounding", "--maxIter", "30", "--primalComputationInterval", "1"};
+   synchronous_solver s_sync(options);
+   joined_solver s_joined(options);
+   asynchronous_solver s_async(options);
+
+   build_model(s_sync);
+   build_model(s_joined);
+   build_model(s_async);
+   s_sync.Solve();
+   s_joined.Solve();
+   s_async.Solve();
+
+   const auto& sync_costs = s_sync.GetProblemConstructor().rounded_costs;
+   const auto& joined_costs = s_joined.GetProblemConstructor().rounded_costs;
+   test(!sync_costs.empty());
+   test(sync_costs == joined_costs, "rounding joined every iteration must read in the same primals as synchronous rounding");
+   test(s_sync.primal_cost() == s_joined.primal_cost());
+
+   // without joining, at least the rounding waited for in End has been read in
+   test(!s_async.GetProblemConstructor().rounded_costs.empty());
+   test(std::isfinite(s_async.primal_cost()));
+   test(s_async.primal_cost() >= s_async.lower_bound() - 1e-8);
+   test(std::abs(s_async.lower_bound() - s_sync.lower_bound()) <= 1e-8);
+}
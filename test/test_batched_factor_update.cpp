@@ -0,0 +1,127 @@
+#include "test.h"
+#include "LP.h"
+#include "test_model.hxx"
+#include <random>
+
+using namespace LPMP;
+
+// two factor types with the same payload, so that update orderings consist of many short runs
+struct test_batched_FMC {
+  constexpr static const char* name = "test model with batched factor update";
+  constexpr static bool batched_factor_update = true;
+  using factor_a = FactorContainer<test_factor, test_batched_FMC, 0>;
+  using factor_b = FactorContainer<test_factor, test_batched_FMC, 1>;
+  using message_ab = MessageContainer<test_message, 0, 1, message_passing_schedule::left, variableMessageNumber, variableMessageNumber, test_batched_FMC, 0>;
+  using message_ba = MessageContainer<test_message, 1, 0, message_passing_schedule::left, variableMessageNumber, variableMessageNumber, test_batched_FMC, 1>;
+  using FactorList = meta::list<factor_a, factor_b>;
+  using MessageList = meta::list<message_ab, message_ba>;
+  using problem_constructor = empty_problem_constructor;
+};
+
+// checkerboard grid of both factor types. Every factor sends messages to its right and lower neighbor.
+template<typename LP_TYPE>
+std::vector<FactorTypeAdapter*> build_checkerboard_model(LP_TYPE& lp, const std::size_t dim1, const std::size_t dim2)
+{
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<> dist(-1.0, 1.0);
+
+   std::vector<FactorTypeAdapter*> factors;
+   for(std::size_t x=0; x<dim1; ++x) {
+      for(std::size_t y=0; y<dim2; ++y) {
+         const double c0 = dist(gen);
+         const double c1 = dist(gen);
+         if((x+y) % 2 == 0) {
+            factors.push_back( lp.template add_factor<typename test_batched_FMC::factor_a>(c0, c1) );
+         } else {
+            factors.push_back( lp.template add_factor<typename test_batched_FMC::factor_b>(c0, c1) );
+         }
+      }
+   }
+
+   auto add_edge = [&](const std::size_t i, const std::size_t j) {
+      if(auto* a = dynamic_cast<typename test_batched_FMC::factor_a*>(factors[i])) {
+         lp.template add_message<typename test_batched_FMC::message_ab>(a, static_cast<typename test_batched_FMC::factor_b*>(factors[j]));
+      } else {
+         lp.template add_message<typename test_batched_FMC::message_ba>(static_cast<typename test_batched_FMC::factor_b*>(factors[i]), static_cast<typename test_batched_FMC::factor_a*>(factors[j]));
+      }
+      lp.add_factor_relation(factors[i], factors[j]);
+   };
+
+   for(std::size_t x=0; x<dim1; ++x) {
+      for(std::size_t y=0; y<dim2; ++y) {
+         if(x+1 < dim1) { add_edge(x*dim2 + y, (x+1)*dim2 + y); }
+         if(y+1 < dim2) { add_edge(x*dim2 + y, x*dim2 + y+1); }
+      }
+   }
+
+   return factors;
+}
+
+// pass through the virtual per factor update, as taken for FMCs without batched_factor_update
+template<typename LP_TYPE>
+void unbatched_pass(LP_TYPE& lp, const Direction d)
+{
+   auto& mpw = lp.get_message_passing_weight(lp.get_repam_mode());
+   auto [sorting, update_sorting] = lp.get_sorted_factors(d);
+   if(d == Direction::forward) {
+      lp.ComputePass(update_sorting.begin(), update_sorting.end(), mpw.omega_forward.begin(), mpw.receive_mask_forward.begin());
+   } else {
+      lp.ComputePass(update_sorting.begin(), update_sorting.end(), mpw.omega_backward.begin(), mpw.receive_mask_backward.begin());
+   }
+}
+
+int main()
+{
+   const std::size_t dim1 = 20;
+   const std::size_t dim2 = 30;
+
+   TCLAP::CmdLine cmd_batched("batched factor update");
+   LP<test_batched_FMC> lp_batched(cmd_batched);
+   std::vector<std::string> options_batched = {"batched"};
+   cmd_batched.parse(options_batched);
+
+   TCLAP::CmdLine cmd_unbatched("unbatched factor update");
+   LP<test_batched_FMC> lp_unbatched(cmd_unbatched);
+   std::vector<std::string> options_unbatched = {"unbatched"};
+   cmd_unbatched.parse(options_unbatched);
+
+   static_assert(factors_storage<test_batched_FMC>::batched_factor_update());
+   test(lp_batched.get_number_of_threads() == 1, "batched updates are used for single threaded passes");
+
+   auto factors_batched = build_checkerboard_model(lp_batched, dim1, dim2);
+   auto factors_unbatched = build_checkerboard_model(lp_unbatched, dim1, dim2);
+
+   for(auto* lp : {&lp_batched, &lp_unbatched}) {
+      lp->Begin();
+      lp->set_reparametrization(lp_reparametrization(lp_reparametrization_mode::Anisotropic, 0.0));
+   }
+
+   // runs must partition the update ordering into maximal blocks of one factor type
+   for(const Direction d : {Direction::forward, Direction::backward}) {
+      auto [sorting, update_sorting] = lp_batched.get_sorted_factors(d);
+      const auto& runs = lp_batched.get_update_runs(d);
+      test(runs.size() > 1);
+      std::size_t next = 0;
+      for(std::size_t r=0; r<runs.size(); ++r) {
+         test(runs[r].begin == next && runs[r].begin < runs[r].end);
+         if(r > 0) { test(runs[r].type_index != runs[r-1].type_index, "runs must be maximal"); }
+         for(std::size_t i=runs[r].begin; i<runs[r].end; ++i) {
+            test(lp_batched.get_factor_type_index(lp_batched.get_factor_index(update_sorting[i])) == runs[r].type_index);
+         }
+         next = runs[r].end;
+      }
+      test(next == update_sorting.size());
+   }
+
+   for(std::size_t iter=0; iter<10; ++iter) {
+      lp_batched.ComputePass();
+      unbatched_pass(lp_unbatched, Direction::forward);
+      unbatched_pass(lp_unbatched, Direction::backward);
+
+      test(lp_batched.LowerBound() == lp_unbatched.LowerBound(), "batched pass must give the same lower bound as unbatched one");
+   }
+
+   for(std::size_t i=0; i<factors_batched.size(); ++i) {
+      test(factors_batched[i]->LowerBound() == factors_unbatched[i]->LowerBound());
+   }
+}
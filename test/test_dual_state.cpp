@@ -0,0 +1,51 @@
+#include "test.h"
+#include "LP.h"
+#include "test_model.hxx"
+#include <random>
+#include <cstdio>
+
+using namespace LPMP;
+
+int main()
+{
+   TCLAP::CmdLine cmd("dual state");
+   LP<test_FMC> lp(cmd);
+   std::vector<std::string> options = {"dual_state"};
+   cmd.parse(options);
+
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<> dist(-1.0, 1.0);
+   const std::size_t n = 100;
+   std::vector<typename test_FMC::factor*> factors;
+   for(std::size_t i=0; i<n; ++i) {
+      factors.push_back( lp.add_factor<typename test_FMC::factor>(dist(gen), dist(gen)) );
+   }
+   for(std::size_t i=0; i+1<n; ++i) {
+      lp.add_message<typename test_FMC::message>(factors[i], factors[i+1]);
+      lp.add_factor_relation(factors[i], factors[i+1]);
+   }
+
+   lp.Begin();
+   lp.set_reparametrization(lp_reparametrization(lp_reparametrization_mode::Anisotropic, 0.0));
+
+   const double initial_lb = lp.LowerBound();
+   const auto& state = lp.save_dual_state();
+   test(state.size() == lp.dual_state_size_in_bytes());
+   test(state.size() == n*2*sizeof(REAL));
+   const std::string filename = "test_dual_state.bin";
+   lp.save_dual_state_to_file(filename);
+
+   lp.ComputePass();
+   const double lb_after_pass = lp.LowerBound();
+   test(lb_after_pass > initial_lb, "message passing should improve lower bound");
+
+   lp.load_dual_state();
+   test(lp.LowerBound() == initial_lb, "restoring dual state must give back lower bound");
+
+   lp.ComputePass();
+   test(lp.LowerBound() == lb_after_pass);
+
+   lp.load_dual_state_from_file(filename);
+   test(lp.LowerBound() == initial_lb, "restoring dual state from file must give back lower bound");
+   std::remove(filename.c_str());
+}
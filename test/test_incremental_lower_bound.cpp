@@ -0,0 +1,68 @@
+#include "test.h"
+#include "solver.hxx"
+#include "visitors/standard_visitor.hxx"
+#include "test_model.hxx"
+#include <cmath>
+
+using namespace LPMP;
+
+// shifts the cost of a factor before every iteration, outside of message passing
+template<typename FMC>
+struct shifting_problem_constructor {
+   template<typename SOLVER>
+   shifting_problem_constructor(SOLVER& s) {}
+
+   void pre_iterate()
+   {
+      assert(shifted_factor != nullptr);
+      shifted_factor->get_factor()->cost[0] += 1.0;
+      shifted_factor->get_factor()->cost[1] += 1.0;
+   }
+
+   FactorContainer<test_factor, FMC, 0>* shifted_factor = nullptr;
+};
+
+struct shifting_test_FMC {
+  constexpr static const char* name = "test model with reparametrizing problem constructor";
+  using factor = FactorContainer<test_factor, shifting_test_FMC, 0>;
+  using message = MessageContainer<test_message, 0, 0, message_passing_schedule::left, variableMessageNumber, variableMessageNumber, shifting_test_FMC, 0>;
+  using FactorList = meta::list<factor>;
+  using MessageList = meta::list<message>;
+  using problem_constructor = shifting_problem_constructor<shifting_test_FMC>;
+};
+
+using shifting_solver = Solver<LP<shifting_test_FMC>, StandardVisitor>;
+
+// chain of factors and one factor without messages, which message passing never updates
+void build_model(shifting_solver& s)
+{
+   auto& lp = s.GetLP();
+   std::vector<typename shifting_test_FMC::factor*> factors;
+   for(std::size_t i=0; i<10; ++i) {
+      factors.push_back( lp.add_factor<typename shifting_test_FMC::factor>(double(i%3), double((i+1)%2)) );
+   }
+   for(std::size_t i=0; i+1<factors.size(); ++i) {
+      lp.add_message<typename shifting_test_FMC::message>(factors[i], factors[i+1]);
+      lp.add_factor_relation(factors[i], factors[i+1]);
+   }
+   s.GetProblemConstructor().shifted_factor = lp.add_factor<typename shifting_test_FMC::factor>(0.0, 1.0);
+}
+
+int main()
+{
+   shifting_solver s_incremental({"incremental", "--maxIter", "20", "--incrementalLowerBound"});
+   shifting_solver s_full({"full", "--maxIter", "20"});
+   test(s_incremental.GetLP().incremental_lower_bound());
+
+   build_model(s_incremental);
+   build_model(s_full);
+   s_incremental.Solve();
+   s_full.Solve();
+
+   double lb = s_incremental.GetLP().get_constant();
+   for(std::size_t i=0; i<s_incremental.GetLP().number_of_factors(); ++i) {
+      lb += s_incremental.GetLP().get_factor(i)->LowerBound();
+   }
+   test(std::abs(s_incremental.lower_bound() - lb) <= 1e-8, "incremental lower bound must include changes made by problem constructor");
+   test(std::abs(s_incremental.lower_bound() - s_full.lower_bound()) <= 1e-8);
+}
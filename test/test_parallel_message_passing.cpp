@@ -0,0 +1,122 @@
+#include "test.h"
+#include "LP.h"
+#include "test_model.hxx"
+#include <random>
+#include <cmath>
+
+using namespace LPMP;
+
+// build grid of test factors. Every factor sends messages to its right and lower neighbor.
+template<typename LP_TYPE>
+std::vector<typename test_FMC::factor*> build_grid_model(LP_TYPE& lp, const std::size_t dim1, const std::size_t dim2)
+{
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<> dist(-1.0, 1.0);
+
+   std::vector<typename test_FMC::factor*> factors;
+   for(std::size_t i=0; i<dim1*dim2; ++i) {
+      factors.push_back( lp.template add_factor<typename test_FMC::factor>(dist(gen), dist(gen)) );
+   }
+
+   auto add_edge = [&](const std::size_t i, const std::size_t j) {
+      lp.template add_message<typename test_FMC::message>(factors[i], factors[j]);
+      lp.add_factor_relation(factors[i], factors[j]);
+   };
+
+   for(std::size_t x=0; x<dim1; ++x) {
+      for(std::size_t y=0; y<dim2; ++y) {
+         if(x+1 < dim1) { add_edge(x*dim2 + y, (x+1)*dim2 + y); }
+         if(y+1 < dim2) { add_edge(x*dim2 + y, x*dim2 + y+1); }
+      }
+   }
+
+   return factors;
+}
+
+int main()
+{
+   const std::size_t dim1 = 30;
+   const std::size_t dim2 = 40;
+
+   TCLAP::CmdLine cmd_serial("serial message passing");
+   LP<test_FMC> lp_serial(cmd_serial);
+   std::vector<std::string> options_serial = {"serial"};
+   cmd_serial.parse(options_serial);
+
+   TCLAP::CmdLine cmd_parallel("parallel message passing");
+   LP<test_FMC> lp_parallel(cmd_parallel);
+   std::vector<std::string> options_parallel = {"parallel", "--numLpThreads", "4"};
+   cmd_parallel.parse(options_parallel);
+   test(lp_parallel.get_number_of_threads() == 4);
+
+   TCLAP::CmdLine cmd_incremental("parallel message passing with incremental lower bound");
+   LP<test_FMC> lp_incremental(cmd_incremental);
+   std::vector<std::string> options_incremental = {"incremental", "--numLpThreads", "4", "--incrementalLowerBound"};
+   cmd_incremental.parse(options_incremental);
+   test(lp_incremental.incremental_lower_bound());
+
+   auto factors_serial = build_grid_model(lp_serial, dim1, dim2);
+   auto factors_parallel = build_grid_model(lp_parallel, dim1, dim2);
+   build_grid_model(lp_incremental, dim1, dim2);
+
+   for(auto* lp : {&lp_serial, &lp_parallel, &lp_incremental}) {
+      lp->Begin();
+      lp->set_reparametrization(lp_reparametrization(lp_reparametrization_mode::Anisotropic, 0.0));
+   }
+
+   // conflicting factors must end up in different levels
+   {
+      auto [forward_sorting, forward_update_sorting] = lp_parallel.get_sorted_factors(Direction::forward);
+      const auto& levels = lp_parallel.get_parallel_update_levels(Direction::forward);
+      std::size_t no_updates = 0;
+      for(std::size_t l=0; l<levels.size(); ++l) {
+         no_updates += levels[l].size();
+         std::vector<char> touched(lp_parallel.number_of_factors(), 0);
+         for(std::size_t j=0; j<levels[l].size(); ++j) {
+            auto* f = forward_update_sorting[levels[l][j]];
+            auto footprint = f->get_adjacent_factors();
+            footprint.push_back(f);
+            for(auto* a : footprint) {
+               const auto a_idx = lp_parallel.get_factor_index(a);
+               test(touched[a_idx] == 0, "factors in the same level must not conflict");
+               touched[a_idx] = 1;
+            }
+         }
+      }
+      test(no_updates == forward_update_sorting.size());
+      test(levels.size() < forward_update_sorting.size());
+   }
+
+   for(std::size_t iter=0; iter<10; ++iter) {
+      lp_serial.ComputePass();
+      lp_parallel.ComputePass();
+
+      test(lp_serial.LowerBound() == lp_parallel.LowerBound(), "parallel pass must give the same lower bound as sequential one");
+
+      // forward pass only touches part of the factors before the bound is evaluated
+      lp_incremental.ComputeForwardPass();
+      lp_incremental.LowerBound();
+      lp_incremental.ComputeBackwardPass();
+      test(lp_serial.LowerBound() == lp_incremental.LowerBound(), "incremental lower bound must equal full reevaluation");
+   }
+
+   for(std::size_t i=0; i<factors_serial.size(); ++i) {
+      test(factors_serial[i]->LowerBound() == factors_parallel[i]->LowerBound());
+   }
+
+   // parallel lower bound must equal the serial sum over factors plus the concurrently accumulated constant
+   {
+      const std::size_t no_additions = 1000;
+#pragma omp parallel for num_threads(4)
+      for(std::size_t i=0; i<no_additions; ++i) {
+         lp_parallel.add_to_constant(0.25);
+      }
+      test(lp_parallel.get_constant() == 0.25*no_additions, "no constant addition may be lost");
+
+      double lb = lp_parallel.get_constant();
+      for(auto* f : factors_parallel) {
+         lb += f->LowerBound();
+      }
+      test(std::abs(lp_parallel.LowerBound() - lb) <= 1e-8*std::max(1.0, std::abs(lb)), "parallel lower bound must equal serial sum over factors plus constant");
+   }
+}
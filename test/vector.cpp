@@ -30,6 +30,45 @@ void test_vector_minima(const std::size_t n, std::random_device& rd)
     test(v[1] == two_min[1]);
 }
 
+// simd kernels must pick their lane type from the stored type, independently of REAL
+template<typename T>
+void test_matrix_minima()
+{
+  { // matrix minima
+    matrix<T> m(5,6);
+    m(0,0) = -2.0; m(0,1) = +0.0; m(0,2) = +2.0; m(0,3) = -0.5; m(0,4) = +0.0; m(0,5) = +0.5;
+    m(1,0) = -1.0; m(1,1) = +0.0; m(1,2) = +1.0; m(1,3) = -0.5; m(1,4) = +0.0; m(1,5) = +0.5;
+    m(2,0) = -0.0; m(2,1) = -4.0; m(2,2) = +0.5; m(2,3) = -0.5; m(2,4) = +0.0; m(2,5) = +0.5;
+    m(3,0) = +1.0; m(3,1) = +0.0; m(3,2) = -1.0; m(3,3) = -0.5; m(3,4) = +0.0; m(3,5) = +0.5;
+    m(4,0) = +2.0; m(4,1) = +0.0; m(4,2) = -2.0; m(4,3) = -0.5; m(4,4) = +0.0; m(4,5) = +0.5;
+
+    std::cout << m;
+
+    { // matrix columnwise minimum
+      auto min_col = m.min2(); 
+      test(min_col.size() == 6);
+
+      test(min_col[0] == -2.0);
+      test(min_col[1] == -4.0);
+      test(min_col[2] == -2.0); 
+      test(min_col[3] == -0.5); 
+      test(min_col[4] == +0.0); 
+      test(min_col[5] == +0.5); 
+    }
+
+    { // matrix rowwise minimum
+      auto min_row = m.min1();
+      test(min_row.size() == 5);
+
+      test(min_row[0] == -2.0);
+      test(min_row[1] == -1.0);
+      test(min_row[2] == -4.0);
+      test(min_row[3] == -1.0);
+      test(min_row[4] == -2.0); 
+    }
+  }
+}
+
 int main() {
 
   { // vector minimum
@@ -58,41 +97,45 @@ int main() {
     for(std::size_t n=2; n<100; ++n) {
         test_vector_minima<LPMP::vector<double>>(n, rd);
         test_vector_minima<min_vector<double>>(n, rd);
-    }
-  }
 
-  { // matrix minima
-    matrix<REAL> m(5,6);
-    m(0,0) = -2.0; m(0,1) = +0.0; m(0,2) = +2.0; m(0,3) = -0.5; m(0,4) = +0.0; m(0,5) = +0.5;
-    m(1,0) = -1.0; m(1,1) = +0.0; m(1,2) = +1.0; m(1,3) = -0.5; m(1,4) = +0.0; m(1,5) = +0.5;
-    m(2,0) = -0.0; m(2,1) = -4.0; m(2,2) = +0.5; m(2,3) = -0.5; m(2,4) = +0.0; m(2,5) = +0.5;
-    m(3,0) = +1.0; m(3,1) = +0.0; m(3,2) = -1.0; m(3,3) = -0.5; m(3,4) = +0.0; m(3,5) = +0.5;
-    m(4,0) = +2.0; m(4,1) = +0.0; m(4,2) = -2.0; m(4,3) = -0.5; m(4,4) = +0.0; m(4,5) = +0.5;
-
-    std::cout << m;
-
-    { // matrix columnwise minimum
-      auto min_col = m.min2(); 
-      test(min_col.size() == 6);
-
-      test(min_col[0] == -2.0);
-      test(min_col[1] == -4.0);
-      test(min_col[2] == -2.0); 
-      test(min_col[3] == -0.5); 
-      test(min_col[4] == +0.0); 
-      test(min_col[5] == +0.5); 
+        LPMP::vector<float> f(n);
+        std::uniform_real_distribution<float> float_dist(-1.0, 1.0);
+        std::mt19937 gen{rd()};
+        for(std::size_t i=0; i<n; ++i) { f[i] = float_dist(gen); }
+        test(f.min() == *std::min_element(f.begin(), f.end()));
     }
+  }
 
-    { // matrix rowwise minimum
-      auto min_row = m.min1();
-      test(min_row.size() == 5);
-
-      test(min_row[0] == -2.0);
-      test(min_row[1] == -1.0);
-      test(min_row[2] == -4.0);
-      test(min_row[3] == -1.0);
-      test(min_row[4] == -2.0); 
+  test_matrix_minima<float>();
+  test_matrix_minima<double>();
+
+  { // arena allocation
+    monotonic_arena arena(1024);
+    {
+      monotonic_arena::scope arena_scope(&arena);
+      LPMP::vector<REAL> v(5, 1.0);
+      matrix<REAL> m(3, 7, 2.0);
+      test((std::size_t(v.begin()) % 32) == 0);
+      test(v.min() == 1.0);
+      test(m(2,6) == 2.0);
+      test(arena.mem_used() > 0);
+
+      // vector copied from arena memory outside of scope and vice versa
+      LPMP::vector<REAL> big(1000, -1.0);
+      test(arena.no_slabs() >= 2);
+      {
+        monotonic_arena::scope heap_scope(nullptr);
+        LPMP::vector<REAL> heap_copy(v);
+        test(heap_copy.min() == 1.0);
+        LPMP::vector<REAL> w(3);
+        w = big;
+        test(w.size() == 1000 && w.min() == -1.0);
+      }
     }
-  } 
+    test(monotonic_arena::current() == nullptr);
+    const std::size_t used = arena.mem_used();
+    LPMP::vector<REAL> heap_vector(10, 0.0);
+    test(arena.mem_used() == used);
+  }
 }
 